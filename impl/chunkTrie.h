@@ -0,0 +1,195 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Implementation of the ChunkTrie class.
+ *
+ * ChunkTrie is a persistent trie that maps dense addresses to immutable
+ * chunks. Each node has 64 children, so address is split in groups of 6 bits
+ * from the root down, and the last group selects the chunk in the lowest
+ * node. Trie grows by one level when address does not fit in its levels.
+ *
+ * Trie is never changed in place. assign() copies only nodes on the paths to
+ * assigned chunks and shares all other nodes and chunks with the trie it was
+ * copied from, so copy of trie with a few chunks replaced costs number of
+ * replaced chunks times depth of trie, and not size of trie. Copies of trie
+ * are cheap, they share the root.
+ *
+ * @tparam Chunk type of chunks stored in trie
+ */
+template <typename Chunk> class ChunkTrie {
+public:
+  /**
+   * Pair < address, chunk >, given to assign()
+   */
+  using Entry = std::pair<uint32_t, std::shared_ptr<const Chunk>>;
+
+private:
+  /**
+   * Node of trie, children are nodes or, in the lowest level, chunks
+   */
+  struct Node {
+    std::array<std::shared_ptr<const void>, 64> children;
+  };
+
+  /**
+   * Root node, nullptr if trie is empty
+   */
+  std::shared_ptr<const void> root;
+
+  /**
+   * Number of levels of nodes, addresses below 64^levels fit in trie
+   */
+  unsigned levels = 0;
+
+  /**
+   * Shift of address in the root node, 6 * (levels - 1)
+   */
+  unsigned rootShift = 0;
+
+  /**
+   * Returns child of node in slot selected by address at shift
+   */
+  static const void *child(const void *node, uint32_t address,
+                           unsigned shift) {
+    return static_cast<const Node *>(node)
+        ->children[(address >> shift) & 63]
+        .get();
+  }
+
+  /**
+   * Returns copy of node with chunks of entries assigned, entries are sorted
+   * by address and are all under node
+   */
+  static std::shared_ptr<const void>
+  update(const std::shared_ptr<const void> &node, unsigned shift,
+         const Entry *begin, const Entry *end);
+
+  /**
+   * Calls visit for each chunk under node, in order of addresses
+   */
+  template <typename Visit>
+  static void visitNode(const void *node, unsigned shift, uint32_t base,
+                        Visit &visit);
+
+public:
+  /**
+   * Returns chunk at address, nullptr if no chunk was assigned to it
+   *
+   * @param address address of chunk
+   */
+  const Chunk *find(uint32_t address) const {
+    const void *node = root.get();
+    if (node == nullptr || (levels < 6 && (address >> (6 * levels)) != 0))
+      return nullptr;
+    for (unsigned shift = rootShift; shift != 0 && node != nullptr;
+         shift -= 6) {
+      node = child(node, address, shift);
+    }
+    if (node == nullptr)
+      return nullptr;
+    return static_cast<const Chunk *>(child(node, address, 0));
+  }
+
+  /**
+   * Returns chunk at address, chunk must be assigned to it. Lookup does not
+   * check for missing nodes, so it is used for dense addresses
+   *
+   * @param address address of chunk
+   */
+  const Chunk &at(uint32_t address) const {
+    const void *node = root.get();
+    for (unsigned shift = rootShift; shift != 0; shift -= 6) {
+      node = child(node, address, shift);
+    }
+    return *static_cast<const Chunk *>(child(node, address, 0));
+  }
+
+  /**
+   * Assigns chunks to their addresses, copying nodes on their paths
+   *
+   * @param entries pairs < address, chunk >, sorted by address, each address
+   * once
+   */
+  void assign(const std::vector<Entry> &entries);
+
+  /**
+   * Calls visit(address, chunk) for each chunk of trie, in order of addresses
+   *
+   * @param visit function called with address and const reference to chunk
+   */
+  template <typename Visit> void forEach(Visit visit) const {
+    if (root != nullptr)
+      visitNode(root.get(), rootShift, 0, visit);
+  }
+};
+
+template <typename Chunk>
+std::shared_ptr<const void>
+ChunkTrie<Chunk>::update(const std::shared_ptr<const void> &node,
+                         unsigned shift, const Entry *begin,
+                         const Entry *end) {
+  auto copy = node == nullptr
+                  ? std::make_shared<Node>()
+                  : std::make_shared<Node>(*static_cast<const Node *>(
+                        node.get()));
+  while (begin != end) {
+    unsigned slot = (begin->first >> shift) & 63;
+    const Entry *last = begin;
+    while (last != end && ((last->first >> shift) & 63) == slot) {
+      ++last;
+    }
+    if (shift == 0)
+      copy->children[slot] = begin->second;
+    else
+      copy->children[slot] = update(copy->children[slot], shift - 6, begin,
+                                    last);
+    begin = last;
+  }
+  return copy;
+}
+
+template <typename Chunk>
+void ChunkTrie<Chunk>::assign(const std::vector<Entry> &entries) {
+  if (entries.empty())
+    return;
+  // trie grows from the top, old root is the first child of new root
+  uint32_t maxAddress = entries.back().first;
+  while (levels == 0 || (levels < 6 && (maxAddress >> (6 * levels)) != 0)) {
+    if (root != nullptr) {
+      auto grown = std::make_shared<Node>();
+      grown->children[0] = std::move(root);
+      root = std::move(grown);
+    }
+    ++levels;
+  }
+  rootShift = 6 * (levels - 1);
+  root = update(root, rootShift, entries.data(),
+                entries.data() + entries.size());
+}
+
+template <typename Chunk>
+template <typename Visit>
+void ChunkTrie<Chunk>::visitNode(const void *node, unsigned shift,
+                                 uint32_t base, Visit &visit) {
+  const auto &children = static_cast<const Node *>(node)->children;
+  for (uint32_t slot = 0; slot < 64; ++slot) {
+    const void *next = children[slot].get();
+    if (next == nullptr)
+      continue;
+    uint32_t address = base | slot << shift;
+    if (shift == 0)
+      visit(address, *static_cast<const Chunk *>(next));
+    else
+      visitNode(next, shift - 6, address, visit);
+  }
+}
+
+} // namespace graph
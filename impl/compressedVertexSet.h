@@ -0,0 +1,321 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Implementation of the CompressedVertexSet class.
+ *
+ * CompressedVertexSet is a set of 32 bit vertex ids, compressed in the same way
+ * as roaring bitmaps. Ids are split in containers by their high 16 bits. A
+ * container with at most 4096 ids keeps low 16 bits of ids in sorted array,
+ * larger container keeps them as bitmap of 65536 bits. Sparse sets then take
+ * 2 bytes per id and dense sets 1 bit per id, and intersection of two sets is
+ * done container by container, as merge of arrays, lookups of array in bitmap
+ * or AND of bitmaps.
+ */
+class CompressedVertexSet {
+private:
+  /**
+   * Container of ids with the same high 16 bits
+   */
+  struct Container {
+    uint16_t high = 0;            ///< High 16 bits of all ids in container
+    uint32_t cardinality = 0;     ///< Number of ids in container
+    std::vector<uint16_t> array;  ///< Sorted low bits, if container is array
+    std::vector<uint64_t> bitmap; ///< Bitmap of low bits, if container is dense
+
+    bool isBitmap() const { return !bitmap.empty(); }
+    bool contains(uint16_t low) const;
+    bool add(uint16_t low);
+    bool remove(uint16_t low);
+  };
+
+  /**
+   * Containers, sorted by high bits
+   */
+  std::vector<Container> containers;
+
+  /// Largest number of ids kept in array container
+  static constexpr uint32_t arrayLimit = 4096;
+
+  /// Number of 64 bit words in bitmap container
+  static constexpr uint32_t bitmapWords = 1024;
+
+  /**
+   * Returns iterator to container with high bits, or to the place where it
+   * should be inserted
+   */
+  std::vector<Container>::iterator findContainer(uint16_t high);
+  std::vector<Container>::const_iterator findContainer(uint16_t high) const;
+
+  /**
+   * Intersects two containers with same high bits
+   */
+  static Container intersect(const Container &a, const Container &b);
+
+public:
+  /**
+   * Adds id to set, returns true if id was not in set
+   *
+   * @param id vertex id
+   */
+  bool add(uint32_t id);
+
+  /**
+   * Removes id from set, returns true if id was in set
+   *
+   * @param id vertex id
+   */
+  bool remove(uint32_t id);
+
+  /**
+   * Returns true if set contains id
+   *
+   * @param id vertex id
+   */
+  bool contains(uint32_t id) const;
+
+  /**
+   * Returns number of ids in set
+   */
+  size_t size() const;
+
+  /**
+   * Returns true if set has no ids
+   */
+  bool empty() const { return containers.empty(); }
+
+  /**
+   * Returns set of ids that are in both sets
+   *
+   * @param a first set
+   * @param b second set
+   */
+  static CompressedVertexSet intersect(const CompressedVertexSet &a,
+                                       const CompressedVertexSet &b);
+
+  /**
+   * Calls function for every id of set, in ascending order
+   *
+   * @param function called with uint32_t id
+   */
+  template <typename Function> void forEach(Function function) const;
+
+  /**
+   * Sets bits of all ids of set in dense bitmap, that has to have at least
+   * (largest id + 64) / 64 words
+   *
+   * @param words dense bitmap, bit i of words[j] is id j * 64 + i
+   */
+  void setBits(std::vector<uint64_t> &words) const;
+};
+
+inline bool CompressedVertexSet::Container::contains(uint16_t low) const {
+  if (isBitmap())
+    return (bitmap[low >> 6] >> (low & 63)) & 1;
+  return std::binary_search(array.begin(), array.end(), low);
+}
+
+inline bool CompressedVertexSet::Container::add(uint16_t low) {
+  if (isBitmap()) {
+    uint64_t bit = uint64_t(1) << (low & 63);
+    if (bitmap[low >> 6] & bit)
+      return false;
+    bitmap[low >> 6] |= bit;
+    ++cardinality;
+    return true;
+  }
+  auto it = std::lower_bound(array.begin(), array.end(), low);
+  if (it != array.end() && *it == low)
+    return false;
+  array.insert(it, low);
+  ++cardinality;
+  // array container that got too large is converted to bitmap
+  if (cardinality > arrayLimit) {
+    bitmap.assign(bitmapWords, 0);
+    for (auto value : array) {
+      bitmap[value >> 6] |= uint64_t(1) << (value & 63);
+    }
+    std::vector<uint16_t>().swap(array);
+  }
+  return true;
+}
+
+inline bool CompressedVertexSet::Container::remove(uint16_t low) {
+  if (isBitmap()) {
+    uint64_t bit = uint64_t(1) << (low & 63);
+    if (!(bitmap[low >> 6] & bit))
+      return false;
+    bitmap[low >> 6] &= ~bit;
+    --cardinality;
+    // bitmap container that got small enough is converted back to array
+    if (cardinality <= arrayLimit / 2) {
+      for (uint32_t word = 0; word < bitmapWords; ++word) {
+        for (uint64_t bits = bitmap[word]; bits != 0; bits &= bits - 1) {
+          array.push_back(
+              static_cast<uint16_t>(word * 64 + __builtin_ctzll(bits)));
+        }
+      }
+      std::vector<uint64_t>().swap(bitmap);
+    }
+    return true;
+  }
+  auto it = std::lower_bound(array.begin(), array.end(), low);
+  if (it == array.end() || *it != low)
+    return false;
+  array.erase(it);
+  --cardinality;
+  return true;
+}
+
+inline std::vector<CompressedVertexSet::Container>::iterator
+CompressedVertexSet::findContainer(uint16_t high) {
+  return std::lower_bound(
+      containers.begin(), containers.end(), high,
+      [](const Container &c, uint16_t value) { return c.high < value; });
+}
+
+inline std::vector<CompressedVertexSet::Container>::const_iterator
+CompressedVertexSet::findContainer(uint16_t high) const {
+  return std::lower_bound(
+      containers.begin(), containers.end(), high,
+      [](const Container &c, uint16_t value) { return c.high < value; });
+}
+
+inline bool CompressedVertexSet::add(uint32_t id) {
+  uint16_t high = static_cast<uint16_t>(id >> 16);
+  auto it = findContainer(high);
+  if (it == containers.end() || it->high != high) {
+    it = containers.insert(it, Container());
+    it->high = high;
+  }
+  return it->add(static_cast<uint16_t>(id));
+}
+
+inline bool CompressedVertexSet::remove(uint32_t id) {
+  uint16_t high = static_cast<uint16_t>(id >> 16);
+  auto it = findContainer(high);
+  if (it == containers.end() || it->high != high ||
+      !it->remove(static_cast<uint16_t>(id)))
+    return false;
+  if (it->cardinality == 0)
+    containers.erase(it);
+  return true;
+}
+
+inline bool CompressedVertexSet::contains(uint32_t id) const {
+  uint16_t high = static_cast<uint16_t>(id >> 16);
+  auto it = findContainer(high);
+  return it != containers.end() && it->high == high &&
+         it->contains(static_cast<uint16_t>(id));
+}
+
+inline size_t CompressedVertexSet::size() const {
+  size_t result = 0;
+  for (const auto &container : containers) {
+    result += container.cardinality;
+  }
+  return result;
+}
+
+inline CompressedVertexSet::Container
+CompressedVertexSet::intersect(const Container &a, const Container &b) {
+  Container result;
+  result.high = a.high;
+  if (a.isBitmap() && b.isBitmap()) {
+    result.bitmap.resize(bitmapWords);
+    for (uint32_t word = 0; word < bitmapWords; ++word) {
+      result.bitmap[word] = a.bitmap[word] & b.bitmap[word];
+      result.cardinality += __builtin_popcountll(result.bitmap[word]);
+    }
+    if (result.cardinality <= arrayLimit) {
+      Container array;
+      array.high = a.high;
+      array.cardinality = result.cardinality;
+      for (uint32_t word = 0; word < bitmapWords; ++word) {
+        for (uint64_t bits = result.bitmap[word]; bits != 0;
+             bits &= bits - 1) {
+          array.array.push_back(
+              static_cast<uint16_t>(word * 64 + __builtin_ctzll(bits)));
+        }
+      }
+      return array;
+    }
+  } else if (a.isBitmap() || b.isBitmap()) {
+    const Container &array = a.isBitmap() ? b : a;
+    const Container &bitmap = a.isBitmap() ? a : b;
+    for (auto low : array.array) {
+      if (bitmap.contains(low))
+        result.array.push_back(low);
+    }
+    result.cardinality = static_cast<uint32_t>(result.array.size());
+  } else {
+    std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(),
+                          b.array.end(), std::back_inserter(result.array));
+    result.cardinality = static_cast<uint32_t>(result.array.size());
+  }
+  return result;
+}
+
+inline CompressedVertexSet
+CompressedVertexSet::intersect(const CompressedVertexSet &a,
+                               const CompressedVertexSet &b) {
+  CompressedVertexSet result;
+  auto itA = a.containers.begin();
+  auto itB = b.containers.begin();
+  while (itA != a.containers.end() && itB != b.containers.end()) {
+    if (itA->high < itB->high) {
+      ++itA;
+    } else if (itB->high < itA->high) {
+      ++itB;
+    } else {
+      Container container = intersect(*itA, *itB);
+      if (container.cardinality > 0)
+        result.containers.push_back(std::move(container));
+      ++itA;
+      ++itB;
+    }
+  }
+  return result;
+}
+
+template <typename Function>
+void CompressedVertexSet::forEach(Function function) const {
+  for (const auto &container : containers) {
+    uint32_t base = uint32_t(container.high) << 16;
+    if (container.isBitmap()) {
+      for (uint32_t word = 0; word < bitmapWords; ++word) {
+        for (uint64_t bits = container.bitmap[word]; bits != 0;
+             bits &= bits - 1) {
+          function(base + word * 64 + __builtin_ctzll(bits));
+        }
+      }
+    } else {
+      for (auto low : container.array) {
+        function(base + low);
+      }
+    }
+  }
+}
+
+inline void CompressedVertexSet::setBits(std::vector<uint64_t> &words) const {
+  for (const auto &container : containers) {
+    size_t base = size_t(container.high) << 10;
+    if (container.isBitmap()) {
+      size_t count = std::min<size_t>(bitmapWords, words.size() - base);
+      for (size_t word = 0; word < count; ++word) {
+        words[base + word] |= container.bitmap[word];
+      }
+    } else {
+      for (auto low : container.array) {
+        words[base + (low >> 6)] |= uint64_t(1) << (low & 63);
+      }
+    }
+  }
+}
+
+} // namespace graph
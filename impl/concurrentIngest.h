@@ -0,0 +1,211 @@
+#pragma once
+
+#include "flatHashMap.h"
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Implementation of the ConcurrentIngest class.
+ *
+ * ConcurrentIngest collects vertices, edges and labels that many producer
+ * threads add to graph at the same time. Keys are split in shards by hash,
+ * each shard has its own mutex, map of keys of its new vertices and vectors
+ * of new vertices, of edges with start vertex in shard and of labels, so
+ * threads that add different keys rarely wait for each other. Graph is not
+ * changed while vertices are collected, keys that graph already has are only
+ * looked up, and collected vertices and edges are then inserted in graph with
+ * its bulk loaders.
+ *
+ * Vertex is added once, later additions of the same key return false, as
+ * with graph. Edge and label are added only if their vertices are in graph or
+ * were already added.
+ *
+ * @tparam V type of data stored in graph vertices
+ */
+template <typename V> class ConcurrentIngest {
+public:
+  /// Number of bits of hash of key that select its shard
+  static constexpr unsigned shardBits = 6;
+
+  /// Number of shards
+  static constexpr size_t shardCount = size_t(1) << shardBits;
+
+private:
+  /**
+   * Vertices, edges and labels of keys of one shard, aligned to cache line so
+   * that mutexes of shards do not share lines
+   */
+  struct alignas(64) Shard {
+    std::mutex mutex;                             ///< guards shard
+    FlatHashMap<int, uint32_t> keys;              ///< keys of new vertices
+    std::vector<std::pair<int, V>> vertices;      ///< new vertices
+    std::vector<std::pair<int, int>> edges;       ///< edges of start keys
+    std::vector<std::pair<int, std::string>> labels; ///< labels of keys
+  };
+
+  /**
+   * Shards of keys
+   */
+  std::vector<Shard> shards;
+
+  /**
+   * Keys of vertices that graph already has, not changed while vertices are
+   * collected
+   */
+  const FlatHashMap<int, uint32_t> &existing;
+
+  /**
+   * Returns shard of key. FlatHashMap of shard takes slot from the highest
+   * bits of the same hash, so shard is taken from lower bits, otherwise all
+   * keys of shard would fall in one part of its slots
+   */
+  Shard &shardOf(int key) {
+    uint64_t hash = static_cast<uint64_t>(static_cast<uint32_t>(key));
+    return shards[((hash * 0x9E3779B97F4A7C15ull) >> 32) & (shardCount - 1)];
+  }
+
+  /**
+   * Returns true if key is in graph or was added, shard of key is locked by
+   * caller
+   */
+  bool containsLocked(Shard &shard, int key) const {
+    return existing.contains(key) || shard.keys.contains(key);
+  }
+
+public:
+  /**
+   * Constructor of ConcurrentIngest
+   *
+   * @param existing keys of vertices that graph already has
+   */
+  explicit ConcurrentIngest(const FlatHashMap<int, uint32_t> &existing)
+      : shards(shardCount), existing(existing) {}
+
+  /**
+   * Adds vertex, if graph does not have key and it was not added before
+   *
+   * @param key id of Vertex
+   * @param info Vertex info
+   *
+   * @return true if vertex is added
+   */
+  bool addVertex(int key, const V &info);
+
+  /**
+   * Adds edge, if both vertices are in graph or were added
+   *
+   * @param start id of source Vertex
+   * @param stop id of destination Vertex
+   *
+   * @return true if edge is added
+   */
+  bool addEdge(int start, int stop);
+
+  /**
+   * Adds labels to vertex, if it is in graph or was added
+   *
+   * @param key id of Vertex
+   * @param label Vertex label
+   *
+   * @return true if labels are added
+   */
+  bool addLabel(int key, const std::vector<std::string> &label);
+
+  /**
+   * Returns true if vertex is in graph or was added
+   *
+   * @param key id of Vertex
+   */
+  bool contains(int key);
+
+  /**
+   * Moves added vertices, edges and labels out of ingest, in order of shards.
+   * Called when no thread adds anything
+   *
+   * @param vertices added vertices
+   * @param edges added edges
+   * @param labels added labels
+   */
+  void take(std::vector<std::pair<int, V>> &vertices,
+            std::vector<std::pair<int, int>> &edges,
+            std::vector<std::pair<int, std::string>> &labels);
+};
+
+template <typename V>
+bool ConcurrentIngest<V>::addVertex(int key, const V &info) {
+  Shard &shard = shardOf(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  if (existing.contains(key) ||
+      !shard.keys.insert(key, static_cast<uint32_t>(shard.vertices.size())))
+    return false;
+  shard.vertices.emplace_back(key, info);
+  return true;
+}
+
+template <typename V> bool ConcurrentIngest<V>::addEdge(int start, int stop) {
+  // vertices are never removed while ingest runs, so stop vertex that is found
+  // is still there when edge is added. Shards are locked one at a time, so
+  // threads never hold two shards and can not deadlock
+  if (!contains(stop))
+    return false;
+  Shard &shard = shardOf(start);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  if (!containsLocked(shard, start))
+    return false;
+  shard.edges.emplace_back(start, stop);
+  return true;
+}
+
+template <typename V>
+bool ConcurrentIngest<V>::addLabel(int key,
+                                   const std::vector<std::string> &label) {
+  Shard &shard = shardOf(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  if (!containsLocked(shard, key))
+    return false;
+  for (const auto &l : label) {
+    shard.labels.emplace_back(key, l);
+  }
+  return true;
+}
+
+template <typename V> bool ConcurrentIngest<V>::contains(int key) {
+  Shard &shard = shardOf(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return containsLocked(shard, key);
+}
+
+template <typename V>
+void ConcurrentIngest<V>::take(
+    std::vector<std::pair<int, V>> &vertices,
+    std::vector<std::pair<int, int>> &edges,
+    std::vector<std::pair<int, std::string>> &labels) {
+  size_t vertexCount = 0, edgeCount = 0, labelCount = 0;
+  for (const auto &shard : shards) {
+    vertexCount += shard.vertices.size();
+    edgeCount += shard.edges.size();
+    labelCount += shard.labels.size();
+  }
+  vertices.reserve(vertices.size() + vertexCount);
+  edges.reserve(edges.size() + edgeCount);
+  labels.reserve(labels.size() + labelCount);
+  for (auto &shard : shards) {
+    std::move(shard.vertices.begin(), shard.vertices.end(),
+              std::back_inserter(vertices));
+    edges.insert(edges.end(), shard.edges.begin(), shard.edges.end());
+    std::move(shard.labels.begin(), shard.labels.end(),
+              std::back_inserter(labels));
+    shard.keys = FlatHashMap<int, uint32_t>();
+    std::vector<std::pair<int, V>>().swap(shard.vertices);
+    std::vector<std::pair<int, int>>().swap(shard.edges);
+    std::vector<std::pair<int, std::string>>().swap(shard.labels);
+  }
+}
+
+} // namespace graph
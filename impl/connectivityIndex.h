@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Implementation of the ConnectivityIndex class.
+ *
+ * ConnectivityIndex keeps weakly connected components of graph, components of
+ * graph when direction of edges is ignored, in union-find structure of dense
+ * vertex indices. Vertex is added as its own component and components of
+ * start and stop vertex of each new edge are united, so index is updated with
+ * every new vertex and edge. Removed vertices and edges do not split
+ * components, so graph builds new index from its live vertices and edges,
+ * a few vertices with each change after compaction pass, and then replaces
+ * old index with it. Vertices in different components have no path
+ * between them in any direction.
+ *
+ * Components are united by size and paths to roots are halved by unite, so
+ * trees stay flat. Lookups do not change trees, so many threads can look up
+ * components at the same time, while no thread changes graph.
+ */
+class ConnectivityIndex {
+private:
+  /**
+   * Parent of each vertex in tree of its component, root is its own parent
+   */
+  std::vector<uint32_t> parents;
+
+  /**
+   * Number of vertices in component, valid for roots only
+   */
+  std::vector<uint32_t> sizes;
+
+  /**
+   * Number of components
+   */
+  size_t count = 0;
+
+  /**
+   * Returns root of component of vertex, halving path on the way
+   *
+   * @param vertex dense index of vertex
+   */
+  uint32_t compress(uint32_t vertex);
+
+public:
+  /**
+   * Adds next vertex as its own component
+   *
+   * @return dense index of added vertex
+   */
+  uint32_t add();
+
+  /**
+   * Adds next vertex that is removed from graph, it is its own component and
+   * is not counted in components
+   *
+   * @return dense index of added vertex
+   */
+  uint32_t addRemoved();
+
+  /**
+   * Reserves storage for given number of vertices
+   *
+   * @param capacity number of vertices
+   */
+  void reserve(size_t capacity) {
+    parents.reserve(capacity);
+    sizes.reserve(capacity);
+  }
+
+  /**
+   * Unites components of two vertices
+   *
+   * @param a dense index of vertex
+   * @param b dense index of vertex
+   *
+   * @return true if vertices were in different components
+   */
+  bool unite(uint32_t a, uint32_t b);
+
+  /**
+   * Returns root of component of vertex, trees are not changed
+   *
+   * @param vertex dense index of vertex
+   */
+  uint32_t component(uint32_t vertex) const;
+
+  /**
+   * Returns parent of vertex in tree of its component, root is its own parent
+   *
+   * @param vertex dense index of vertex
+   */
+  uint32_t parent(uint32_t vertex) const { return parents[vertex]; }
+
+  /**
+   * Returns true if two vertices are in the same component
+   *
+   * @param a dense index of vertex
+   * @param b dense index of vertex
+   */
+  bool connected(uint32_t a, uint32_t b) const {
+    return component(a) == component(b);
+  }
+
+  /**
+   * Returns number of components
+   */
+  size_t components() const { return count; }
+
+  /**
+   * Returns number of vertices in index
+   */
+  size_t size() const { return parents.size(); }
+};
+
+inline uint32_t ConnectivityIndex::add() {
+  uint32_t vertex = static_cast<uint32_t>(parents.size());
+  parents.push_back(vertex);
+  sizes.push_back(1);
+  ++count;
+  return vertex;
+}
+
+inline uint32_t ConnectivityIndex::addRemoved() {
+  uint32_t vertex = static_cast<uint32_t>(parents.size());
+  parents.push_back(vertex);
+  sizes.push_back(1);
+  return vertex;
+}
+
+inline uint32_t ConnectivityIndex::compress(uint32_t vertex) {
+  while (parents[vertex] != vertex) {
+    parents[vertex] = parents[parents[vertex]];
+    vertex = parents[vertex];
+  }
+  return vertex;
+}
+
+inline bool ConnectivityIndex::unite(uint32_t a, uint32_t b) {
+  a = compress(a);
+  b = compress(b);
+  if (a == b)
+    return false;
+  // smaller component is attached to larger one, so depth of tree grows only
+  // when its size at least doubles
+  if (sizes[a] < sizes[b])
+    std::swap(a, b);
+  parents[b] = a;
+  sizes[a] += sizes[b];
+  --count;
+  return true;
+}
+
+inline uint32_t ConnectivityIndex::component(uint32_t vertex) const {
+  while (parents[vertex] != vertex) {
+    vertex = parents[vertex];
+  }
+  return vertex;
+}
+
+} // namespace graph
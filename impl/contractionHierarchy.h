@@ -0,0 +1,470 @@
+#pragma once
+
+#include "frontierQueue.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Implementation of the ContractionHierarchy class.
+ *
+ * ContractionHierarchy orders vertices of graph by importance and contracts
+ * them in that order, the least important first. When vertex is contracted,
+ * shortest paths between its remaining neighbors that went over it are kept
+ * as shortcuts, edges with the length of the path and the contracted vertex
+ * as their middle vertex. Shortcut is not added if local search finds other
+ * path, a witness, that is not longer. Importance of vertex is twice the
+ * number of shortcuts its contraction adds less the number of its arcs, plus
+ * number of its contracted neighbors and its depth, one more than depth of
+ * the deepest contracted neighbor, so contraction spreads evenly over graph.
+ * It is computed again for neighbors of contracted vertex, and for vertex on
+ * top of queue, that is contracted if it still has the smallest importance.
+ *
+ * Edges and shortcuts to vertices of higher rank form upward graph, searched
+ * from start vertex, and edges and shortcuts from vertices of higher rank
+ * form downward graph, searched backwards from stop vertex. Both searches go
+ * only upwards in the order of vertices, so they meet at the most important
+ * vertex of shortest path after visiting a small part of graph. Shortcuts of
+ * found path are unpacked back to edges over their middle vertices.
+ *
+ * Hierarchy is built from view of graph with vertexCount(), live(index) and
+ * forEachEdge(index, visit), and is not changed afterwards. Graph does not
+ * search it after its edges change, until it is built again.
+ */
+class ContractionHierarchy {
+public:
+  /// Dense index used for no vertex
+  static constexpr uint32_t noVertex = std::numeric_limits<uint32_t>::max();
+
+  /**
+   * Edge or shortcut of hierarchy
+   */
+  struct Arc {
+    uint32_t vertex; ///< other vertex of arc
+    uint32_t weight; ///< length of arc, number of edges it stands for
+    uint32_t middle; ///< contracted vertex of shortcut, noVertex for edge
+  };
+
+private:
+  /// Length of path that is not found
+  static constexpr uint32_t unreached = std::numeric_limits<uint32_t>::max();
+
+  /// Number of vertices settled by one witness search, before it gives up
+  static constexpr size_t witnessLimit = 256;
+
+  /// Number of vertices settled by witness search that only counts shortcuts
+  static constexpr size_t simulateLimit = 32;
+
+  /**
+   * Upward graph, arcs of vertex to vertices of higher rank, arcs of vertex
+   * with dense index i between upOffsets[i] and upOffsets[i + 1]
+   */
+  std::vector<uint32_t> upOffsets{0};
+  std::vector<Arc> upArcs;
+
+  /**
+   * Downward graph, arcs to vertex from vertices of higher rank, in the same
+   * layout as upward graph
+   */
+  std::vector<uint32_t> downOffsets{0};
+  std::vector<Arc> downArcs;
+
+  /**
+   * Number of shortcuts
+   */
+  size_t shortcuts = 0;
+
+  /**
+   * Arcs of vertices that are not contracted yet, while hierarchy is built
+   */
+  std::vector<std::vector<Arc>> outArcs, inArcs;
+
+  /**
+   * Distances of witness search, vertices it touched and its queue
+   */
+  std::vector<uint32_t> witnessDistances;
+  std::vector<uint32_t> touched;
+  FrontierQueue<uint32_t> witnessQueue;
+
+  /**
+   * Targets of witness search are marked with its stamp, search stops when
+   * all of them are settled
+   */
+  std::vector<uint32_t> targetMarks;
+  uint32_t targetStamp = 0;
+
+  /**
+   * Inserts arc from start to stop vertex, or makes existing arc shorter
+   */
+  void addArc(uint32_t start, uint32_t stop, uint32_t weight, uint32_t middle);
+
+  /**
+   * Searches paths from source vertex that do not go over skipped vertex, up
+   * to length maxWeight or until targets marked with targetStamp are settled
+   * or limit vertices are settled. Distances are left in witnessDistances
+   */
+  void searchWitnesses(uint32_t source, uint32_t skipped, uint32_t maxWeight,
+                       size_t targets, size_t limit);
+
+  /**
+   * Finds shortcuts needed when vertex is contracted, adds them if simulate
+   * is false
+   *
+   * @return number of shortcuts
+   */
+  size_t contract(uint32_t vertex, bool simulate);
+
+  /**
+   * Returns arc of vertex with other vertex in arcs of vertex, nullptr if
+   * vertex has no such arc
+   */
+  static const Arc *findArc(const std::vector<uint32_t> &offsets,
+                            const std::vector<Arc> &arcs, uint32_t vertex,
+                            uint32_t other);
+
+public:
+  /**
+   * Builds hierarchy of graph, hierarchy is cleared first
+   *
+   * @param graph view of graph
+   */
+  template <typename Graph> void build(const Graph &graph);
+
+  /**
+   * Removes hierarchy
+   */
+  void clear();
+
+  /**
+   * Returns number of vertices of hierarchy, 0 if hierarchy is not built
+   */
+  size_t vertexCount() const { return upOffsets.size() - 1; }
+
+  /**
+   * Returns number of shortcuts
+   */
+  size_t shortcutCount() const { return shortcuts; }
+
+  /**
+   * Searches shortest path from start to stop vertex, with search upwards
+   * from start vertex and search upwards in downward graph from stop vertex.
+   * Distances from start vertex and to stop vertex and previous and next
+   * vertices of reached vertices are left in context
+   *
+   * @param start dense index of source Vertex
+   * @param stop dense index of destination Vertex
+   * @param context state of search, begun for this search
+   *
+   * @return dense index of vertex where searches meet on shortest path,
+   * noVertex if there is no path
+   */
+  template <typename Context>
+  uint32_t search(uint32_t start, uint32_t stop, Context &context) const;
+
+  /**
+   * Unpacks path found by search to vertices of graph
+   *
+   * @param meeting vertex returned by search
+   * @param context state of search
+   * @param path dense indices of vertices on path, from start to stop vertex
+   * @param stack storage for shortcuts that are unpacked
+   */
+  template <typename Context>
+  void unpack(uint32_t meeting, const Context &context,
+              std::vector<uint32_t> &path, std::vector<uint32_t> &stack) const;
+};
+
+inline void ContractionHierarchy::clear() {
+  upOffsets.assign(1, 0);
+  downOffsets.assign(1, 0);
+  std::vector<Arc>().swap(upArcs);
+  std::vector<Arc>().swap(downArcs);
+  shortcuts = 0;
+}
+
+inline void ContractionHierarchy::addArc(uint32_t start, uint32_t stop,
+                                         uint32_t weight, uint32_t middle) {
+  for (auto &arc : outArcs[start]) {
+    if (arc.vertex != stop)
+      continue;
+    if (weight < arc.weight) {
+      arc = Arc{stop, weight, middle};
+      for (auto &back : inArcs[stop]) {
+        if (back.vertex == start)
+          back = Arc{start, weight, middle};
+      }
+    }
+    return;
+  }
+  outArcs[start].push_back(Arc{stop, weight, middle});
+  inArcs[stop].push_back(Arc{start, weight, middle});
+}
+
+inline void ContractionHierarchy::searchWitnesses(uint32_t source,
+                                                  uint32_t skipped,
+                                                  uint32_t maxWeight,
+                                                  size_t targets,
+                                                  size_t limit) {
+  for (auto vertex : touched) {
+    witnessDistances[vertex] = unreached;
+  }
+  touched.assign(1, source);
+  witnessDistances[source] = 0;
+  witnessQueue.clear();
+  witnessQueue.push(0, source);
+  size_t settled = 0;
+  while (!witnessQueue.empty()) {
+    auto [distance, u] = witnessQueue.pop();
+    auto uDistance = static_cast<uint32_t>(distance);
+    if (uDistance > witnessDistances[u])
+      continue;
+    if (uDistance >= maxWeight || ++settled > limit)
+      break;
+    if (targetMarks[u] == targetStamp && --targets == 0)
+      break;
+    for (const auto &arc : outArcs[u]) {
+      if (arc.vertex == skipped)
+        continue;
+      uint32_t next = uDistance + arc.weight;
+      if (next < witnessDistances[arc.vertex]) {
+        if (witnessDistances[arc.vertex] == unreached)
+          touched.push_back(arc.vertex);
+        witnessDistances[arc.vertex] = next;
+        witnessQueue.push(static_cast<int>(next), arc.vertex);
+      }
+    }
+  }
+}
+
+inline size_t ContractionHierarchy::contract(uint32_t vertex, bool simulate) {
+  size_t added = 0;
+  // arcs of contracted vertex are not changed by new shortcuts, they are
+  // between its neighbors
+  for (const auto &incoming : inArcs[vertex]) {
+    uint32_t u = incoming.vertex;
+    uint32_t maxWeight = 0;
+    size_t targets = 0;
+    if (++targetStamp == 0) {
+      std::fill(targetMarks.begin(), targetMarks.end(), 0);
+      targetStamp = 1;
+    }
+    for (const auto &outgoing : outArcs[vertex]) {
+      if (outgoing.vertex == u)
+        continue;
+      maxWeight = std::max(maxWeight, incoming.weight + outgoing.weight);
+      targetMarks[outgoing.vertex] = targetStamp;
+      ++targets;
+    }
+    if (targets == 0)
+      continue;
+    searchWitnesses(u, vertex, maxWeight, targets,
+                    simulate ? simulateLimit : witnessLimit);
+    for (const auto &outgoing : outArcs[vertex]) {
+      uint32_t w = outgoing.vertex;
+      uint32_t weight = incoming.weight + outgoing.weight;
+      if (w == u || witnessDistances[w] <= weight)
+        continue;
+      ++added;
+      if (!simulate)
+        addArc(u, w, weight, vertex);
+    }
+  }
+  return added;
+}
+
+template <typename Graph> void ContractionHierarchy::build(const Graph &graph) {
+  clear();
+  auto n = static_cast<uint32_t>(graph.vertexCount());
+  outArcs.assign(n, {});
+  inArcs.assign(n, {});
+  witnessDistances.assign(n, unreached);
+  touched.clear();
+  targetMarks.assign(n, 0);
+  targetStamp = 0;
+  for (uint32_t u = 0; u < n; u++) {
+    if (!graph.live(u))
+      continue;
+    graph.forEachEdge(u, [&](uint32_t v) {
+      if (v != u)
+        addArc(u, v, 1, noVertex);
+    });
+  }
+
+  // importance of vertex is computed again when it reaches top of queue, and
+  // of its neighbors after it is contracted. Entries with older importance
+  // are skipped
+  std::vector<int> contractedNeighbors(n, 0);
+  std::vector<int> depths(n, 0);
+  std::vector<int> importances(n, 0);
+  std::vector<uint8_t> contracted(n, 0);
+  auto importance = [&](uint32_t vertex) {
+    return 2 * static_cast<int>(contract(vertex, true)) -
+           static_cast<int>(outArcs[vertex].size() + inArcs[vertex].size()) +
+           contractedNeighbors[vertex] + depths[vertex];
+  };
+  FrontierQueue<uint32_t> queue;
+  for (uint32_t u = 0; u < n; u++) {
+    if (!graph.live(u))
+      continue;
+    importances[u] = importance(u);
+    queue.push(importances[u], u);
+  }
+  std::vector<std::vector<Arc>> up(n), down(n);
+  std::vector<uint32_t> neighbors;
+  while (!queue.empty()) {
+    auto [priority, vertex] = queue.pop();
+    if (contracted[vertex] || priority != importances[vertex])
+      continue;
+    importances[vertex] = importance(vertex);
+    if (!queue.empty() && importances[vertex] > queue.top().first) {
+      queue.push(importances[vertex], vertex);
+      continue;
+    }
+    shortcuts += contract(vertex, false);
+    contracted[vertex] = 1;
+    // arcs to and from neighbors that are not contracted yet go to vertices
+    // of higher rank, vertex is removed from arcs of neighbors
+    neighbors.clear();
+    for (const auto &arc : outArcs[vertex]) {
+      auto &arcs = inArcs[arc.vertex];
+      arcs.erase(std::find_if(arcs.begin(), arcs.end(),
+                              [vertex](const Arc &a) {
+                                return a.vertex == vertex;
+                              }));
+      neighbors.push_back(arc.vertex);
+    }
+    for (const auto &arc : inArcs[vertex]) {
+      auto &arcs = outArcs[arc.vertex];
+      arcs.erase(std::find_if(arcs.begin(), arcs.end(),
+                              [vertex](const Arc &a) {
+                                return a.vertex == vertex;
+                              }));
+      neighbors.push_back(arc.vertex);
+    }
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()),
+                    neighbors.end());
+    for (auto neighbor : neighbors) {
+      ++contractedNeighbors[neighbor];
+      depths[neighbor] = std::max(depths[neighbor], depths[vertex] + 1);
+      importances[neighbor] = importance(neighbor);
+      queue.push(importances[neighbor], neighbor);
+    }
+    up[vertex].swap(outArcs[vertex]);
+    down[vertex].swap(inArcs[vertex]);
+  }
+
+  for (uint32_t u = 0; u < n; u++) {
+    upArcs.insert(upArcs.end(), up[u].begin(), up[u].end());
+    upOffsets.push_back(static_cast<uint32_t>(upArcs.size()));
+    downArcs.insert(downArcs.end(), down[u].begin(), down[u].end());
+    downOffsets.push_back(static_cast<uint32_t>(downArcs.size()));
+  }
+  std::vector<std::vector<Arc>>().swap(outArcs);
+  std::vector<std::vector<Arc>>().swap(inArcs);
+  std::vector<uint32_t>().swap(witnessDistances);
+  std::vector<uint32_t>().swap(touched);
+  std::vector<uint32_t>().swap(targetMarks);
+  witnessQueue = FrontierQueue<uint32_t>();
+}
+
+template <typename Context>
+uint32_t ContractionHierarchy::search(uint32_t start, uint32_t stop,
+                                      Context &context) const {
+  auto &forward = context.frontier();
+  auto &backward = context.backwardFrontier();
+  context.setDistance(start, 0, noVertex);
+  context.setReverseDistance(stop, 0, noVertex);
+  forward.push(0, start);
+  backward.push(0, stop);
+  int best = Context::infinity;
+  uint32_t meeting = noVertex;
+
+  // each search stops when its nearest vertex is not closer than the best
+  // path found, searches take turns by distance of their nearest vertex
+  while (true) {
+    bool forwardOpen = !forward.empty() && forward.top().first < best;
+    bool backwardOpen = !backward.empty() && backward.top().first < best;
+    if (!forwardOpen && !backwardOpen)
+      break;
+    bool isForward =
+        forwardOpen &&
+        (!backwardOpen || forward.top().first <= backward.top().first);
+    auto [distance, u] = isForward ? forward.pop() : backward.pop();
+    int current = isForward ? context.distance(u) : context.reverseDistance(u);
+    if (distance > current)
+      continue;
+    context.visit();
+    int other = isForward ? context.reverseDistance(u) : context.distance(u);
+    if (other != Context::infinity && distance + other < best) {
+      best = distance + other;
+      meeting = u;
+    }
+    const auto &offsets = isForward ? upOffsets : downOffsets;
+    const auto &arcs = isForward ? upArcs : downArcs;
+    for (uint32_t i = offsets[u]; i < offsets[u + 1]; i++) {
+      const Arc &arc = arcs[i];
+      int next = distance + static_cast<int>(arc.weight);
+      if (isForward && next < context.distance(arc.vertex)) {
+        context.setDistance(arc.vertex, next, u);
+        forward.push(next, arc.vertex);
+      } else if (!isForward && next < context.reverseDistance(arc.vertex)) {
+        context.setReverseDistance(arc.vertex, next, u);
+        backward.push(next, arc.vertex);
+      }
+    }
+  }
+  return meeting;
+}
+
+inline const ContractionHierarchy::Arc *
+ContractionHierarchy::findArc(const std::vector<uint32_t> &offsets,
+                              const std::vector<Arc> &arcs, uint32_t vertex,
+                              uint32_t other) {
+  for (uint32_t i = offsets[vertex]; i < offsets[vertex + 1]; i++) {
+    if (arcs[i].vertex == other)
+      return &arcs[i];
+  }
+  return nullptr;
+}
+
+template <typename Context>
+void ContractionHierarchy::unpack(uint32_t meeting, const Context &context,
+                                  std::vector<uint32_t> &path,
+                                  std::vector<uint32_t> &stack) const {
+  // vertices of path in hierarchy, from stop vertex on bottom of stack to
+  // start vertex on top
+  path.clear();
+  stack.clear();
+  for (uint32_t v = meeting; v != noVertex; v = context.next(v)) {
+    stack.push_back(v);
+  }
+  std::reverse(stack.begin(), stack.end());
+  for (uint32_t v = context.previous(meeting); v != noVertex;
+       v = context.previous(v)) {
+    stack.push_back(v);
+  }
+  path.push_back(stack.back());
+  stack.pop_back();
+  // arc from the last vertex of path to vertex on top of stack is in upward
+  // graph of its source or in downward graph of its destination. Edge is
+  // taken to path, for shortcut its middle vertex is reached first
+  while (!stack.empty()) {
+    uint32_t u = path.back();
+    uint32_t v = stack.back();
+    const Arc *arc = findArc(upOffsets, upArcs, u, v);
+    if (arc == nullptr)
+      arc = findArc(downOffsets, downArcs, v, u);
+    if (arc->middle == noVertex) {
+      path.push_back(v);
+      stack.pop_back();
+    } else {
+      stack.push_back(arc->middle);
+    }
+  }
+}
+
+} // namespace graph
@@ -0,0 +1,371 @@
+#pragma once
+
+#include "flatHashMap.h"
+#include "labelIndex.h"
+#include "linkedVertices.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace graph {
+
+/**
+ * Implementation of the CsrSnapshot class.
+ *
+ * CsrSnapshot is an immutable compressed sparse row view of graph stored in
+ * LinkedListOfVertices. Vertices keep dense indices 0..N-1 they have in
+ * LinkedListOfVertices, given in order of insertion. Edges of vertex with
+ * index i are stored in neighbors array, between offsets[i] and
+ * offsets[i + 1], as dense indices of destination vertices. Incoming edges
+ * are stored in the same way, in inNeighbors between inOffsets[i] and
+ * inOffsets[i + 1], as dense indices of source vertices. All arrays are
+ * contiguous, so traversal does not go through LinkedVertices of each vertex.
+ *
+ * Vertices of each label are also kept in LabelIndex, by dense index, so that
+ * searches can restrict to vertices that have labels of search.
+ *
+ * Snapshot is built from vertex arrays of LinkedListOfVertices. Removed
+ * vertices keep their dense index, without edges, and removed edges are left
+ * out. Vertex labels can be patched in place, all other changes of graph
+ * require a rebuild.
+ *
+ * @tparam V type of data stored in graph vertices
+ */
+template <typename V> class CsrSnapshot {
+private:
+  /**
+   * Keys of vertices, indexed by dense index
+   */
+  std::vector<int> keys;
+
+  /**
+   * Map of pair < key of vertex, dense index of vertex >
+   */
+  FlatHashMap<int, uint32_t> indices;
+
+  /**
+   * Offsets of edges of each vertex in neighbors, size is number of
+   * vertices + 1
+   */
+  std::vector<uint32_t> offsets;
+
+  /**
+   * Dense indices of destination vertices of all edges
+   */
+  std::vector<uint32_t> neighbors;
+
+  /**
+   * Bits of label ids < 64 of vertices, indexed by dense index
+   */
+  std::vector<uint64_t> labelBits;
+
+  /**
+   * Map of pair < dense index, labels of vertex >, for vertices that have
+   * labels with id >= 64
+   */
+  std::unordered_map<uint32_t, LabelSet> overflowLabels;
+
+  /**
+   * Inverted index of labels, sets of dense indices of vertices with label
+   */
+  LabelIndex labelIndex;
+
+  /**
+   * Offsets of incoming edges of each vertex in inNeighbors, size is number of
+   * vertices + 1
+   */
+  std::vector<uint32_t> inOffsets;
+
+  /**
+   * Dense indices of source vertices of all edges, grouped by destination
+   * vertex and sorted ascending within each group
+   */
+  std::vector<uint32_t> inNeighbors;
+
+public:
+  /**
+   * Constructor of CsrSnapshot
+   *
+   * Builds snapshot from vertex arrays of LinkedListOfVertices. Edges are
+   * copied as dense indices in one pass, incoming edges are then grouped by
+   * destination vertex with counting sort.
+   *
+   * @param vertices ptrs to LinkedVertices, indexed by dense index
+   * @param labels labels of vertices, indexed by dense index
+   * @param removed 1 for removed vertices, indexed by dense index
+   * @param ids map of pair < key of vertex, dense index of vertex >
+   */
+  CsrSnapshot(const std::pmr::vector<LinkedVertices<V> *> &vertices,
+              const std::pmr::vector<LabelSet> &labels,
+              const std::pmr::vector<uint8_t> &removed,
+              const FlatHashMap<int, uint32_t> &ids);
+
+  /**
+   * Constructor of CsrSnapshot
+   *
+   * Builds snapshot of graph without vertices.
+   */
+  CsrSnapshot() : offsets(1, 0), inOffsets(1, 0) {}
+
+  /// Disabling construction of CsrSnapshot object using copy constructor
+  CsrSnapshot(const CsrSnapshot &rhs) = delete;
+
+  /// Disabling construction of CsrSnapshot object using copy assignment
+  CsrSnapshot &operator=(const CsrSnapshot &rhs) = delete;
+
+  /**
+   * Returns number of vertices in snapshot
+   */
+  size_t vertexCount() const { return keys.size(); }
+
+  /**
+   * Returns number of edges in snapshot
+   */
+  size_t edgeCount() const { return neighbors.size(); }
+
+  /**
+   * Finds dense index of vertex with given key
+   *
+   * @param key key id of Vertex
+   * @param index dense index of Vertex, set if vertex is found
+   *
+   * @return true if snapshot contains vertex with key
+   */
+  bool findIndex(int key, uint32_t &index) const;
+
+  /**
+   * Returns key of vertex with dense index
+   *
+   * @param index dense index of Vertex
+   */
+  int keyOf(uint32_t index) const { return keys[index]; }
+
+  /**
+   * Returns pointer to first edge of vertex with dense index, edges are
+   * stored contiguously until edgesEnd(index)
+   *
+   * @param index dense index of Vertex
+   */
+  const uint32_t *edgesBegin(uint32_t index) const {
+    return neighbors.data() + offsets[index];
+  }
+
+  /**
+   * Returns pointer past the last edge of vertex with dense index
+   *
+   * @param index dense index of Vertex
+   */
+  const uint32_t *edgesEnd(uint32_t index) const {
+    return neighbors.data() + offsets[index + 1];
+  }
+
+  /**
+   * Replaces labels of vertex with dense index, used to patch snapshot when
+   * labels of vertex are changed in graph
+   *
+   * @param index dense index of Vertex
+   * @param labels new labels of Vertex
+   */
+  void patchLabels(uint32_t index, const LabelSet &labels);
+
+  /**
+   * Returns set of dense indices of vertices that have all labels of mask,
+   * mask should not be empty
+   *
+   * @param mask compiled labels of search
+   */
+  CompressedVertexSet findVertices(const LabelMask &mask) const {
+    return labelIndex.find(mask);
+  }
+
+  /**
+   * Sets bits of dense indices of vertices that have all labels of mask,
+   * without building set of them
+   *
+   * @param mask compiled labels of search
+   * @param words cleared bitmap of dense indices
+   * @param scratch bitmap used for intersection of sets of labels
+   */
+  void findVertexBits(const LabelMask &mask, std::vector<uint64_t> &words,
+                      std::vector<uint64_t> &scratch) const {
+    labelIndex.findBits(mask, words, scratch);
+  }
+
+  /**
+   * Returns pointer to first incoming edge of vertex with dense index,
+   * incoming edges are stored contiguously until incomingEnd(index)
+   *
+   * @param index dense index of Vertex
+   */
+  const uint32_t *incomingBegin(uint32_t index) const {
+    return inNeighbors.data() + inOffsets[index];
+  }
+
+  /**
+   * Returns pointer past the last incoming edge of vertex with dense index
+   *
+   * @param index dense index of Vertex
+   */
+  const uint32_t *incomingEnd(uint32_t index) const {
+    return inNeighbors.data() + inOffsets[index + 1];
+  }
+
+  /**
+   * Returns number of edges of vertex with dense index
+   *
+   * @param index dense index of Vertex
+   */
+  uint32_t outDegree(uint32_t index) const {
+    return offsets[index + 1] - offsets[index];
+  }
+
+  /**
+   * Returns number of incoming edges of vertex with dense index
+   *
+   * @param index dense index of Vertex
+   */
+  uint32_t inDegree(uint32_t index) const {
+    return inOffsets[index + 1] - inOffsets[index];
+  }
+
+  /**
+   * Checks if labels of vertex with dense index contain all labels of mask and
+   * returns true if do
+   *
+   * @param index dense index of Vertex
+   * @param mask compiled labels for which is checked if they are inserted in
+   * labels of Vertex
+   */
+  bool hasLabel(uint32_t index, const LabelMask &mask) const {
+    return (labelBits[index] & mask.bits) == mask.bits && mask.satisfiable &&
+           (mask.overflow.empty() || hasOverflowLabel(index, mask));
+  }
+
+  /**
+   * Checks labels of up to 64 vertices at once, bit i of result is set if
+   * vertex vertices[i] has all labels of mask. Label bits are compared without
+   * branches, so the loop can be vectorized by compiler.
+   *
+   * @param vertices dense indices of vertices, usually edges of one vertex
+   * @param count number of vertices, at most 64
+   * @param mask compiled labels of search
+   */
+  uint64_t matchLabels(const uint32_t *vertices, size_t count,
+                       const LabelMask &mask) const;
+
+private:
+  /**
+   * Checks if vertex with dense index has labels of mask with id >= 64
+   */
+  bool hasOverflowLabel(uint32_t index, const LabelMask &mask) const;
+};
+
+template <typename V>
+CsrSnapshot<V>::CsrSnapshot(
+    const std::pmr::vector<LinkedVertices<V> *> &vertices,
+    const std::pmr::vector<LabelSet> &labels,
+    const std::pmr::vector<uint8_t> &removed,
+    const FlatHashMap<int, uint32_t> &ids)
+    : indices(ids) {
+  keys.reserve(vertices.size());
+  labelBits.reserve(vertices.size());
+  offsets.reserve(vertices.size() + 1);
+
+  size_t edges = 0;
+  for (uint32_t index = 0; index < vertices.size(); ++index) {
+    keys.push_back(vertices[index]->getHead()->id);
+    if (labels[index].hasOverflow())
+      overflowLabels.emplace(index, labels[index]);
+    labelBits.push_back(labels[index].inlineBits());
+    for (auto labelId : labels[index].ids()) {
+      labelIndex.add(labelId, index);
+    }
+    edges += vertices[index]->returnEdges().size();
+  }
+
+  // removed edges and edges of removed vertices, that are not compacted yet,
+  // are left out
+  neighbors.reserve(edges);
+  offsets.push_back(0);
+  for (uint32_t index = 0; index < vertices.size(); ++index) {
+    if (!removed[index]) {
+      for (auto edge : vertices[index]->returnEdges()) {
+        if (edge != LinkedVertices<V>::removedEdge && !removed[edge])
+          neighbors.push_back(edge);
+      }
+    }
+    offsets.push_back(static_cast<uint32_t>(neighbors.size()));
+  }
+
+  // count incoming edges of each vertex, then place sources in ascending order,
+  // since vertices are visited in ascending order of dense index
+  inOffsets.assign(keys.size() + 1, 0);
+  for (auto destination : neighbors) {
+    ++inOffsets[destination + 1];
+  }
+  for (size_t i = 0; i < keys.size(); ++i) {
+    inOffsets[i + 1] += inOffsets[i];
+  }
+  std::vector<uint32_t> position(inOffsets.begin(), inOffsets.end() - 1);
+  inNeighbors.resize(neighbors.size());
+  for (uint32_t source = 0; source < keys.size(); ++source) {
+    for (auto edge = edgesBegin(source); edge != edgesEnd(source); ++edge) {
+      inNeighbors[position[*edge]++] = source;
+    }
+  }
+}
+
+template <typename V>
+bool CsrSnapshot<V>::findIndex(int key, uint32_t &index) const {
+  return indices.find(key, index);
+}
+
+template <typename V>
+void CsrSnapshot<V>::patchLabels(uint32_t index, const LabelSet &labels) {
+  for (uint64_t bits = labelBits[index]; bits != 0; bits &= bits - 1) {
+    labelIndex.remove(static_cast<uint32_t>(__builtin_ctzll(bits)), index);
+  }
+  auto it = overflowLabels.find(index);
+  if (it != overflowLabels.end()) {
+    for (auto labelId : it->second.ids()) {
+      labelIndex.remove(labelId, index);
+    }
+  }
+  for (auto labelId : labels.ids()) {
+    labelIndex.add(labelId, index);
+  }
+
+  labelBits[index] = labels.inlineBits();
+  if (labels.hasOverflow())
+    overflowLabels[index] = labels;
+  else
+    overflowLabels.erase(index);
+}
+
+template <typename V>
+uint64_t CsrSnapshot<V>::matchLabels(const uint32_t *vertices, size_t count,
+                                     const LabelMask &mask) const {
+  if (!mask.satisfiable)
+    return 0;
+  uint64_t result = 0;
+  for (size_t i = 0; i < count; ++i) {
+    result |= uint64_t((labelBits[vertices[i]] & mask.bits) == mask.bits) << i;
+  }
+  if (!mask.overflow.empty()) {
+    for (uint64_t matched = result; matched != 0; matched &= matched - 1) {
+      size_t i = static_cast<size_t>(__builtin_ctzll(matched));
+      if (!hasOverflowLabel(vertices[i], mask))
+        result &= ~(uint64_t(1) << i);
+    }
+  }
+  return result;
+}
+
+template <typename V>
+bool CsrSnapshot<V>::hasOverflowLabel(uint32_t index,
+                                      const LabelMask &mask) const {
+  auto it = overflowLabels.find(index);
+  return it != overflowLabels.end() && it->second.containsOverflow(mask);
+}
+
+} // namespace graph
@@ -0,0 +1,396 @@
+#pragma once
+
+#include "csrSnapshot.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Implementation of the DirectionOptimizingBfs class.
+ *
+ * All edges in graph have the same weight, so shortest path is found with
+ * breadth first search. Search is level synchronous, vertices of current level
+ * (frontier) and of next level are kept both as bitmaps and as lists of dense
+ * indices of CsrSnapshot. Each level is expanded in one of two directions:
+ *
+ * - top-down, edges of every frontier vertex are checked and vertices that are
+ *   not visited are added to next level,
+ * - bottom-up, incoming edges of every vertex that is not visited are checked,
+ *   until a frontier vertex is found.
+ *
+ * Search starts top-down and switches to bottom-up when the frontier is
+ * growing, has more edges than 1 / alpha of edges of unvisited vertices and at
+ * least 1 / beta of all vertices. It goes back to top-down when the frontier is
+ * shrinking and has less than 1 / beta of all vertices (Beamer's direction
+ * optimizing BFS).
+ *
+ * Previous vertex of each reached vertex is its frontier neighbor with the
+ * largest dense index, in both directions, so the same paths are found as with
+ * Dijkstra search in LinkedListOfVertices. Search with labels is rejected at
+ * once if stop vertex does not have them. In top-down steps, labels of edges of
+ * a frontier vertex are checked in batches of 64 and vertices that do not have
+ * labels are excluded the first time they are checked. Bottom-up steps check
+ * only candidate vertices, found in label index of snapshot when the first
+ * bottom-up step is made.
+ *
+ * @tparam V type of data stored in graph vertices
+ */
+template <typename V> class DirectionOptimizingBfs {
+private:
+  /**
+   * Bitmap of vertices that are visited in previous levels or excluded
+   */
+  std::vector<uint64_t> visited;
+
+  /**
+   * Bitmap of vertices in current level
+   */
+  std::vector<uint64_t> frontierBits;
+
+  /**
+   * Bitmap of vertices in next level
+   */
+  std::vector<uint64_t> nextBits;
+
+  /**
+   * Bitmap of vertices that have labels of search, used in bottom-up steps
+   */
+  std::vector<uint64_t> candidates;
+
+  /**
+   * Bitmap used to intersect sets of labels into candidates
+   */
+  std::vector<uint64_t> labelScratch;
+
+  /**
+   * Set to true when candidates bitmap is filled for current search
+   */
+  bool candidatesReady = false;
+
+  /**
+   * Dense indices of vertices in current level
+   */
+  std::vector<uint32_t> frontier;
+
+  /**
+   * Dense indices of vertices in next level
+   */
+  std::vector<uint32_t> next;
+
+  /**
+   * Dense indices of vertices set in visited bitmap, so that only their bits
+   * are cleared before next search
+   */
+  std::vector<uint32_t> touched;
+
+  /**
+   * Dense index of previous vertex on the path, valid for reached vertices
+   */
+  std::vector<uint32_t> parent;
+
+  /**
+   * Top-down to bottom-up switch parameter
+   */
+  size_t alpha;
+
+  /**
+   * Bottom-up to top-down switch parameter
+   */
+  size_t beta;
+
+  /**
+   * Number of edges checked in last search
+   */
+  size_t edgesExamined = 0;
+
+  /**
+   * Number of levels expanded bottom-up in last search
+   */
+  size_t bottomUpSteps = 0;
+
+  /**
+   * Sum of incoming edges of vertices that are not visited
+   */
+  size_t remainingEdges = 0;
+
+  /**
+   * Sum of edges of vertices in next level
+   */
+  size_t nextEdges = 0;
+
+  /**
+   * Set to true when stop vertex is added to next level
+   */
+  bool stopReached = false;
+
+  static bool testBit(const std::vector<uint64_t> &bits, uint32_t index) {
+    return (bits[index >> 6] >> (index & 63)) & 1;
+  }
+
+  static void setBit(std::vector<uint64_t> &bits, uint32_t index) {
+    bits[index >> 6] |= uint64_t(1) << (index & 63);
+  }
+
+  static void clearBit(std::vector<uint64_t> &bits, uint32_t index) {
+    bits[index >> 6] &= ~(uint64_t(1) << (index & 63));
+  }
+
+  /**
+   * Adds vertex to next level
+   *
+   * @param csr snapshot that is searched
+   * @param vertex dense index of vertex reached from frontier
+   * @param from dense index of frontier vertex
+   * @param stop dense index of destination Vertex
+   */
+  template <typename Csr>
+  void reach(const Csr &csr, uint32_t vertex, uint32_t from, uint32_t stop);
+
+  /**
+   * Excludes vertex that does not have labels from search
+   *
+   * @param csr snapshot that is searched
+   * @param vertex dense index of vertex reached from frontier
+   */
+  template <typename Csr>
+  void exclude(const Csr &csr, uint32_t vertex);
+
+  /**
+   * Expands frontier by checking edges of frontier vertices
+   */
+  template <typename Csr>
+  void stepTopDown(const Csr &csr, uint32_t stop, const LabelMask &mask);
+
+  /**
+   * Expands frontier by checking incoming edges of unvisited vertices that
+   * have labels of search
+   */
+  template <typename Csr>
+  void stepBottomUp(const Csr &csr, uint32_t stop, const LabelMask &mask);
+
+public:
+  /**
+   * Constructor of DirectionOptimizingBfs
+   *
+   * @param alpha top-down to bottom-up switch parameter, 0 disables bottom-up
+   * steps
+   * @param beta bottom-up to top-down switch parameter
+   */
+  explicit DirectionOptimizingBfs(size_t alpha = 14, size_t beta = 24)
+      : alpha(alpha), beta(beta) {}
+
+  /**
+   * Finds shortest path between two Vertices in snapshot
+   *
+   * Keys of vertices on path, without stop vertex, are pushed to path.
+   *
+   * @tparam Csr CsrSnapshot, or MappedGraph with the same accessors
+   * @param csr snapshot that is searched
+   * @param start dense index of source Vertex
+   * @param stop dense index of destination Vertex
+   * @param mask compiled label of Vertices found on shortest path
+   * @param path keys of vertices on the shortest path, stop vertex excluded
+   *
+   * @return true if there is a path between two vertices, where each vertex on
+   * the path has label
+   */
+  template <typename Csr>
+  bool search(const Csr &csr, uint32_t start, uint32_t stop,
+              const LabelMask &mask, std::vector<int> &path);
+
+  /**
+   * Returns number of edges checked in last search
+   */
+  size_t lastEdgesExamined() const { return edgesExamined; }
+
+  /**
+   * Returns number of levels expanded bottom-up in last search
+   */
+  size_t lastBottomUpSteps() const { return bottomUpSteps; }
+};
+
+template <typename V>
+template <typename Csr>
+void DirectionOptimizingBfs<V>::reach(const Csr &csr, uint32_t vertex,
+                                      uint32_t from, uint32_t stop) {
+  setBit(nextBits, vertex);
+  next.push_back(vertex);
+  parent[vertex] = from;
+  nextEdges += csr.outDegree(vertex);
+  if (vertex == stop)
+    stopReached = true;
+}
+
+template <typename V>
+template <typename Csr>
+void DirectionOptimizingBfs<V>::exclude(const Csr &csr, uint32_t vertex) {
+  setBit(visited, vertex);
+  touched.push_back(vertex);
+  remainingEdges -= csr.inDegree(vertex);
+}
+
+template <typename V>
+template <typename Csr>
+void DirectionOptimizingBfs<V>::stepTopDown(const Csr &csr, uint32_t stop,
+                                            const LabelMask &mask) {
+  for (auto u : frontier) {
+    // ends of edges are read once, lookups of edges of vertex in versions of
+    // graph go through their chunks
+    const uint32_t *begin = csr.edgesBegin(u);
+    const uint32_t *end = csr.edgesEnd(u);
+    edgesExamined += static_cast<size_t>(end - begin);
+    // labels of edges are checked in batches of 64, before edges are visited
+    for (auto batch = begin; batch < end; batch += 64) {
+      size_t count = std::min<size_t>(64, end - batch);
+      uint64_t matching = csr.matchLabels(batch, count, mask);
+      for (size_t i = 0; i < count; ++i) {
+        uint32_t v = batch[i];
+        if (testBit(nextBits, v)) {
+          // frontier is not ordered, keep the largest previous vertex
+          if (u > parent[v])
+            parent[v] = u;
+        } else if (!testBit(visited, v)) {
+          if ((matching >> i) & 1)
+            reach(csr, v, u, stop);
+          else
+            exclude(csr, v);
+        }
+      }
+    }
+  }
+}
+
+template <typename V>
+template <typename Csr>
+void DirectionOptimizingBfs<V>::stepBottomUp(const Csr &csr, uint32_t stop,
+                                             const LabelMask &mask) {
+  uint32_t n = static_cast<uint32_t>(csr.vertexCount());
+  bool filtered = !mask.empty();
+  if (filtered && !candidatesReady) {
+    candidates.assign(visited.size(), 0);
+    csr.findVertexBits(mask, candidates, labelScratch);
+    candidatesReady = true;
+  }
+
+  // vertices that do not have labels are never reached, so only unvisited
+  // candidates are checked
+  for (size_t word = 0; word < visited.size(); ++word) {
+    uint64_t unvisited = ~visited[word];
+    if (filtered)
+      unvisited &= candidates[word];
+    while (unvisited != 0) {
+      uint32_t v = static_cast<uint32_t>(word * 64) +
+                   static_cast<uint32_t>(__builtin_ctzll(unvisited));
+      unvisited &= unvisited - 1;
+      if (v >= n)
+        break;
+      // incoming edges are sorted, the first frontier vertex found from the
+      // end is the largest one
+      const uint32_t *begin = csr.incomingBegin(v);
+      for (auto edge = csr.incomingEnd(v); edge != begin;) {
+        --edge;
+        ++edgesExamined;
+        if (testBit(frontierBits, *edge)) {
+          reach(csr, v, *edge, stop);
+          break;
+        }
+      }
+    }
+  }
+}
+
+template <typename V>
+template <typename Csr>
+bool DirectionOptimizingBfs<V>::search(const Csr &csr, uint32_t start,
+                                       uint32_t stop, const LabelMask &mask,
+                                       std::vector<int> &path) {
+  edgesExamined = 0;
+  bottomUpSteps = 0;
+  stopReached = false;
+  candidatesReady = false;
+  if (start == stop || !csr.hasLabel(stop, mask))
+    return false;
+
+  // bitmaps are allocated once per snapshot size, after that only bits of
+  // vertices visited in previous search are cleared. Snapshots of different
+  // sizes can have the same number of words, so parents are checked too
+  size_t n = csr.vertexCount();
+  size_t words = (n + 63) / 64;
+  if (visited.size() != words || parent.size() != n ||
+      touched.size() > words) {
+    visited.assign(words, 0);
+    frontierBits.assign(words, 0);
+    nextBits.assign(words, 0);
+    parent.resize(n);
+  } else {
+    for (auto index : touched) {
+      clearBit(visited, index);
+    }
+  }
+  touched.clear();
+  frontier.clear();
+  next.clear();
+
+  frontier.push_back(start);
+  setBit(frontierBits, start);
+  setBit(visited, start);
+  touched.push_back(start);
+  remainingEdges = csr.edgeCount() - csr.inDegree(start);
+  size_t frontierEdges = csr.outDegree(start);
+  size_t previousFrontierSize = 0;
+  bool bottomUp = false;
+
+  while (!frontier.empty() && !stopReached) {
+    // bottom-up step checks every unvisited vertex, so it is worth only for
+    // frontiers that are large both in edges and in vertices
+    bool growing = frontier.size() > previousFrontierSize;
+    bool largeFrontier = frontier.size() * beta >= n;
+    if (!bottomUp && growing && largeFrontier &&
+        frontierEdges * alpha > remainingEdges)
+      bottomUp = true;
+    else if (bottomUp && !growing && !largeFrontier)
+      bottomUp = false;
+    previousFrontierSize = frontier.size();
+
+    next.clear();
+    nextEdges = 0;
+    if (bottomUp) {
+      ++bottomUpSteps;
+      stepBottomUp(csr, stop, mask);
+    } else {
+      stepTopDown(csr, stop, mask);
+    }
+
+    for (auto u : frontier) {
+      clearBit(frontierBits, u);
+    }
+    for (auto v : next) {
+      setBit(visited, v);
+      touched.push_back(v);
+      remainingEdges -= csr.inDegree(v);
+    }
+    frontier.swap(next);
+    frontierBits.swap(nextBits);
+    frontierEdges = nextEdges;
+  }
+
+  for (auto u : frontier) {
+    clearBit(frontierBits, u);
+  }
+
+  if (!stopReached)
+    return false;
+
+  // keys are pushed from stop vertex back to start vertex, then reversed
+  size_t first = path.size();
+  for (uint32_t index = stop; index != start;) {
+    index = parent[index];
+    path.push_back(csr.keyOf(index));
+  }
+  std::reverse(path.begin() + first, path.end());
+  return true;
+}
+
+} // namespace graph
@@ -0,0 +1,355 @@
+#pragma once
+
+#include "parallelFor.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Implementation of the EdgeListReader class.
+ *
+ * EdgeListReader reads text files of graph, edge lists with one edge per line,
+ * "start stop", and label files with key of vertex and its labels on each
+ * line, "key label label ...". Numbers and labels are separated by spaces or
+ * tabs, empty lines and comment lines starting with '#' or '%' are skipped,
+ * as are lines that do not start with the numbers that are expected.
+ *
+ * File is read in chunks of fixed size that end at line boundary, the rest of
+ * the last line is moved to the start of next chunk. Each chunk is split at
+ * line boundaries in one part for each thread and parts are parsed in
+ * parallel, so memory used for reading is bounded by size of chunk and its
+ * parsed lines, whatever the size of file.
+ */
+class EdgeListReader {
+public:
+  /// Default size of chunk of file that is read at once
+  static constexpr size_t defaultChunkBytes = size_t(16) << 20;
+
+private:
+  /**
+   * Open file, nullptr if no file is open
+   */
+  std::FILE *file = nullptr;
+
+  /**
+   * Chunk of file, the rest of its last line is kept for next chunk
+   */
+  std::vector<char> buffer;
+
+  /**
+   * Offset and size of the rest of previous chunk in buffer, last line of
+   * file that was read without its newline
+   */
+  size_t restBegin = 0;
+  size_t restSize = 0;
+
+  /**
+   * Number of bytes read from file
+   */
+  uint64_t readBytes = 0;
+
+  /**
+   * Number of lines of file that were not parsed, comments excluded, one
+   * counter for each part so that threads do not share it
+   */
+  std::vector<uint64_t> skipped;
+
+  /**
+   * Number of threads that parse chunk
+   */
+  unsigned parts = 1;
+
+  /**
+   * Reads next chunk of file, that ends at line boundary
+   *
+   * @param begin first byte of chunk
+   * @param end byte past the last line of chunk
+   *
+   * @return false if file has no more lines
+   */
+  bool nextChunk(const char *&begin, const char *&end);
+
+  /**
+   * Calls parse(part, begin, end) for each part of chunk on its own thread
+   */
+  template <typename Parse>
+  void parseParts(const char *begin, const char *end, Parse parse);
+
+public:
+  /**
+   * Constructor of EdgeListReader
+   *
+   * @param threads number of threads that parse chunk, 0 for number of
+   * hardware threads
+   * @param chunkBytes size of chunk of file that is read at once
+   */
+  explicit EdgeListReader(unsigned threads = 1,
+                          size_t chunkBytes = defaultChunkBytes);
+
+  /**
+   * Destructor of EdgeListReader
+   *
+   * Closes open file.
+   */
+  ~EdgeListReader() { close(); }
+
+  /// Disabling construction of EdgeListReader object using copy constructor
+  EdgeListReader(const EdgeListReader &rhs) = delete;
+
+  /// Disabling construction of EdgeListReader object using copy assignment
+  EdgeListReader &operator=(const EdgeListReader &rhs) = delete;
+
+  /**
+   * Opens file, file that is open is closed first
+   *
+   * @param path path of file
+   *
+   * @return true if file is opened
+   */
+  bool open(const std::string &path);
+
+  /**
+   * Closes open file
+   */
+  void close();
+
+  /**
+   * Returns number of threads that parse chunk
+   */
+  unsigned threads() const { return parts; }
+
+  /**
+   * Returns number of bytes read from file
+   */
+  uint64_t bytesRead() const { return readBytes; }
+
+  /**
+   * Returns number of lines that were not parsed, comments and empty lines
+   * excluded
+   */
+  uint64_t skippedLines() const;
+
+  /**
+   * Reads and parses next chunk of edge list
+   *
+   * @param edges edges of chunk, one vector for each thread, cleared first
+   *
+   * @return false if file has no more lines
+   */
+  bool nextEdges(std::vector<std::vector<std::pair<int, int>>> &edges);
+
+  /**
+   * Reads and parses next chunk of label file
+   *
+   * @param labels pairs < key of vertex, label > of chunk, one vector for each
+   * thread, cleared first. Labels point into chunk and are valid until next
+   * chunk is read
+   *
+   * @return false if file has no more lines
+   */
+  bool nextLabels(
+      std::vector<std::vector<std::pair<int, std::string_view>>> &labels);
+
+  /**
+   * Parses integer and moves position past it. Spaces and tabs before number
+   * are skipped
+   *
+   * @param position first byte, moved past the last digit
+   * @param end byte past the last byte of line
+   * @param value parsed number
+   *
+   * @return true if number is found and fits in int
+   */
+  static bool parseInt(const char *&position, const char *end, int &value);
+};
+
+inline EdgeListReader::EdgeListReader(unsigned threads, size_t chunkBytes) {
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  parts = threads;
+  skipped.assign(parts, 0);
+  buffer.resize(std::max<size_t>(chunkBytes, 64));
+}
+
+inline bool EdgeListReader::open(const std::string &path) {
+  close();
+  file = std::fopen(path.c_str(), "rb");
+  return file != nullptr;
+}
+
+inline void EdgeListReader::close() {
+  if (file != nullptr)
+    std::fclose(file);
+  file = nullptr;
+  restBegin = 0;
+  restSize = 0;
+  readBytes = 0;
+  skipped.assign(parts, 0);
+}
+
+inline uint64_t EdgeListReader::skippedLines() const {
+  uint64_t count = 0;
+  for (auto lines : skipped) {
+    count += lines;
+  }
+  return count;
+}
+
+inline bool EdgeListReader::nextChunk(const char *&begin, const char *&end) {
+  if (file == nullptr)
+    return false;
+  // rest of previous chunk, part of a line without newline, is moved to the
+  // start of buffer and file is read after it. Buffer grows only for lines
+  // longer than chunk
+  std::memmove(buffer.data(), buffer.data() + restBegin, restSize);
+  size_t size = restSize;
+  size_t scanned = restSize;
+  restBegin = 0;
+  restSize = 0;
+  while (true) {
+    size_t read =
+        std::fread(buffer.data() + size, 1, buffer.size() - size, file);
+    readBytes += read;
+    size += read;
+    if (size == 0)
+      return false;
+    bool last = size < buffer.size();
+    size_t lineEnd = size;
+    while (lineEnd > scanned && buffer[lineEnd - 1] != '\n') {
+      --lineEnd;
+    }
+    if (lineEnd > scanned || last) {
+      begin = buffer.data();
+      end = buffer.data() + (last ? size : lineEnd);
+      restBegin = static_cast<size_t>(end - begin);
+      restSize = size - restBegin;
+      return true;
+    }
+    scanned = size;
+    buffer.resize(buffer.size() * 2);
+  }
+}
+
+template <typename Parse>
+void EdgeListReader::parseParts(const char *begin, const char *end,
+                                Parse parse) {
+  // each part ends after the first newline at or after its share of chunk
+  std::vector<const char *> bounds(parts + 1, end);
+  bounds[0] = begin;
+  for (unsigned part = 1; part < parts; part++) {
+    const char *bound = std::max(
+        bounds[part - 1], begin + (end - begin) * uint64_t(part) / parts);
+    const char *newline = bound < end ? static_cast<const char *>(std::memchr(
+                                            bound, '\n', end - bound))
+                                      : nullptr;
+    bounds[part] = newline != nullptr ? newline + 1 : end;
+  }
+  parallelFor(parts, [&](unsigned part) {
+    const char *position = bounds[part];
+    while (position < bounds[part + 1]) {
+      const char *lineEnd = static_cast<const char *>(
+          std::memchr(position, '\n', bounds[part + 1] - position));
+      if (lineEnd == nullptr)
+        lineEnd = bounds[part + 1];
+      const char *first = position;
+      while (first < lineEnd && (*first == ' ' || *first == '\t')) {
+        ++first;
+      }
+      if (first < lineEnd && *first != '#' && *first != '%' && *first != '\r' &&
+          !parse(part, first, lineEnd))
+        ++skipped[part];
+      position = lineEnd + 1;
+    }
+  });
+}
+
+inline bool EdgeListReader::nextEdges(
+    std::vector<std::vector<std::pair<int, int>>> &edges) {
+  const char *begin = nullptr;
+  const char *end = nullptr;
+  edges.resize(parts);
+  for (auto &part : edges) {
+    part.clear();
+  }
+  if (!nextChunk(begin, end))
+    return false;
+  parseParts(begin, end,
+             [&edges](unsigned part, const char *position, const char *end) {
+               int start = 0;
+               int stop = 0;
+               if (!parseInt(position, end, start) ||
+                   !parseInt(position, end, stop))
+                 return false;
+               edges[part].emplace_back(start, stop);
+               return true;
+             });
+  return true;
+}
+
+inline bool EdgeListReader::nextLabels(
+    std::vector<std::vector<std::pair<int, std::string_view>>> &labels) {
+  const char *begin = nullptr;
+  const char *end = nullptr;
+  labels.resize(parts);
+  for (auto &part : labels) {
+    part.clear();
+  }
+  if (!nextChunk(begin, end))
+    return false;
+  parseParts(begin, end,
+             [&labels](unsigned part, const char *position, const char *end) {
+               int key = 0;
+               if (!parseInt(position, end, key))
+                 return false;
+               while (position < end) {
+                 while (position < end && (*position == ' ' ||
+                                           *position == '\t' ||
+                                           *position == '\r')) {
+                   ++position;
+                 }
+                 const char *first = position;
+                 while (position < end && *position != ' ' &&
+                        *position != '\t' && *position != '\r') {
+                   ++position;
+                 }
+                 if (position > first)
+                   labels[part].emplace_back(
+                       key, std::string_view(first, position - first));
+               }
+               return true;
+             });
+  return true;
+}
+
+inline bool EdgeListReader::parseInt(const char *&position, const char *end,
+                                     int &value) {
+  while (position < end && (*position == ' ' || *position == '\t')) {
+    ++position;
+  }
+  bool negative = position < end && *position == '-';
+  if (negative || (position < end && *position == '+'))
+    ++position;
+  const char *first = position;
+  int64_t number = 0;
+  // digits after the 11th can not fit in int, so number can not overflow
+  while (position < end && *position >= '0' && *position <= '9' &&
+         position - first < 11) {
+    number = number * 10 + (*position - '0');
+    ++position;
+  }
+  if (position == first || number > int64_t(INT32_MAX) + negative ||
+      (position < end && *position != ' ' && *position != '\t' &&
+       *position != '\r'))
+    return false;
+  value = static_cast<int>(negative ? -number : number);
+  return true;
+}
+
+} // namespace graph
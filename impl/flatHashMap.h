@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Implementation of the FlatHashMap class.
+ *
+ * FlatHashMap is an open addressing hash map with linear probing. All slots
+ * are stored in one contiguous vector, with capacity that is a power of two,
+ * so lookup of a key is a multiplicative hash, a shift and a scan of
+ * neighboring slots, without allocations and pointer hops of node based maps.
+ * Map grows to double capacity when it is 3/4 full. Erased elements do not
+ * leave tombstones, elements after them are shifted back into freed slot.
+ *
+ * @tparam Key type of keys
+ * @tparam Value type of values
+ */
+template <typename Key = int, typename Value = uint32_t> class FlatHashMap {
+private:
+  /**
+   * Slot of map, used is false for empty slots
+   */
+  struct Slot {
+    Key key;
+    Value value;
+    bool used = false;
+  };
+
+  /**
+   * Slots of map, size is power of two or zero
+   */
+  std::vector<Slot> slots;
+
+  /**
+   * Number of elements in map
+   */
+  size_t count = 0;
+
+  /**
+   * Number of bits of hash that are used as slot index
+   */
+  unsigned int bits = 0;
+
+  /**
+   * Returns index of first slot checked for key
+   */
+  size_t slotOf(const Key &key) const {
+    uint64_t hash = static_cast<uint64_t>(std::hash<Key>{}(key));
+    return static_cast<size_t>((hash * 0x9E3779B97F4A7C15ull) >> (64 - bits));
+  }
+
+  /**
+   * Moves all elements to slots vector with 2^newBits slots
+   */
+  void rehash(unsigned int newBits);
+
+public:
+  /**
+   * Finds value of key
+   *
+   * @param key key that is searched
+   * @param value value of key, set if key is found
+   *
+   * @return true if map contains key
+   */
+  bool find(const Key &key, Value &value) const;
+
+  /**
+   * Returns true if map contains key
+   *
+   * @param key key that is searched
+   */
+  bool contains(const Key &key) const {
+    Value value;
+    return find(key, value);
+  }
+
+  /**
+   * Inserts pair < key, value > in map, returns false if map already contains
+   * key, value of key is not changed then
+   *
+   * @param key key of element
+   * @param value value of element
+   */
+  bool insert(const Key &key, const Value &value);
+
+  /**
+   * Erases key from map, returns false if map does not contain key
+   *
+   * @param key key that is erased
+   */
+  bool erase(const Key &key);
+
+  /**
+   * Makes room for count elements, so that inserts do not rehash the map
+   *
+   * @param count expected number of elements
+   */
+  void reserve(size_t count);
+
+  /**
+   * Returns number of elements in map
+   */
+  size_t size() const { return count; }
+
+  /**
+   * Removes all elements from map
+   */
+  void clear();
+};
+
+template <typename Key, typename Value>
+bool FlatHashMap<Key, Value>::find(const Key &key, Value &value) const {
+  if (count == 0)
+    return false;
+  size_t mask = slots.size() - 1;
+  for (size_t i = slotOf(key);; i = (i + 1) & mask) {
+    const Slot &slot = slots[i];
+    if (!slot.used)
+      return false;
+    if (slot.key == key) {
+      value = slot.value;
+      return true;
+    }
+  }
+}
+
+template <typename Key, typename Value>
+bool FlatHashMap<Key, Value>::insert(const Key &key, const Value &value) {
+  if ((count + 1) * 4 > slots.size() * 3)
+    rehash(bits == 0 ? 4 : bits + 1);
+  size_t mask = slots.size() - 1;
+  for (size_t i = slotOf(key);; i = (i + 1) & mask) {
+    Slot &slot = slots[i];
+    if (!slot.used) {
+      slot.key = key;
+      slot.value = value;
+      slot.used = true;
+      ++count;
+      return true;
+    }
+    if (slot.key == key)
+      return false;
+  }
+}
+
+template <typename Key, typename Value>
+bool FlatHashMap<Key, Value>::erase(const Key &key) {
+  if (count == 0)
+    return false;
+  size_t mask = slots.size() - 1;
+  size_t hole = slotOf(key);
+  for (;; hole = (hole + 1) & mask) {
+    if (!slots[hole].used)
+      return false;
+    if (slots[hole].key == key)
+      break;
+  }
+  // element after hole is moved back into it, if hole is between its first
+  // slot and its slot, so that its lookup does not stop at empty slot
+  for (size_t i = (hole + 1) & mask; slots[i].used; i = (i + 1) & mask) {
+    if (((i - slotOf(slots[i].key)) & mask) >= ((i - hole) & mask)) {
+      slots[hole] = slots[i];
+      hole = i;
+    }
+  }
+  slots[hole].used = false;
+  --count;
+  return true;
+}
+
+template <typename Key, typename Value>
+void FlatHashMap<Key, Value>::reserve(size_t count) {
+  unsigned int newBits = bits == 0 ? 4 : bits;
+  while (count * 4 > (size_t(1) << newBits) * 3) {
+    ++newBits;
+  }
+  if (newBits != bits)
+    rehash(newBits);
+}
+
+template <typename Key, typename Value>
+void FlatHashMap<Key, Value>::rehash(unsigned int newBits) {
+  std::vector<Slot> oldSlots(size_t(1) << newBits);
+  oldSlots.swap(slots);
+  bits = newBits;
+  size_t mask = slots.size() - 1;
+  for (const auto &slot : oldSlots) {
+    if (!slot.used)
+      continue;
+    size_t i = slotOf(slot.key);
+    while (slots[i].used) {
+      i = (i + 1) & mask;
+    }
+    slots[i] = slot;
+  }
+}
+
+template <typename Key, typename Value> void FlatHashMap<Key, Value>::clear() {
+  slots.clear();
+  count = 0;
+  bits = 0;
+}
+
+} // namespace graph
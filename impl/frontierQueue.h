@@ -0,0 +1,87 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Implementation of the FrontierQueue class.
+ *
+ * FrontierQueue is a binary min heap of pairs < priority, vertex > used as the
+ * frontier of shortest path searches. Decrease-key is not supported, instead
+ * a vertex is pushed again with its new priority and outdated entries are
+ * skipped by the caller when popped (lazy deletion). Ties between equal
+ * priorities are broken by the smaller vertex, so vertices are settled in
+ * the same order as with a linear scan over a sorted list of vertices.
+ *
+ * Storage is kept between searches, clear() only resets the size.
+ *
+ * @tparam Vertex type of vertex stored in heap entries
+ */
+template <typename Vertex = int> class FrontierQueue {
+public:
+  /**
+   * Heap entry, pair of < priority, vertex >
+   */
+  using Entry = std::pair<int, Vertex>;
+
+private:
+  /**
+   * Heap entries, ordered with std::greater so the smallest entry is on top
+   */
+  std::vector<Entry> heap;
+
+public:
+  /**
+   * Inserts vertex with given priority in heap
+   *
+   * @param priority priority of vertex, usually distance from start vertex
+   * @param vertex vertex that is inserted
+   */
+  void push(int priority, Vertex vertex) {
+    heap.emplace_back(priority, vertex);
+    std::push_heap(heap.begin(), heap.end(), std::greater<Entry>());
+  }
+
+  /**
+   * Removes entry with the smallest priority from heap and returns it
+   */
+  Entry pop() {
+    std::pop_heap(heap.begin(), heap.end(), std::greater<Entry>());
+    Entry top = heap.back();
+    heap.pop_back();
+    return top;
+  }
+
+  /**
+   * Returns entry with the smallest priority, without removing it
+   */
+  const Entry &top() const { return heap.front(); }
+
+  /**
+   * Returns true if there are no entries in heap
+   */
+  bool empty() const { return heap.empty(); }
+
+  /**
+   * Returns number of entries in heap, outdated entries included
+   */
+  size_t size() const { return heap.size(); }
+
+  /**
+   * Removes all entries from heap, allocated storage is kept
+   */
+  void clear() { heap.clear(); }
+
+  /**
+   * Reserves storage for given number of entries
+   *
+   * @param capacity number of entries
+   */
+  void reserve(size_t capacity) { heap.reserve(capacity); }
+};
+
+} // namespace graph
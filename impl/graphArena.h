@@ -0,0 +1,220 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Implementation of the GraphArena class.
+ *
+ * GraphArena is a memory resource owned by one graph, used for LinkedVertices,
+ * adjacency vectors and per vertex arrays. Small blocks, up to 4096 bytes, are
+ * rounded up to size classes that are multiples of 16 bytes and carved from
+ * large slabs taken from upstream resource, freed blocks are kept in free list
+ * of their class and reused. Larger blocks go directly to upstream resource.
+ * All memory is given back to upstream at once, when arena is destroyed or
+ * released, so teardown of graph does not free every vertex separately.
+ *
+ * GraphArena is not thread safe, same as the graph that owns it.
+ */
+class GraphArena : public std::pmr::memory_resource {
+private:
+  /**
+   * Block in free list of a size class
+   */
+  struct FreeBlock {
+    FreeBlock *next;
+  };
+
+  /**
+   * Block taken from upstream resource
+   */
+  struct UpstreamBlock {
+    size_t bytes;
+    size_t alignment;
+  };
+
+  /// Difference of sizes of two neighboring size classes, and alignment of
+  /// blocks in slabs
+  static constexpr size_t granularity = 16;
+
+  /// Size of the largest size class
+  static constexpr size_t maxBlockSize = 4096;
+
+  /// Number of size classes
+  static constexpr size_t classes = maxBlockSize / granularity;
+
+  /// Size of the first slab, following slabs are twice as large, up to
+  /// maxSlabSize
+  static constexpr size_t minSlabSize = size_t(64) << 10;
+
+  /// Size of the largest slab
+  static constexpr size_t maxSlabSize = size_t(1) << 20;
+
+  static_assert(granularity % alignof(std::max_align_t) == 0,
+                "blocks in slabs have to be aligned for any type");
+
+  /**
+   * Resource that slabs and large blocks are taken from
+   */
+  std::pmr::memory_resource *upstream;
+
+  /**
+   * Free lists of blocks, one for each size class
+   */
+  FreeBlock *freeLists[classes] = {};
+
+  /**
+   * Slabs taken from upstream, pair of < slab, size of slab >
+   */
+  std::vector<std::pair<void *, size_t>> slabs;
+
+  /**
+   * Large blocks taken from upstream, that are not deallocated yet
+   */
+  std::unordered_map<void *, UpstreamBlock> largeBlocks;
+
+  /**
+   * Free part of current slab
+   */
+  char *current = nullptr;
+  char *currentEnd = nullptr;
+
+  /**
+   * Bytes taken from upstream and not given back
+   */
+  size_t reserved = 0;
+
+  /**
+   * Returns size class of block of given size
+   */
+  static size_t sizeClass(size_t bytes);
+
+  /**
+   * Takes new slab from upstream, at least large enough for one block
+   */
+  void grow(size_t bytes);
+
+protected:
+  void *do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override {
+    return this == &other;
+  }
+
+public:
+  /**
+   * Constructor of GraphArena
+   *
+   * @param upstream resource that slabs are taken from
+   */
+  explicit GraphArena(
+      std::pmr::memory_resource *upstream = std::pmr::get_default_resource())
+      : upstream(upstream) {}
+
+  /**
+   * Destructor of GraphArena, all memory is given back to upstream
+   */
+  ~GraphArena() override { release(); }
+
+  /// Disabling construction of GraphArena object using copy constructor
+  GraphArena(const GraphArena &rhs) = delete;
+
+  /// Disabling construction of GraphArena object using copy assignment
+  GraphArena &operator=(const GraphArena &rhs) = delete;
+
+  /**
+   * Gives all memory back to upstream, including blocks that are still in
+   * use. Objects allocated from arena must not be used after release.
+   */
+  void release();
+
+  /**
+   * Returns number of bytes taken from upstream
+   */
+  size_t bytesReserved() const { return reserved; }
+};
+
+inline size_t GraphArena::sizeClass(size_t bytes) {
+  return bytes == 0 ? 0 : (bytes - 1) / granularity;
+}
+
+inline void GraphArena::grow(size_t bytes) {
+  size_t size = slabs.empty() ? minSlabSize
+                              : std::min(slabs.back().second * 2, maxSlabSize);
+  if (size < bytes)
+    size = bytes;
+  void *slab = upstream->allocate(size, granularity);
+  slabs.emplace_back(slab, size);
+  reserved += size;
+  current = static_cast<char *>(slab);
+  currentEnd = current + size;
+}
+
+inline void *GraphArena::do_allocate(size_t bytes, size_t alignment) {
+  if (bytes > maxBlockSize || alignment > granularity) {
+    void *p = upstream->allocate(bytes, alignment);
+    largeBlocks.emplace(p, UpstreamBlock{bytes, alignment});
+    reserved += bytes;
+    return p;
+  }
+
+  size_t index = sizeClass(bytes);
+  if (freeLists[index] != nullptr) {
+    FreeBlock *block = freeLists[index];
+    freeLists[index] = block->next;
+    return block;
+  }
+
+  // slabs are aligned to granularity and all blocks are its multiples, so
+  // every block is aligned to granularity
+  size_t blockSize = (index + 1) * granularity;
+  if (static_cast<size_t>(currentEnd - current) < blockSize)
+    grow(blockSize);
+  void *p = current;
+  current += blockSize;
+  return p;
+}
+
+inline void GraphArena::do_deallocate(void *p, size_t bytes,
+                                      size_t alignment) {
+  if (bytes > maxBlockSize || alignment > granularity) {
+    auto it = largeBlocks.find(p);
+    if (it != largeBlocks.end()) {
+      upstream->deallocate(p, it->second.bytes, it->second.alignment);
+      reserved -= it->second.bytes;
+      largeBlocks.erase(it);
+    }
+    return;
+  }
+  size_t index = sizeClass(bytes);
+  auto block = static_cast<FreeBlock *>(p);
+  block->next = freeLists[index];
+  freeLists[index] = block;
+}
+
+inline void GraphArena::release() {
+  for (auto &block : largeBlocks) {
+    upstream->deallocate(block.first, block.second.bytes,
+                         block.second.alignment);
+  }
+  largeBlocks.clear();
+  for (auto &slab : slabs) {
+    upstream->deallocate(slab.first, slab.second, granularity);
+  }
+  slabs.clear();
+  for (auto &list : freeLists) {
+    list = nullptr;
+  }
+  current = nullptr;
+  currentEnd = nullptr;
+  reserved = 0;
+}
+
+} // namespace graph
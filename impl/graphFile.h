@@ -0,0 +1,377 @@
+#pragma once
+
+#include "connectivityIndex.h"
+#include "csrSnapshot.h"
+#include "labelDictionary.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Sections of graph file, in order in which they are written
+ */
+enum class GraphFileSection : uint32_t {
+  Keys,        ///< int32 key of each vertex, by dense index
+  Slots,       ///< open addressing table of < key, dense index > slots
+  Offsets,     ///< uint32 offset of edges of each vertex, vertices + 1
+  Neighbors,   ///< uint32 dense index of destination of each edge
+  InOffsets,   ///< uint32 offset of incoming edges of each vertex
+  InNeighbors, ///< uint32 dense index of source of each incoming edge
+  LabelBits,   ///< uint64 bits of label ids < 64 of each vertex
+  Overflow,    ///< sorted < dense index, label id > pairs of ids >= 64
+  NameOffsets, ///< uint32 offset of name of each label, labels + 1
+  Names,       ///< names of labels, without terminating zeros
+  Components,  ///< uint32 root of weakly connected component of each vertex
+  Payload,     ///< data of each vertex, if V is trivially copyable
+  Count        ///< number of sections
+};
+
+/**
+ * Header of graph file
+ *
+ * Graph file is written in byte order of machine that writes it, and is read
+ * by memory mapping it, so arrays of sections are used in place. Header is
+ * followed by sections, each aligned to 64 bytes and padded with zeros.
+ */
+struct GraphFileHeader {
+  char magic[8];          ///< "GRAPHCSR"
+  uint32_t version;       ///< version of format
+  uint32_t byteOrder;     ///< 0x01020304 in byte order of file
+  uint64_t vertexCount;   ///< number of vertices
+  uint64_t edgeCount;     ///< number of edges
+  uint64_t slotCount;     ///< number of slots of id table, power of two
+  uint64_t overflowCount; ///< number of pairs of Overflow section
+  uint64_t labelCount;    ///< number of labels
+  uint64_t nameBytes;     ///< size of Names section
+  uint64_t payloadSize;   ///< size of data of vertex, 0 if not stored
+  uint64_t fileSize;      ///< size of file
+  uint64_t sections[static_cast<size_t>(GraphFileSection::Count)]; ///< offsets
+  uint64_t dataChecksum;   ///< checksum of all bytes after header
+  uint64_t headerChecksum; ///< checksum of header before this field
+};
+
+/**
+ * Slot of id table of graph file, index is noSlotIndex for empty slots
+ */
+struct GraphFileSlot {
+  int32_t key;    ///< key of vertex
+  uint32_t index; ///< dense index of vertex
+};
+
+/**
+ * Pair of dense index of vertex and its label id, for label ids >= 64
+ */
+struct GraphFileLabel {
+  uint32_t vertex;  ///< dense index of vertex
+  uint32_t labelId; ///< label id
+};
+
+/// Magic bytes at start of graph file
+constexpr char graphFileMagic[8] = {'G', 'R', 'A', 'P', 'H', 'C', 'S', 'R'};
+
+/// Version of graph file format
+constexpr uint32_t graphFileVersion = 1;
+
+/// Alignment of sections of graph file
+constexpr uint64_t graphFileAlignment = 64;
+
+/// Dense index of empty slot of id table
+constexpr uint32_t noSlotIndex = 0xFFFFFFFFu;
+
+/**
+ * Returns first slot of key in id table with 2^bits slots
+ *
+ * @param key key of vertex
+ * @param bits number of bits of slot index
+ */
+inline uint64_t graphFileSlotOf(int32_t key, unsigned bits) {
+  uint64_t hash = static_cast<uint64_t>(static_cast<uint32_t>(key));
+  return bits == 0 ? 0 : (hash * 0x9E3779B97F4A7C15ull) >> (64 - bits);
+}
+
+/**
+ * Adds 64 bit words to checksum of graph file. Words are mixed one after
+ * another, so checksum depends on their order
+ *
+ * @param hash checksum of previous words
+ * @param words words that are added
+ * @param count number of words
+ */
+inline uint64_t graphFileChecksum(uint64_t hash, const uint64_t *words,
+                                  size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    hash ^= words[i] * 0x9E3779B97F4A7C15ull;
+    hash = ((hash << 31) | (hash >> 33)) * 0xC2B2AE3D27D4EB4Full;
+  }
+  return hash;
+}
+
+/**
+ * Implementation of the GraphFileWriter class.
+ *
+ * GraphFileWriter writes bytes of sections of graph file to std::FILE and
+ * adds them to checksum of data, in words of 8 bytes. Bytes that do not fill
+ * a word are kept until next write.
+ */
+class GraphFileWriter {
+private:
+  std::FILE *file;
+  uint64_t written = 0;
+  uint64_t hash = 0;
+  unsigned char pending[8] = {};
+  unsigned pendingBytes = 0;
+  bool failed = false;
+
+public:
+  /**
+   * Constructor of GraphFileWriter
+   *
+   * @param file file, positioned at start of data
+   * @param offset offset of start of data in file
+   */
+  GraphFileWriter(std::FILE *file, uint64_t offset)
+      : file(file), written(offset) {}
+
+  /**
+   * Writes bytes to file and adds them to checksum
+   *
+   * @param data bytes
+   * @param bytes number of bytes
+   */
+  void write(const void *data, size_t bytes);
+
+  /**
+   * Writes zeros until offset in file is multiple of graphFileAlignment
+   */
+  void align();
+
+  /**
+   * Returns offset in file of next byte
+   */
+  uint64_t offset() const { return written; }
+
+  /**
+   * Returns checksum of written bytes, offset is aligned
+   */
+  uint64_t checksum() const { return hash; }
+
+  /**
+   * Returns true if all writes succeeded
+   */
+  bool ok() const { return !failed; }
+};
+
+inline void GraphFileWriter::write(const void *data, size_t bytes) {
+  if (bytes == 0)
+    return;
+  if (std::fwrite(data, 1, bytes, file) != bytes)
+    failed = true;
+  written += bytes;
+  const unsigned char *begin = static_cast<const unsigned char *>(data);
+  // bytes that fill pending word first, then whole words in place
+  while (pendingBytes > 0 && bytes > 0) {
+    pending[pendingBytes++] = *begin++;
+    --bytes;
+    if (pendingBytes == 8) {
+      uint64_t word = 0;
+      std::memcpy(&word, pending, 8);
+      hash = graphFileChecksum(hash, &word, 1);
+      pendingBytes = 0;
+    }
+  }
+  if (pendingBytes > 0)
+    return;
+  uint64_t words[512];
+  while (bytes >= 8) {
+    size_t count = std::min<size_t>(bytes / 8, 512);
+    std::memcpy(words, begin, count * 8);
+    hash = graphFileChecksum(hash, words, count);
+    begin += count * 8;
+    bytes -= count * 8;
+  }
+  std::memcpy(pending, begin, bytes);
+  pendingBytes = static_cast<unsigned>(bytes);
+}
+
+inline void GraphFileWriter::align() {
+  static const unsigned char zeros[graphFileAlignment] = {};
+  uint64_t padding = (graphFileAlignment - written % graphFileAlignment) %
+                     graphFileAlignment;
+  write(zeros, static_cast<size_t>(padding));
+}
+
+/**
+ * Saves graph to binary graph file
+ *
+ * Arrays of CSR snapshot, id table, labels of vertices, dictionary of labels,
+ * components and, if V is trivially copyable, data of vertices are written
+ * as sections of file, that MappedGraph maps in memory and uses in place.
+ *
+ * @param path path of file, file is replaced
+ * @param csr CSR snapshot of graph
+ * @param labels labels of vertices, indexed by dense index
+ * @param dictionary dictionary of labels of graph
+ * @param connectivity weakly connected components of graph
+ * @param vertices ptrs to LinkedVertices, indexed by dense index
+ *
+ * @return true if file is written
+ */
+template <typename V>
+bool saveGraphFile(const std::string &path, const CsrSnapshot<V> &csr,
+                   const std::pmr::vector<LabelSet> &labels,
+                   const LabelDictionary &dictionary,
+                   const ConnectivityIndex &connectivity,
+                   const std::pmr::vector<LinkedVertices<V> *> &vertices) {
+  std::FILE *file = std::fopen(path.c_str(), "wb");
+  if (file == nullptr)
+    return false;
+
+  GraphFileHeader header{};
+  std::memcpy(header.magic, graphFileMagic, sizeof(header.magic));
+  header.version = graphFileVersion;
+  header.byteOrder = 0x01020304u;
+  header.vertexCount = csr.vertexCount();
+  header.edgeCount = csr.edgeCount();
+  header.labelCount = dictionary.size();
+  header.payloadSize = std::is_trivially_copyable_v<V> ? sizeof(V) : 0;
+
+  // id table is at most half full, so probes are short
+  unsigned bits = 0;
+  while ((uint64_t(1) << bits) < 2 * header.vertexCount) {
+    ++bits;
+  }
+  header.slotCount = header.vertexCount == 0 ? 0 : uint64_t(1) << bits;
+
+  // header is written again when offsets of sections and checksums are known
+  std::fwrite(&header, sizeof(header), 1, file);
+  GraphFileWriter writer(file, sizeof(header));
+  writer.align();
+  auto begin = [&](GraphFileSection section) {
+    writer.align();
+    header.sections[static_cast<size_t>(section)] = writer.offset();
+  };
+
+  // arrays are written in blocks, so that they are not copied whole
+  std::vector<uint32_t> block;
+  auto flush = [&]() {
+    writer.write(block.data(), block.size() * sizeof(uint32_t));
+    block.clear();
+  };
+  auto push = [&](uint32_t value) {
+    block.push_back(value);
+    if (block.size() == 4096)
+      flush();
+  };
+  uint32_t n = static_cast<uint32_t>(csr.vertexCount());
+
+  begin(GraphFileSection::Keys);
+  for (uint32_t i = 0; i < n; ++i) {
+    push(static_cast<uint32_t>(csr.keyOf(i)));
+  }
+  flush();
+
+  begin(GraphFileSection::Slots);
+  std::vector<GraphFileSlot> slots(header.slotCount,
+                                   GraphFileSlot{0, noSlotIndex});
+  for (uint32_t i = 0; i < n; ++i) {
+    // removed vertex keeps its key in keys, but only vertex that has the key
+    // now is found by it
+    uint32_t index = 0;
+    if (!csr.findIndex(csr.keyOf(i), index) || index != i)
+      continue;
+    uint64_t slot = graphFileSlotOf(csr.keyOf(i), bits);
+    while (slots[slot].index != noSlotIndex) {
+      slot = (slot + 1) & (header.slotCount - 1);
+    }
+    slots[slot] = GraphFileSlot{csr.keyOf(i), i};
+  }
+  writer.write(slots.data(), slots.size() * sizeof(GraphFileSlot));
+  std::vector<GraphFileSlot>().swap(slots);
+
+  // offsets are written relative to first edge, edgesEnd(i) is the offset of
+  // edges of vertex i + 1
+  begin(GraphFileSection::Offsets);
+  push(0);
+  for (uint32_t i = 0; i < n; ++i) {
+    push(static_cast<uint32_t>(csr.edgesEnd(i) - csr.edgesBegin(0)));
+  }
+  flush();
+  begin(GraphFileSection::Neighbors);
+  writer.write(csr.edgesBegin(0), csr.edgeCount() * sizeof(uint32_t));
+
+  begin(GraphFileSection::InOffsets);
+  push(0);
+  for (uint32_t i = 0; i < n; ++i) {
+    push(static_cast<uint32_t>(csr.incomingEnd(i) - csr.incomingBegin(0)));
+  }
+  flush();
+  begin(GraphFileSection::InNeighbors);
+  writer.write(csr.incomingBegin(0), csr.edgeCount() * sizeof(uint32_t));
+
+  begin(GraphFileSection::LabelBits);
+  std::vector<GraphFileLabel> overflow;
+  for (uint32_t i = 0; i < n; ++i) {
+    uint64_t inlineBits = labels[i].inlineBits();
+    writer.write(&inlineBits, sizeof(inlineBits));
+    if (labels[i].hasOverflow()) {
+      for (auto labelId : labels[i].ids()) {
+        if (labelId >= LabelSet::inlineLabels)
+          overflow.push_back(GraphFileLabel{i, labelId});
+      }
+    }
+  }
+  std::sort(overflow.begin(), overflow.end(),
+            [](const GraphFileLabel &a, const GraphFileLabel &b) {
+              return a.vertex != b.vertex ? a.vertex < b.vertex
+                                          : a.labelId < b.labelId;
+            });
+  header.overflowCount = overflow.size();
+  begin(GraphFileSection::Overflow);
+  writer.write(overflow.data(), overflow.size() * sizeof(GraphFileLabel));
+
+  begin(GraphFileSection::NameOffsets);
+  uint32_t nameOffset = 0;
+  push(0);
+  for (uint32_t id = 0; id < dictionary.size(); ++id) {
+    nameOffset += static_cast<uint32_t>(dictionary.name(id).size());
+    push(nameOffset);
+  }
+  flush();
+  header.nameBytes = nameOffset;
+  begin(GraphFileSection::Names);
+  for (uint32_t id = 0; id < dictionary.size(); ++id) {
+    writer.write(dictionary.name(id).data(), dictionary.name(id).size());
+  }
+
+  begin(GraphFileSection::Components);
+  for (uint32_t i = 0; i < n; ++i) {
+    push(connectivity.component(i));
+  }
+  flush();
+
+  begin(GraphFileSection::Payload);
+  if constexpr (std::is_trivially_copyable_v<V>) {
+    for (uint32_t i = 0; i < n; ++i) {
+      writer.write(&vertices[i]->getHead()->data, sizeof(V));
+    }
+  }
+  writer.align();
+
+  header.fileSize = writer.offset();
+  header.dataChecksum = writer.checksum();
+  uint64_t words[offsetof(GraphFileHeader, headerChecksum) / 8];
+  std::memcpy(words, &header, sizeof(words));
+  header.headerChecksum = graphFileChecksum(0, words, sizeof(words) / 8);
+
+  bool ok = writer.ok() && std::fseek(file, 0, SEEK_SET) == 0 &&
+            std::fwrite(&header, sizeof(header), 1, file) == 1;
+  return std::fclose(file) == 0 && ok;
+}
+
+} // namespace graph
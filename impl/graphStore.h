@@ -0,0 +1,378 @@
+#pragma once
+
+#include "flatHashMap.h"
+#include "labelPolicies.h"
+#include "storagePolicies.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Implementation of the GraphStore class.
+ *
+ * GraphStore is graph built from policies chosen at compile time. Storage
+ * policy keeps edges: LinkedStorage, vector of edges for each vertex,
+ * CsrStorage, compressed sparse row arrays, or CompressedStorage, sorted
+ * edges as varint differences of dense indices. Label policy keeps labels of
+ * vertices: NoLabels, BitmaskLabels, ids 0..63 in one word, or StringLabels,
+ * strings interned in LabelDictionary. Id is integer type of keys of
+ * vertices, e.g. int or int64_t.
+ *
+ * Keys are mapped to dense indices given in order of insertion, as in
+ * GraphStoreLinked. Shortest path is found with level synchronous breadth
+ * first search, all edges have the same weight. Expansion of edge has no
+ * branches: visited bit, previous vertex and next frontier are written with
+ * masks of the check of vertex, so with NoLabels, or StaticLabelMask known at
+ * compile time, check of labels is folded to constant and loop over edges is
+ * only loads, ANDs and stores.
+ *
+ * Graph is changed by one thread at a time. Searches do not change graph, each
+ * thread searches with its own search state, and storage that collects new
+ * edges is prepared by the first search after graph was changed.
+ *
+ * @tparam V type of data stored in graph vertices
+ * @tparam Storage storage policy of edges
+ * @tparam Labels label policy of vertices
+ * @tparam Id integer type of keys of vertices
+ */
+template <typename V, typename Storage = LinkedStorage,
+          typename Labels = StringLabels, typename Id = int>
+class GraphStore {
+  static_assert(std::is_integral_v<Id>, "keys of vertices are integers");
+
+public:
+  /// Label of vertex of label policy
+  using Label = typename Labels::Label;
+
+private:
+  /**
+   * State of search of one thread, reused between searches
+   */
+  struct SearchContext {
+    std::vector<uint64_t> visited;  ///< bits of visited vertices
+    std::vector<uint32_t> previous; ///< previous vertex on path
+    std::vector<uint32_t> level;    ///< vertices of current level
+    std::vector<uint32_t> next;     ///< vertices of next level
+  };
+
+  /**
+   * Returns search state of calling thread
+   */
+  static SearchContext &searchContext() {
+    static thread_local SearchContext context;
+    return context;
+  }
+
+  /**
+   * Maps key of vertex to its dense index
+   */
+  FlatHashMap<Id, uint32_t> ids;
+
+  /**
+   * Keys and data of vertices, indexed by dense index
+   */
+  std::vector<Id> keys;
+  std::vector<V> infos;
+
+  /**
+   * Edges of graph, prepared by the first search after graph was changed, so
+   * it is guarded by storageMutex
+   */
+  mutable Storage storage;
+
+  /**
+   * Labels of vertices
+   */
+  Labels labels;
+
+  /**
+   * Guards prepare of storage by concurrent searches
+   */
+  mutable std::mutex storageMutex;
+
+  /**
+   * Set to true when vertices or edges are inserted after storage was
+   * prepared
+   */
+  mutable std::atomic<bool> storageStale{false};
+
+  /**
+   * Returns storage of edges, storage is prepared first if graph was changed
+   * after the last prepare. Concurrent searches prepare it only once
+   */
+  const Storage &currentStorage() const;
+
+  /**
+   * Searches shortest path from start vertex to stop vertex, over vertices
+   * that match mask
+   *
+   * @param start key id of start Vertex
+   * @param stop key id of stop Vertex
+   * @param mask compiled labels, or StaticLabelMask
+   * @param path keys of vertices on path, from start to stop
+   *
+   * @return true if path is found
+   */
+  template <typename Mask>
+  bool search(Id start, Id stop, const Mask &mask, std::vector<Id> &path) const;
+
+public:
+  /**
+   * Inserts vertex, returns false if graph already has vertex with key
+   *
+   * @param key key id of Vertex
+   * @param info Vertex info
+   */
+  bool addVertex(Id key, const V &info);
+
+  /**
+   * Inserts edge from start vertex to stop vertex, returns false if graph
+   * does not have one of them
+   *
+   * @param start key id of start Vertex
+   * @param stop key id of stop Vertex
+   */
+  bool createEdge(Id start, Id stop);
+
+  /**
+   * Adds label to vertex, returns false if graph does not have vertex or
+   * label policy rejects label
+   *
+   * @param key key id of Vertex
+   * @param label label of Vertex
+   */
+  bool addLabel(Id key, const Label &label);
+
+  /**
+   * Removes label from vertex, returns true if vertex had it
+   *
+   * @param key key id of Vertex
+   * @param label label of Vertex
+   */
+  bool removeLabel(Id key, const Label &label);
+
+  /**
+   * Returns true if vertex has label
+   *
+   * @param key key id of Vertex
+   * @param label label of Vertex
+   */
+  bool hasLabel(Id key, const Label &label) const;
+
+  /**
+   * Returns pointer to data of vertex, nullptr if graph does not have vertex
+   *
+   * @param key key id of Vertex
+   */
+  const V *vertexInfo(Id key) const;
+
+  /**
+   * Returns number of vertices
+   */
+  size_t vertexCount() const { return keys.size(); }
+
+  /**
+   * Returns number of edges
+   */
+  size_t edgeCount() const { return currentStorage().edgeCount(); }
+
+  /**
+   * Returns storage of edges, prepared for searches
+   */
+  const Storage &edges() const { return currentStorage(); }
+
+  /**
+   * Searches shortest path from start vertex to stop vertex, labels of
+   * vertices are not checked
+   *
+   * @param start key id of start Vertex
+   * @param stop key id of stop Vertex
+   * @param path keys of vertices on path, from start to stop
+   *
+   * @return true if path is found
+   */
+  bool shortestPath(Id start, Id stop, std::vector<Id> &path) const {
+    return search(start, stop, StaticLabelMask<0>(), path);
+  }
+
+  /**
+   * Searches shortest path from start vertex to stop vertex, over vertices
+   * that have all labels. Start vertex is not checked
+   *
+   * @param start key id of start Vertex
+   * @param stop key id of stop Vertex
+   * @param label labels that vertices on path have
+   * @param path keys of vertices on path, from start to stop
+   *
+   * @return true if path is found
+   */
+  bool shortestPath(Id start, Id stop, const std::vector<Label> &label,
+                    std::vector<Id> &path) const;
+
+  /**
+   * Searches shortest path from start vertex to stop vertex, over vertices
+   * that have all labels of mask known at compile time. Start vertex is not
+   * checked
+   *
+   * @param start key id of start Vertex
+   * @param stop key id of stop Vertex
+   * @param mask label ids of BitmaskLabels, as StaticLabelMask
+   * @param path keys of vertices on path, from start to stop
+   *
+   * @return true if path is found
+   */
+  template <uint64_t Bits>
+  bool shortestPath(Id start, Id stop, StaticLabelMask<Bits> mask,
+                    std::vector<Id> &path) const {
+    return search(start, stop, mask, path);
+  }
+};
+
+template <typename V, typename Storage, typename Labels, typename Id>
+bool GraphStore<V, Storage, Labels, Id>::addVertex(Id key, const V &info) {
+  auto index = static_cast<uint32_t>(keys.size());
+  if (!ids.insert(key, index))
+    return false;
+  keys.push_back(key);
+  infos.push_back(info);
+  storage.addVertex();
+  labels.addVertex();
+  storageStale.store(true, std::memory_order_release);
+  return true;
+}
+
+template <typename V, typename Storage, typename Labels, typename Id>
+bool GraphStore<V, Storage, Labels, Id>::createEdge(Id start, Id stop) {
+  uint32_t startIndex = 0;
+  uint32_t stopIndex = 0;
+  if (!ids.find(start, startIndex) || !ids.find(stop, stopIndex))
+    return false;
+  storage.addEdge(startIndex, stopIndex);
+  storageStale.store(true, std::memory_order_release);
+  return true;
+}
+
+template <typename V, typename Storage, typename Labels, typename Id>
+bool GraphStore<V, Storage, Labels, Id>::addLabel(Id key, const Label &label) {
+  static_assert(Labels::enabled, "vertices of graph have no labels");
+  uint32_t index = 0;
+  return ids.find(key, index) && labels.add(index, label);
+}
+
+template <typename V, typename Storage, typename Labels, typename Id>
+bool GraphStore<V, Storage, Labels, Id>::removeLabel(Id key,
+                                                     const Label &label) {
+  static_assert(Labels::enabled, "vertices of graph have no labels");
+  uint32_t index = 0;
+  return ids.find(key, index) && labels.remove(index, label);
+}
+
+template <typename V, typename Storage, typename Labels, typename Id>
+bool GraphStore<V, Storage, Labels, Id>::hasLabel(Id key,
+                                                  const Label &label) const {
+  static_assert(Labels::enabled, "vertices of graph have no labels");
+  uint32_t index = 0;
+  return ids.find(key, index) && labels.contains(index, label);
+}
+
+template <typename V, typename Storage, typename Labels, typename Id>
+const V *GraphStore<V, Storage, Labels, Id>::vertexInfo(Id key) const {
+  uint32_t index = 0;
+  if (!ids.find(key, index))
+    return nullptr;
+  return &infos[index];
+}
+
+template <typename V, typename Storage, typename Labels, typename Id>
+bool GraphStore<V, Storage, Labels, Id>::shortestPath(
+    Id start, Id stop, const std::vector<Label> &label,
+    std::vector<Id> &path) const {
+  typename Labels::Mask mask{};
+  path.clear();
+  if (!labels.compile(label, mask))
+    return false;
+  if constexpr (std::is_same_v<typename Labels::Mask, StaticLabelMask<0>>)
+    return search(start, stop, StaticLabelMask<0>(), path);
+  else if (label.empty())
+    return search(start, stop, StaticLabelMask<0>(), path);
+  else
+    return search(start, stop, mask, path);
+}
+
+template <typename V, typename Storage, typename Labels, typename Id>
+template <typename Mask>
+bool GraphStore<V, Storage, Labels, Id>::search(Id start, Id stop,
+                                                const Mask &mask,
+                                                std::vector<Id> &path) const {
+  path.clear();
+  uint32_t startIndex = 0;
+  uint32_t stopIndex = 0;
+  if (!ids.find(start, startIndex) || !ids.find(stop, stopIndex) ||
+      startIndex == stopIndex || !labels.matches(stopIndex, mask))
+    return false;
+  const Storage &edges = currentStorage();
+  SearchContext &context = searchContext();
+  size_t count = keys.size();
+  context.visited.assign((count + 63) / 64, 0);
+  if (context.previous.size() < count) {
+    context.previous.resize(count);
+    // each vertex is taken once, and the last expansion writes one slot past
+    // taken vertices
+    context.next.resize(count + 1);
+    context.level.resize(count + 1);
+  }
+  uint64_t *visited = context.visited.data();
+  uint32_t *previous = context.previous.data();
+  visited[startIndex >> 6] |= uint64_t(1) << (startIndex & 63);
+  context.level[0] = startIndex;
+  size_t levelSize = 1;
+  const uint64_t stopBit = uint64_t(1) << (stopIndex & 63);
+  while (levelSize != 0 && (visited[stopIndex >> 6] & stopBit) == 0) {
+    uint32_t *next = context.next.data();
+    size_t nextSize = 0;
+    for (size_t i = 0; i < levelSize; ++i) {
+      uint32_t u = context.level[i];
+      edges.forEachEdge(u, [&](uint32_t v) {
+        uint64_t &word = visited[v >> 6];
+        uint64_t bit = uint64_t(1) << (v & 63);
+        bool take = ((word & bit) == 0) & labels.matches(v, mask);
+        word |= bit & (0 - uint64_t(take));
+        previous[v] = take ? u : previous[v];
+        next[nextSize] = v;
+        nextSize += take;
+      });
+    }
+    context.level.swap(context.next);
+    levelSize = nextSize;
+  }
+  if ((visited[stopIndex >> 6] & stopBit) == 0)
+    return false;
+  for (uint32_t index = stopIndex; index != startIndex;
+       index = previous[index]) {
+    path.push_back(keys[index]);
+  }
+  path.push_back(start);
+  std::reverse(path.begin(), path.end());
+  return true;
+}
+
+template <typename V, typename Storage, typename Labels, typename Id>
+const Storage &GraphStore<V, Storage, Labels, Id>::currentStorage() const {
+  // storage is changed only while it is stale, so searches that find it
+  // prepared use it without lock
+  if (storageStale.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(storageMutex);
+    if (storageStale.load(std::memory_order_relaxed)) {
+      storage.prepare();
+      storageStale.store(false, std::memory_order_release);
+    }
+  }
+  return storage;
+}
+
+} // namespace graph
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "linkedListOfVertices.h"
+#include "mappedGraph.h"
 
 namespace graph {
 
@@ -11,13 +12,35 @@ namespace graph {
  * pairs of vertices. Class GraphStoreLinked is used as an interface for
  * LinkedListOfVertices class where graph methods are implemented.
  *
+ * Graph allocates vertices, edges and arrays of vertices from its own memory
+ * resource of type Resource. Default GraphArena frees all of them at once when
+ * graph is destroyed, any other std::pmr::memory_resource that is default
+ * constructible, or constructible from upstream memory resource, can be used
+ * instead, e.g. std::pmr::unsynchronized_pool_resource.
+ *
+ * Graph is changed by one thread at a time, or by many threads that add
+ * vertices, edges and labels between beginIngest() and endIngest(). Readers
+ * that run while graph is changed search published versions of graph, taken
+ * with pin().
+ *
+ * @tparam V type of data stored in graph vertices
+ * @tparam Resource memory resource of graph
  */
-template <typename V> class GraphStoreLinked {
+template <typename V, typename Resource = GraphArena>
+class GraphStoreLinked {
 private:
   /**
    * Object of LinkedListOfVertices<V> class
    */
-  LinkedListOfVertices<V> linkedListOfVertices;
+  LinkedListOfVertices<V, Resource> linkedListOfVertices;
+
+  /**
+   * Enables variadic shortestPath functions only for string arguments, so that
+   * calls with vector of labels or query context are not taken by them
+   */
+  template <typename... Args>
+  using LabelArguments = std::enable_if_t<
+      (std::is_convertible_v<const Args &, std::string> && ...)>;
 
 public:
   /**
@@ -29,6 +52,15 @@ public:
    */
   GraphStoreLinked();
 
+  /**
+   * Constructor of Graph Store
+   *
+   * Memory resource of graph takes memory from upstream resource.
+   *
+   * @param upstream upstream memory resource
+   */
+  explicit GraphStoreLinked(std::pmr::memory_resource *upstream);
+
   /**
    * Destructor  of Graph Store
    *
@@ -105,6 +137,207 @@ public:
    */
   bool createEdge(int start, int stop);
 
+  /**
+   * Remove Vertex from Graph
+   *
+   * Calls for LinkedListOfVertices method bool removeVertex(int key). Vertex
+   * is marked as removed, its edges are skipped by searches and removed later
+   * by compaction.
+   *
+   * @param key id of Vertex
+   *
+   * @return true if LinkedListOfVertices method removeVertex returns true
+   */
+  bool removeVertex(int key);
+
+  /**
+   * Remove Edge from Graph
+   *
+   * Calls for LinkedListOfVertices method bool removeEdge(int start, int
+   * stop). Edge and its parallel edges are marked as removed in place, time
+   * is linear in degrees of both vertices.
+   *
+   * @param start id of source Vertex
+   * @param stop id of destination Vertex
+   *
+   * @return true if LinkedListOfVertices method removeEdge returns true
+   */
+  bool removeEdge(int start, int stop);
+
+  /**
+   * Compacts edges of Graph
+   *
+   * Calls for LinkedListOfVertices method size_t compact(). Removed edges,
+   * edges of removed vertices and parallel edges are removed from vectors of
+   * edges of all vertices, and components are built again from live edges.
+   *
+   * @return number of removed edges and incoming edges
+   */
+  size_t compact();
+
+  /**
+   * Sets share of removed edges after which compaction starts
+   *
+   * Calls for LinkedListOfVertices method void setCompactionThreshold(double
+   * threshold).
+   *
+   * @param threshold share of removed edges, 0 to compact only with compact()
+   */
+  void setCompactionThreshold(double threshold);
+
+  /**
+   * Add Vertices to Graph
+   *
+   * Calls for LinkedListOfVertices method size_t insertVertices(const Range
+   * &vertices). Storage is reserved once for all vertices, vertices with keys
+   * that are already inserted are skipped.
+   *
+   * @tparam vertices range of pairs < key id of Vertex, Vertex info >
+   *
+   * @return number of inserted vertices
+   */
+  template <typename Range> size_t addVertices(const Range &vertices) {
+    return linkedListOfVertices.insertVertices(vertices);
+  }
+
+  /**
+   * Create Edges in Graph
+   *
+   * Calls for LinkedListOfVertices method size_t insertEdges(const Range
+   * &edges, unsigned threads). Edges are sorted by source Vertex, duplicates
+   * are removed and edges of each Vertex are appended in one pass. Edges with
+   * Vertices that are not inserted are skipped.
+   *
+   * @tparam edges range of pairs < id of source Vertex, id of destination
+   * Vertex >
+   * @param threads number of threads, 0 for number of hardware threads
+   *
+   * @return number of inserted edges, 0 while concurrent ingest runs
+   */
+  template <typename Range>
+  size_t addEdges(const Range &edges, unsigned threads = 1) {
+    return linkedListOfVertices.insertEdges(edges, threads);
+  }
+
+  /**
+   * Starts concurrent ingest
+   *
+   * Calls for LinkedListOfVertices method void beginIngest(). Until
+   * endIngest() is called, addVertex, createEdge and addLabel can be called by
+   * many threads at the same time, and return the same results as they do
+   * when graph is changed by one thread. Added vertices, edges and labels are
+   * inserted in graph by endIngest(). addVertices adds vertices to ingest too,
+   * addEdges, removeVertex, removeEdge and removeLabel are rejected.
+   */
+  void beginIngest();
+
+  /**
+   * Ends concurrent ingest
+   *
+   * Calls for LinkedListOfVertices method size_t endIngest(unsigned threads).
+   * Vertices, edges and labels added since beginIngest() are inserted in
+   * graph, edges in bulk as with addEdges. Edge created more than once is
+   * inserted as parallel edge, as createEdge does without ingest.
+   *
+   * @param threads number of threads of addEdges, 0 for number of hardware
+   * threads
+   *
+   * @return number of inserted edges, parallel edges included
+   */
+  size_t endIngest(unsigned threads = 0);
+
+  /**
+   * Loads edges of text edge list file in Graph
+   *
+   * Calls for LinkedListOfVertices method size_t loadEdgeList(const
+   * std::string &path, const V &info, unsigned threads, size_t chunkBytes).
+   * File has one edge per line, "start stop", and is read and parsed in
+   * chunks, vertices that are not in graph are inserted with info.
+   *
+   * @param path path of file
+   * @param info Vertex info of inserted vertices
+   * @param threads number of threads, 0 for number of hardware threads
+   * @param chunkBytes size of chunk of file that is read at once
+   *
+   * @return number of inserted edges
+   */
+  size_t loadEdgeList(const std::string &path, const V &info = V(),
+                      unsigned threads = 1,
+                      size_t chunkBytes = EdgeListReader::defaultChunkBytes);
+
+  /**
+   * Loads labels of text label file in Graph
+   *
+   * Calls for LinkedListOfVertices method size_t loadLabels(const std::string
+   * &path, unsigned threads, size_t chunkBytes). File has key of vertex and
+   * its labels on each line, "key label label ...".
+   *
+   * @param path path of file
+   * @param threads number of threads that parse file, 0 for number of
+   * hardware threads
+   * @param chunkBytes size of chunk of file that is read at once
+   *
+   * @return number of labels added to vertices
+   */
+  size_t loadLabels(const std::string &path, unsigned threads = 1,
+                    size_t chunkBytes = EdgeListReader::defaultChunkBytes);
+
+  /**
+   * Opens write-ahead mutation log of Graph
+   *
+   * Calls for LinkedListOfVertices method bool openLog(const std::string
+   * &path). Checkpoint and log at path are replayed into Graph, then new
+   * vertices, edges and labels are appended to log and committed in groups.
+   *
+   * @param path path of log file, checkpoint is kept in path.checkpoint
+   *
+   * @return false if log is already open, or files can not be read or written
+   */
+  bool openLog(const std::string &path);
+
+  /**
+   * Calls for LinkedListOfVertices method void closeLog(), log is committed
+   * and Graph is not logged any more.
+   */
+  void closeLog();
+
+  /**
+   * Commits records of mutation log that are not committed yet
+   *
+   * Calls for LinkedListOfVertices method bool commitLog().
+   *
+   * @return true if log is open and records are written and synced
+   */
+  bool commitLog();
+
+  /**
+   * Writes checkpoint of Graph and starts empty mutation log
+   *
+   * Calls for LinkedListOfVertices method bool checkpointLog().
+   *
+   * @return true if log is open and checkpoint is written
+   */
+  bool checkpointLog();
+
+  /**
+   * Sets size of group of records of mutation log
+   *
+   * Calls for LinkedListOfVertices method void setLogGroupBytes(size_t bytes).
+   *
+   * @param bytes size of group, 0 to commit each mutation on its own
+   */
+  void setLogGroupBytes(size_t bytes);
+
+  /**
+   * Sets size of mutation log after which checkpoint is written on its own
+   *
+   * Calls for LinkedListOfVertices method void setCheckpointBytes(uint64_t
+   * bytes).
+   *
+   * @param bytes size of log, 0 for checkpoints only with checkpointLog()
+   */
+  void setCheckpointBytes(uint64_t bytes);
+
   /**
    * Remove Label from Vertex
    *
@@ -143,16 +376,66 @@ public:
    *
    * Calls for LinkedListOfVertices method bool findShortestPath(int key,
    * const std::vector<std::string> &label). If findShortestPath returns
-   * true, this is true then.
+   * true, this is true then. Graph is not changed, so many threads can search
+   * at the same time, while no thread changes graph.
+   *
+   * @tparam start key id of source Vertex
+   * @tparam stop key id of destination Vertex
+   * @param label label of Vertices found on shortest path
+   * @param mode search mode, Forward, Bidirectional, Landmarks or
+   * ContractionHierarchy
+   *
+   * @return true if LinkedListOfVertices method findShortestPath returns
+   * true
+   */
+  bool shortestPath(int start, int stop, const std::vector<std::string> &label,
+                    SearchMode mode = SearchMode::Forward) const;
+
+  /**
+   * Finds shortest path between two Vertices in Graph, with given query
+   * context
+   *
+   * Calls for LinkedListOfVertices method bool findShortestPath(int start,
+   * int stop, const std::vector<std::string> &label, QueryContext<V>
+   * &context, SearchMode mode). Keys of vertices on found path, without stop
+   * Vertex, are left in context.path().
+   *
+   * @tparam start key id of source Vertex
+   * @tparam stop key id of destination Vertex
+   * @param label label of Vertices found on shortest path
+   * @param context state of search, used by one thread at a time
+   * @param mode search mode, Forward, Bidirectional, Landmarks or
+   * ContractionHierarchy
+   *
+   * @return true if LinkedListOfVertices method findShortestPath returns
+   * true
+   */
+  bool shortestPath(int start, int stop, const std::vector<std::string> &label,
+                    QueryContext<V> &context,
+                    SearchMode mode = SearchMode::Forward) const;
+
+  /**
+   * Finds shortest path between two Vertices in Graph, into given result
+   *
+   * Calls for LinkedListOfVertices method bool findShortestPath(int start,
+   * int stop, const std::vector<std::string> &label, PathResult &result,
+   * SearchMode mode). Path, start and stop Vertex included, and its distance
+   * are written to result, result can be reused by many searches. Path can be
+   * printed with operator<<.
    *
    * @tparam start key id of source Vertex
    * @tparam stop key id of destination Vertex
    * @param label label of Vertices found on shortest path
+   * @param result found path
+   * @param mode search mode, Forward, Bidirectional, Landmarks or
+   * ContractionHierarchy
    *
    * @return true if LinkedListOfVertices method findShortestPath returns
    * true
    */
-  bool shortestPath(int start, int stop, std::vector<std::string> &label);
+  bool shortestPath(int start, int stop, const std::vector<std::string> &label,
+                    PathResult &result,
+                    SearchMode mode = SearchMode::Forward) const;
 
   /**
    * Variadic template function Finds shortest path between two Vertices in
@@ -169,13 +452,175 @@ public:
    * @return return value of shortestPath(int start, int stopV,
                      std::vector<std::string> &label)
    */
-  template <typename... Args>
-  bool shortestPath(int start, int stop, Args &... args) {
+  template <typename... Args, typename = LabelArguments<Args...>>
+  bool shortestPath(int start, int stop, Args &... args) const {
     std::vector<std::string> labelsToCheckOnPath;
     (labelsToCheckOnPath.push_back(args), ...);
     return shortestPath(start, stop, labelsToCheckOnPath);
   }
 
+  /**
+   * Variadic template function Finds shortest path between two Vertices in
+   Graph, using given search mode
+   *
+   * Saves all string arguments into string vector and calls
+   shortestPath(int start, int stop, std::vector<std::string> &label,
+   SearchMode mode)
+   *
+   * @tparam start key id of source Vertex
+   * @tparam stop key id of destination Vertex
+   * @param mode search mode, Forward, Bidirectional, Landmarks or
+   * ContractionHierarchy
+   * @param label label of Vertices found on shortest path
+   *
+   * @return return value of shortestPath(int start, int stop,
+                     std::vector<std::string> &label, SearchMode mode)
+   */
+  template <typename... Args, typename = LabelArguments<Args...>>
+  bool shortestPath(int start, int stop, SearchMode mode,
+                    Args &... args) const {
+    std::vector<std::string> labelsToCheckOnPath;
+    (labelsToCheckOnPath.push_back(args), ...);
+    return shortestPath(start, stop, labelsToCheckOnPath, mode);
+  }
+
+  /**
+   * Finds shortest paths of batch of queries
+   *
+   * Calls for LinkedListOfVertices method void findShortestPaths(const
+   * std::vector<PathQuery> &queries, std::vector<PathResult> &results) const.
+   * Queries are answered on pool of threads, queries in Forward mode with the
+   * same start Vertex and labels with one search.
+   *
+   * @param queries queries of batch
+   * @param results results of queries, in order of queries
+   */
+  void shortestPathBatch(const std::vector<PathQuery> &queries,
+                         std::vector<PathResult> &results) const;
+
+  /**
+   * Sets number of threads that answer batches of queries
+   *
+   * Calls for LinkedListOfVertices method void setBatchThreads(unsigned
+   * threads).
+   *
+   * @param threads number of threads, 0 for number of hardware threads
+   */
+  void setBatchThreads(unsigned threads);
+
+  /**
+   * Sets number of cached results of shortestPath
+   *
+   * Calls for LinkedListOfVertices method void setPathCacheCapacity(size_t
+   * capacity). Repeated searches with the same start and stop Vertex, mode
+   * and labels are answered from cache, until graph is changed in a way that
+   * can change their result.
+   *
+   * @param capacity maximum number of results, 0 disables cache
+   */
+  void setPathCacheCapacity(size_t capacity);
+
+  /**
+   * Calls for LinkedListOfVertices method PathCacheStats pathCacheStats()
+   * const.
+   *
+   * @return counters of hits and misses of path cache
+   */
+  PathCacheStats pathCacheStats() const;
+
+  /**
+   * Calls for LinkedListOfVertices method uint64_t generation() const.
+   *
+   * @return generation of graph, incremented by every change of Graph
+   */
+  uint64_t generation() const;
+
+  /**
+   * Publishes current graph as new version
+   *
+   * Calls for LinkedListOfVertices method void publish(). Readers that pinned
+   * older versions keep them, readers that pin after this see all changes of
+   * graph made before it. Only chunks of vertices changed since previous
+   * version are built.
+   */
+  void publish();
+
+  /**
+   * Sets number of changes of graph after which new version is published
+   *
+   * Calls for LinkedListOfVertices method void setPublishInterval(uint64_t
+   * changes).
+   *
+   * @param changes number of changes, 0 for versions published only by
+   * publish()
+   */
+  void setPublishInterval(uint64_t changes);
+
+  /**
+   * Pins latest published version of graph
+   *
+   * Calls for LinkedListOfVertices method std::shared_ptr<const
+   * GraphVersion<V>> pin() const. Version is immutable and is searched with
+   * GraphVersion::shortestPath, on any number of threads, while one thread
+   * changes graph. Version is freed when the last reader releases it.
+   *
+   * @return latest published version
+   */
+  std::shared_ptr<const GraphVersion<V>> pin() const;
+
+  /**
+   * Calls for LinkedListOfVertices method bool connected(int start, int stop)
+   * const.
+   *
+   * @param start key id of Vertex
+   * @param stop key id of Vertex
+   *
+   * @return true if Vertices are connected when direction of edges is
+   * ignored, removed vertices and edges are taken into account after
+   * components are built again after compaction pass
+   */
+  bool connected(int start, int stop) const;
+
+  /**
+   * Calls for LinkedListOfVertices method size_t componentCount() const.
+   *
+   * @return number of weakly connected components of graph, removed
+   * vertices and edges are taken into account after components are built
+   * again after compaction pass
+   */
+  size_t componentCount() const;
+
+  /**
+   * Finds shortest paths from start Vertex to all Vertices reached from it
+   *
+   * Calls for LinkedListOfVertices method bool findShortestPathTree(int
+   * start, const std::vector<std::string> &label, ShortestPathTree &tree)
+   * const. One search answers distances and paths to all reached Vertices.
+   *
+   * @param start key id of start Vertex
+   * @param label label of Vertices on paths, start Vertex excluded
+   * @param tree found shortest path tree
+   *
+   * @return true if start Vertex is in graph
+   */
+  bool shortestPathTree(int start, const std::vector<std::string> &label,
+                        ShortestPathTree &tree) const;
+
+  /**
+   * Finds shortest paths from start Vertex to all Vertices reached from it
+   *
+   * Same as shortestPathTree(int start, const std::vector<std::string>
+   * &label, ShortestPathTree &tree), tree is returned.
+   *
+   * @param start key id of start Vertex
+   * @param label label of Vertices on paths, start Vertex excluded
+   *
+   * @return found shortest path tree, empty if start Vertex is not in graph
+   */
+  ShortestPathTree
+  shortestPathTree(int start,
+                   const std::vector<std::string> &label = {}) const;
+
   /**
    * Calls for LinkedListOfVertices method void getVertexInfo(int key).
    *
@@ -184,55 +629,420 @@ public:
   void getVertexInfo(int key);
 
   /**
-   * Disables console print of Vertices that are found in function
-   * shortestPath(int start, int stopV,
-                     std::vector<std::string> &label)
-   *
-   * Helper function added for testing purposes.
+   * Calls for LinkedListOfVertices method void disableOutputPrint(), that
+   * does nothing. Searches do not print found paths, PathResult is printed
+   * with operator<< by caller.
    *
+   * @deprecated kept for existing callers, helper function added for testing
+   * purposes
    */
   void disableOutputPrint();
+
+  /**
+   * Finds all Vertices that have all given labels
+   *
+   * Calls for LinkedListOfVertices method std::vector<int>
+   * findVerticesWithLabel(const std::vector<std::string> &label).
+   *
+   * @param label labels that each found Vertex has to have
+   *
+   * @return keys of found Vertices, in ascending order
+   */
+  std::vector<int> findVerticesWithLabel(const std::vector<std::string> &label);
+
+  /**
+   * Variadic template function Finds all Vertices that have all given labels
+   *
+   * Saves all string arguments into string vector and calls
+   * findVerticesWithLabel(const std::vector<std::string> &label)
+   *
+   * @tparam args string arguments
+   *
+   * @return return value of findVerticesWithLabel(const
+   * std::vector<std::string> &label)
+   */
+  template <typename... Args>
+  std::vector<int> findVerticesWithLabel(const Args &... args) {
+    std::vector<std::string> labels;
+    (labels.push_back(args), ...);
+    return findVerticesWithLabel(labels);
+  }
+
+  /**
+   * Compiles labels to mask of label ids of Graph, that can be used for
+   * searches over snapshot
+   *
+   * Calls for LinkedListOfVertices method LabelMask compileLabels(const
+   * std::vector<std::string> &label) const.
+   *
+   * @param label labels that each vertex on path has to have
+   */
+  LabelMask compileLabels(const std::vector<std::string> &label) const;
+
+  /**
+   * Freezes Graph for read-heavy use
+   *
+   * Calls for LinkedListOfVertices method void freeze(). CSR snapshot of
+   * Graph is built and all following shortest path searches run over it.
+   * Graph can still be changed, snapshot is patched or rebuilt.
+   */
+  void freeze();
+
+  /**
+   * Calls for LinkedListOfVertices method void thaw(), searches run over
+   * linked vertices again.
+   */
+  void thaw();
+
+  /**
+   * Returns CSR snapshot of Graph
+   *
+   * Calls for LinkedListOfVertices method const CsrSnapshot<V> &snapshot()
+   * const.
+   */
+  const CsrSnapshot<V> &snapshot() const;
+
+  /**
+   * Saves Graph to binary graph file, that is opened with MappedGraph
+   *
+   * Calls for LinkedListOfVertices method bool save(const std::string &path)
+   * const.
+   *
+   * @param path path of file, file is replaced
+   *
+   * @return true if file is written
+   */
+  bool save(const std::string &path) const;
+
+  /**
+   * Builds landmarks for searches in SearchMode::Landmarks
+   *
+   * Calls for LinkedListOfVertices method void buildLandmarks(unsigned count,
+   * LandmarkSelection selection). Distances to and from landmarks are updated
+   * by new edges afterwards.
+   *
+   * @param count number of landmarks
+   * @param selection way of choosing landmarks
+   */
+  void
+  buildLandmarks(unsigned count = 8,
+                 LandmarkSelection selection = LandmarkSelection::Farthest);
+
+  /**
+   * Calls for LinkedListOfVertices method size_t landmarkCount() const.
+   */
+  size_t landmarkCount() const;
+
+  /**
+   * Saves landmarks to landmark file
+   *
+   * Calls for LinkedListOfVertices method bool saveLandmarks(const
+   * std::string &path) const.
+   *
+   * @param path path of file, file is replaced
+   *
+   * @return true if landmarks are built and file is written
+   */
+  bool saveLandmarks(const std::string &path) const;
+
+  /**
+   * Reads landmarks from landmark file of the same Graph
+   *
+   * Calls for LinkedListOfVertices method bool openLandmarks(const
+   * std::string &path).
+   *
+   * @param path path of file
+   *
+   * @return true if file is read
+   */
+  bool openLandmarks(const std::string &path);
+
+  /**
+   * Builds contraction hierarchy for searches in
+   * SearchMode::ContractionHierarchy
+   *
+   * Calls for LinkedListOfVertices method void buildContractionHierarchy().
+   * Hierarchy is not updated by changes of edges, it has to be built again.
+   */
+  void buildContractionHierarchy();
+
+  /**
+   * Calls for LinkedListOfVertices method size_t shortcutCount() const.
+   */
+  size_t shortcutCount() const;
 };
 
-template <typename V>
-GraphStoreLinked<V>::GraphStoreLinked() : linkedListOfVertices() {}
+template <typename V, typename Resource>
+GraphStoreLinked<V, Resource>::GraphStoreLinked() : linkedListOfVertices() {}
+
+template <typename V, typename Resource>
+GraphStoreLinked<V, Resource>::GraphStoreLinked(
+    std::pmr::memory_resource *upstream)
+    : linkedListOfVertices(upstream) {}
 
-template <typename V> GraphStoreLinked<V>::~GraphStoreLinked() {}
+template <typename V, typename Resource>
+GraphStoreLinked<V, Resource>::~GraphStoreLinked() {}
 
-template <typename V>
-bool GraphStoreLinked<V>::addVertex(int key, const V &info) {
+template <typename V, typename Resource>
+bool GraphStoreLinked<V, Resource>::addVertex(int key, const V &info) {
   return linkedListOfVertices.insertNodeVertexAsHead(key, info);
 }
 
-template <typename V>
-bool GraphStoreLinked<V>::createEdge(int start, int stop) {
+template <typename V, typename Resource>
+bool GraphStoreLinked<V, Resource>::createEdge(int start, int stop) {
   return linkedListOfVertices.addEdgeToHeadNodeVertex(start, stop);
 }
 
-template <typename V>
-bool GraphStoreLinked<V>::addLabel(int key,
-                                   const std::vector<std::string> &label) {
+template <typename V, typename Resource>
+bool GraphStoreLinked<V, Resource>::removeVertex(int key) {
+  return linkedListOfVertices.removeVertex(key);
+}
+
+template <typename V, typename Resource>
+bool GraphStoreLinked<V, Resource>::removeEdge(int start, int stop) {
+  return linkedListOfVertices.removeEdge(start, stop);
+}
+
+template <typename V, typename Resource>
+size_t GraphStoreLinked<V, Resource>::compact() {
+  return linkedListOfVertices.compact();
+}
+
+template <typename V, typename Resource>
+void GraphStoreLinked<V, Resource>::setCompactionThreshold(double threshold) {
+  linkedListOfVertices.setCompactionThreshold(threshold);
+}
+
+template <typename V, typename Resource>
+bool GraphStoreLinked<V, Resource>::addLabel(
+    int key, const std::vector<std::string> &label) {
   return linkedListOfVertices.addLabelToVertex(key, label);
 }
 
-template <typename V>
-bool GraphStoreLinked<V>::removeLabel(int key,
-                                      const std::vector<std::string> &label) {
+template <typename V, typename Resource>
+bool GraphStoreLinked<V, Resource>::removeLabel(
+    int key, const std::vector<std::string> &label) {
   return linkedListOfVertices.removeLabelFromVertex(key, label);
 }
 
-template <typename V> void GraphStoreLinked<V>::getVertexInfo(int key) {
+template <typename V, typename Resource>
+void GraphStoreLinked<V, Resource>::getVertexInfo(int key) {
   linkedListOfVertices.getVertexInfo(key);
 }
 
-template <typename V>
-bool GraphStoreLinked<V>::shortestPath(int start, int stop,
-                                       std::vector<std::string> &label) {
-  return linkedListOfVertices.findShortestPath(start, stop, label);
+template <typename V, typename Resource>
+void GraphStoreLinked<V, Resource>::disableOutputPrint() {
+  linkedListOfVertices.disableOutputPrint();
+}
+
+template <typename V, typename Resource>
+std::vector<int> GraphStoreLinked<V, Resource>::findVerticesWithLabel(
+    const std::vector<std::string> &label) {
+  return linkedListOfVertices.findVerticesWithLabel(label);
 }
 
-template <typename V> void GraphStoreLinked<V>::disableOutputPrint() {
-  linkedListOfVertices.disableOutputPrint();
+template <typename V, typename Resource>
+bool GraphStoreLinked<V, Resource>::shortestPath(
+    int start, int stop, const std::vector<std::string> &label,
+    SearchMode mode) const {
+  return linkedListOfVertices.findShortestPath(start, stop, label, mode);
+}
+
+template <typename V, typename Resource>
+bool GraphStoreLinked<V, Resource>::shortestPath(
+    int start, int stop, const std::vector<std::string> &label,
+    QueryContext<V> &context, SearchMode mode) const {
+  return linkedListOfVertices.findShortestPath(start, stop, label, context,
+                                               mode);
+}
+
+template <typename V, typename Resource>
+bool GraphStoreLinked<V, Resource>::shortestPath(
+    int start, int stop, const std::vector<std::string> &label,
+    PathResult &result, SearchMode mode) const {
+  return linkedListOfVertices.findShortestPath(start, stop, label, result,
+                                               mode);
+}
+
+template <typename V, typename Resource>
+void GraphStoreLinked<V, Resource>::shortestPathBatch(
+    const std::vector<PathQuery> &queries,
+    std::vector<PathResult> &results) const {
+  linkedListOfVertices.findShortestPaths(queries, results);
+}
+
+template <typename V, typename Resource>
+void GraphStoreLinked<V, Resource>::setBatchThreads(unsigned threads) {
+  linkedListOfVertices.setBatchThreads(threads);
+}
+
+template <typename V, typename Resource>
+void GraphStoreLinked<V, Resource>::setPathCacheCapacity(size_t capacity) {
+  linkedListOfVertices.setPathCacheCapacity(capacity);
+}
+
+template <typename V, typename Resource>
+PathCacheStats GraphStoreLinked<V, Resource>::pathCacheStats() const {
+  return linkedListOfVertices.pathCacheStats();
+}
+
+template <typename V, typename Resource>
+uint64_t GraphStoreLinked<V, Resource>::generation() const {
+  return linkedListOfVertices.generation();
+}
+
+template <typename V, typename Resource>
+void GraphStoreLinked<V, Resource>::beginIngest() {
+  linkedListOfVertices.beginIngest();
+}
+
+template <typename V, typename Resource>
+size_t GraphStoreLinked<V, Resource>::endIngest(unsigned threads) {
+  return linkedListOfVertices.endIngest(threads);
+}
+
+template <typename V, typename Resource>
+size_t GraphStoreLinked<V, Resource>::loadEdgeList(const std::string &path,
+                                                   const V &info,
+                                                   unsigned threads,
+                                                   size_t chunkBytes) {
+  return linkedListOfVertices.loadEdgeList(path, info, threads, chunkBytes);
+}
+
+template <typename V, typename Resource>
+size_t GraphStoreLinked<V, Resource>::loadLabels(const std::string &path,
+                                                 unsigned threads,
+                                                 size_t chunkBytes) {
+  return linkedListOfVertices.loadLabels(path, threads, chunkBytes);
+}
+
+template <typename V, typename Resource>
+bool GraphStoreLinked<V, Resource>::openLog(const std::string &path) {
+  return linkedListOfVertices.openLog(path);
+}
+
+template <typename V, typename Resource>
+void GraphStoreLinked<V, Resource>::closeLog() {
+  linkedListOfVertices.closeLog();
+}
+
+template <typename V, typename Resource>
+bool GraphStoreLinked<V, Resource>::commitLog() {
+  return linkedListOfVertices.commitLog();
+}
+
+template <typename V, typename Resource>
+bool GraphStoreLinked<V, Resource>::checkpointLog() {
+  return linkedListOfVertices.checkpointLog();
+}
+
+template <typename V, typename Resource>
+void GraphStoreLinked<V, Resource>::setLogGroupBytes(size_t bytes) {
+  linkedListOfVertices.setLogGroupBytes(bytes);
+}
+
+template <typename V, typename Resource>
+void GraphStoreLinked<V, Resource>::setCheckpointBytes(uint64_t bytes) {
+  linkedListOfVertices.setCheckpointBytes(bytes);
+}
+
+template <typename V, typename Resource>
+void GraphStoreLinked<V, Resource>::publish() {
+  linkedListOfVertices.publish();
+}
+
+template <typename V, typename Resource>
+void GraphStoreLinked<V, Resource>::setPublishInterval(uint64_t changes) {
+  linkedListOfVertices.setPublishInterval(changes);
+}
+
+template <typename V, typename Resource>
+std::shared_ptr<const GraphVersion<V>>
+GraphStoreLinked<V, Resource>::pin() const {
+  return linkedListOfVertices.pin();
+}
+
+template <typename V, typename Resource>
+bool GraphStoreLinked<V, Resource>::connected(int start, int stop) const {
+  return linkedListOfVertices.connected(start, stop);
+}
+
+template <typename V, typename Resource>
+size_t GraphStoreLinked<V, Resource>::componentCount() const {
+  return linkedListOfVertices.componentCount();
+}
+
+template <typename V, typename Resource>
+bool GraphStoreLinked<V, Resource>::shortestPathTree(
+    int start, const std::vector<std::string> &label,
+    ShortestPathTree &tree) const {
+  return linkedListOfVertices.findShortestPathTree(start, label, tree);
+}
+
+template <typename V, typename Resource>
+ShortestPathTree GraphStoreLinked<V, Resource>::shortestPathTree(
+    int start, const std::vector<std::string> &label) const {
+  ShortestPathTree tree;
+  linkedListOfVertices.findShortestPathTree(start, label, tree);
+  return tree;
+}
+
+template <typename V, typename Resource>
+LabelMask GraphStoreLinked<V, Resource>::compileLabels(
+    const std::vector<std::string> &label) const {
+  return linkedListOfVertices.compileLabels(label);
+}
+
+template <typename V, typename Resource>
+void GraphStoreLinked<V, Resource>::freeze() {
+  linkedListOfVertices.freeze();
+}
+
+template <typename V, typename Resource>
+void GraphStoreLinked<V, Resource>::thaw() {
+  linkedListOfVertices.thaw();
+}
+
+template <typename V, typename Resource>
+const CsrSnapshot<V> &GraphStoreLinked<V, Resource>::snapshot() const {
+  return linkedListOfVertices.snapshot();
+}
+
+template <typename V, typename Resource>
+bool GraphStoreLinked<V, Resource>::save(const std::string &path) const {
+  return linkedListOfVertices.save(path);
+}
+
+template <typename V, typename Resource>
+void GraphStoreLinked<V, Resource>::buildLandmarks(
+    unsigned count, LandmarkSelection selection) {
+  linkedListOfVertices.buildLandmarks(count, selection);
+}
+
+template <typename V, typename Resource>
+size_t GraphStoreLinked<V, Resource>::landmarkCount() const {
+  return linkedListOfVertices.landmarkCount();
+}
+
+template <typename V, typename Resource>
+bool GraphStoreLinked<V, Resource>::saveLandmarks(
+    const std::string &path) const {
+  return linkedListOfVertices.saveLandmarks(path);
+}
+
+template <typename V, typename Resource>
+bool GraphStoreLinked<V, Resource>::openLandmarks(const std::string &path) {
+  return linkedListOfVertices.openLandmarks(path);
+}
+
+template <typename V, typename Resource>
+void GraphStoreLinked<V, Resource>::buildContractionHierarchy() {
+  linkedListOfVertices.buildContractionHierarchy();
+}
+
+template <typename V, typename Resource>
+size_t GraphStoreLinked<V, Resource>::shortcutCount() const {
+  return linkedListOfVertices.shortcutCount();
 }
 
 } // namespace graph
@@ -0,0 +1,783 @@
+#pragma once
+
+#include "chunkTrie.h"
+#include "connectivityIndex.h"
+#include "labelDictionary.h"
+#include "linkedVertices.h"
+#include "pathQuery.h"
+#include "queryContext.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory>
+
+namespace graph {
+
+/**
+ * Implementation of the VertexChunk structure.
+ *
+ * VertexChunk keeps 64 consecutive vertices of GraphVersion, by dense index,
+ * with their keys, labels, parents in trees of weakly connected components
+ * and edges in compressed sparse row form. Edges of vertex at position i of
+ * chunk are stored in neighbors between offsets[i] and offsets[i + 1], as
+ * dense indices of destination vertices, incoming edges in inNeighbors in the
+ * same way, sorted ascending. Chunk is immutable once it is built and is
+ * shared by all versions in which its vertices did not change.
+ */
+struct VertexChunk {
+  std::array<int, 64> keys{};
+  std::array<uint64_t, 64> labelBits{};
+  std::array<uint32_t, 64> parents{};
+  std::array<uint32_t, 65> offsets{};
+  std::array<uint32_t, 65> inOffsets{};
+  std::vector<uint32_t> neighbors;
+  std::vector<uint32_t> inNeighbors;
+
+  /**
+   * Pairs < position in chunk, labels of vertex >, for vertices that have
+   * labels with id >= 64
+   */
+  std::vector<std::pair<uint32_t, LabelSet>> overflowLabels;
+};
+
+/**
+ * Implementation of the VersionChanges class.
+ *
+ * VersionChanges collects what writer of graph changed since the last
+ * published version: chunks of 64 vertices whose vertices, labels, edges or
+ * components changed, and keys that were added or removed. Next version
+ * builds only these chunks again and shares all other chunks with the last
+ * version. Until the first version is published, and after changes that
+ * touch the whole graph, all chunks are built.
+ */
+class VersionChanges {
+public:
+  /**
+   * Index given with key that was removed
+   */
+  static constexpr uint32_t removedKey = std::numeric_limits<uint32_t>::max();
+
+private:
+  /**
+   * Numbers of changed chunks, each once
+   */
+  std::vector<uint32_t> changedChunks;
+
+  /**
+   * 1 for changed chunks, indexed by number of chunk
+   */
+  std::vector<uint8_t> marks;
+
+  /**
+   * Pairs < key, dense index or removedKey >, in order of changes
+   */
+  std::vector<std::pair<int, uint32_t>> changedKeys;
+
+  /**
+   * True if all chunks and keys are built again
+   */
+  bool everything = true;
+
+public:
+  /**
+   * Marks chunk of vertex with dense index as changed
+   *
+   * @param index dense index of vertex
+   */
+  void vertex(uint32_t index) {
+    if (everything)
+      return;
+    uint32_t chunk = index >> 6;
+    if (chunk >= marks.size())
+      marks.resize(chunk + 1, 0);
+    if (!marks[chunk]) {
+      marks[chunk] = 1;
+      changedChunks.push_back(chunk);
+    }
+  }
+
+  /**
+   * Records key that was added with dense index, or removed
+   *
+   * @param key key id of vertex
+   * @param index dense index of vertex, removedKey if key was removed
+   */
+  void key(int key, uint32_t index) {
+    if (!everything)
+      changedKeys.emplace_back(key, index);
+  }
+
+  /**
+   * Marks all chunks and keys as changed
+   */
+  void all() {
+    everything = true;
+    std::vector<uint32_t>().swap(changedChunks);
+    std::vector<uint8_t>().swap(marks);
+    std::vector<std::pair<int, uint32_t>>().swap(changedKeys);
+  }
+
+  /**
+   * Forgets changes, called when version with them is published
+   */
+  void clear() {
+    everything = false;
+    for (auto chunk : changedChunks) {
+      marks[chunk] = 0;
+    }
+    changedChunks.clear();
+    changedKeys.clear();
+  }
+
+  /**
+   * Returns true if all chunks and keys changed
+   */
+  bool allChanged() const { return everything; }
+
+  /**
+   * Returns numbers of changed chunks, in order they were marked
+   */
+  const std::vector<uint32_t> &chunks() const { return changedChunks; }
+
+  /**
+   * Returns pairs < key, dense index or removedKey >, in order of changes
+   */
+  const std::vector<std::pair<int, uint32_t>> &keys() const {
+    return changedKeys;
+  }
+};
+
+/**
+ * Implementation of the GraphVersion class.
+ *
+ * GraphVersion is an immutable version of graph, published by writer of graph
+ * and pinned by readers. It keeps vertices, edges, labels and weakly
+ * connected component of each vertex in VertexChunk of 64 vertices, and keys
+ * of vertices in buckets, as they were when version was published, with
+ * dictionary of labels. Version is never changed after it is built, so many
+ * threads can search it while writer changes graph and publishes new
+ * versions.
+ *
+ * Chunks and buckets are kept in ChunkTrie. Version is built from the last
+ * version and VersionChanges of writer, only changed chunks and buckets are
+ * built again and all other are shared, so publishing costs edges of changed
+ * chunks and not size of graph. Version gives the same view of vertices and
+ * edges as CsrSnapshot, so DirectionOptimizingBfs searches it in the same way
+ * and paths are the same as paths of frozen graph. Edges that start and stop
+ * vertex have more than once are kept once.
+ *
+ * Versions are held by std::shared_ptr, reader pins version by taking a copy
+ * of the pointer and old version is freed when the last reader releases it,
+ * chunks that newer versions share stay. Dictionary of labels only grows, so
+ * versions share it until new labels are interned.
+ *
+ * @tparam V type of data stored in graph vertices
+ */
+template <typename V> class GraphVersion {
+private:
+  /**
+   * Pairs < key, dense index > of keys in one bucket
+   */
+  using KeyBucket = std::vector<std::pair<int, uint32_t>>;
+
+  /**
+   * Chunks of vertices, by dense index / 64
+   */
+  ChunkTrie<VertexChunk> chunks;
+
+  /**
+   * Buckets of keys, by hash of key
+   */
+  ChunkTrie<KeyBucket> buckets;
+
+  /**
+   * Number of bits of hash that are used as bucket of key
+   */
+  unsigned bucketBits = 0;
+
+  /**
+   * Number of vertices and edges in version
+   */
+  size_t vertices = 0;
+  size_t edges = 0;
+
+  /**
+   * Dictionary of labels, shared with versions with the same labels
+   */
+  std::shared_ptr<const LabelDictionary> dictionary;
+
+  /**
+   * Generation of graph when version was published
+   */
+  uint64_t versionGeneration = 0;
+
+  /**
+   * Returns chunk of vertex with dense index
+   */
+  const VertexChunk &chunkOf(uint32_t index) const {
+    return chunks.at(index >> 6);
+  }
+
+  /**
+   * Returns bucket of key, when given number of bits of hash are used
+   */
+  static uint32_t bucketOf(int key, unsigned bits) {
+    if (bits == 0)
+      return 0;
+    uint64_t hash = static_cast<uint64_t>(std::hash<int>{}(key));
+    return static_cast<uint32_t>((hash * 0x9E3779B97F4A7C15ull) >>
+                                 (64 - bits));
+  }
+
+  /**
+   * Builds chunk of vertices from vertex arrays of graph
+   */
+  static std::shared_ptr<const VertexChunk>
+  buildChunk(uint32_t chunk,
+             const std::pmr::vector<LinkedVertices<V> *> &vertices,
+             const std::pmr::vector<LabelSet> &labels,
+             const std::pmr::vector<uint8_t> &removed,
+             const ConnectivityIndex &connectivity);
+
+  /**
+   * Builds all buckets of keys from vertex arrays of graph
+   */
+  void buildBuckets(const std::pmr::vector<LinkedVertices<V> *> &vertices,
+                    const std::pmr::vector<uint8_t> &removed);
+
+  /**
+   * Builds again buckets of changed keys, from buckets of last version
+   */
+  void updateBuckets(const std::vector<std::pair<int, uint32_t>> &keys);
+
+  /**
+   * Checks if vertex with dense index has labels of mask with id >= 64
+   */
+  bool hasOverflowLabel(uint32_t index, const LabelMask &mask) const;
+
+  /**
+   * Returns root of weakly connected component of vertex with dense index
+   */
+  uint32_t component(uint32_t index) const;
+
+public:
+  /**
+   * Constructor of GraphVersion
+   *
+   * Builds version of graph without vertices.
+   */
+  GraphVersion() : dictionary(std::make_shared<const LabelDictionary>()) {}
+
+  /**
+   * Constructor of GraphVersion
+   *
+   * Builds version from last version, changed chunks and keys are built
+   * from vertex arrays of graph and all other are shared with last version.
+   *
+   * @param previous last version published by graph
+   * @param changes changes of graph since last version
+   * @param vertices ptrs to LinkedVertices, indexed by dense index
+   * @param labels labels of vertices, indexed by dense index
+   * @param removed 1 for removed vertices, indexed by dense index
+   * @param connectivity weakly connected components of graph
+   * @param dictionary dictionary of labels of graph
+   * @param generation generation of graph
+   */
+  GraphVersion(const GraphVersion &previous, const VersionChanges &changes,
+               const std::pmr::vector<LinkedVertices<V> *> &vertices,
+               const std::pmr::vector<LabelSet> &labels,
+               const std::pmr::vector<uint8_t> &removed,
+               const ConnectivityIndex &connectivity,
+               std::shared_ptr<const LabelDictionary> dictionary,
+               uint64_t generation);
+
+  /// Disabling construction of GraphVersion object using copy constructor
+  GraphVersion(const GraphVersion &rhs) = delete;
+
+  /// Disabling construction of GraphVersion object using copy assignment
+  GraphVersion &operator=(const GraphVersion &rhs) = delete;
+
+  /**
+   * Returns generation of graph when version was published
+   */
+  uint64_t generation() const { return versionGeneration; }
+
+  /**
+   * Returns number of vertices in version
+   */
+  size_t vertexCount() const { return vertices; }
+
+  /**
+   * Returns number of edges in version
+   */
+  size_t edgeCount() const { return edges; }
+
+  /**
+   * Returns dictionary of labels of version
+   */
+  const LabelDictionary &labelDictionary() const { return *dictionary; }
+
+  /**
+   * Finds dense index of vertex with given key
+   *
+   * @param key key id of Vertex
+   * @param index dense index of Vertex, set if vertex is found
+   *
+   * @return true if version contains vertex with key
+   */
+  bool findIndex(int key, uint32_t &index) const;
+
+  /**
+   * Returns true if version contains Vertex with key
+   *
+   * @param key key id of Vertex
+   */
+  bool contains(int key) const {
+    uint32_t index = 0;
+    return findIndex(key, index);
+  }
+
+  /**
+   * Returns key of vertex with dense index
+   *
+   * @param index dense index of Vertex
+   */
+  int keyOf(uint32_t index) const { return chunkOf(index).keys[index & 63]; }
+
+  /**
+   * Returns pointer to first edge of vertex with dense index, edges are
+   * stored contiguously until edgesEnd(index)
+   *
+   * @param index dense index of Vertex
+   */
+  const uint32_t *edgesBegin(uint32_t index) const {
+    const VertexChunk &chunk = chunkOf(index);
+    return chunk.neighbors.data() + chunk.offsets[index & 63];
+  }
+
+  /**
+   * Returns pointer past the last edge of vertex with dense index
+   *
+   * @param index dense index of Vertex
+   */
+  const uint32_t *edgesEnd(uint32_t index) const {
+    const VertexChunk &chunk = chunkOf(index);
+    return chunk.neighbors.data() + chunk.offsets[(index & 63) + 1];
+  }
+
+  /**
+   * Returns pointer to first incoming edge of vertex with dense index,
+   * incoming edges are stored contiguously until incomingEnd(index)
+   *
+   * @param index dense index of Vertex
+   */
+  const uint32_t *incomingBegin(uint32_t index) const {
+    const VertexChunk &chunk = chunkOf(index);
+    return chunk.inNeighbors.data() + chunk.inOffsets[index & 63];
+  }
+
+  /**
+   * Returns pointer past the last incoming edge of vertex with dense index
+   *
+   * @param index dense index of Vertex
+   */
+  const uint32_t *incomingEnd(uint32_t index) const {
+    const VertexChunk &chunk = chunkOf(index);
+    return chunk.inNeighbors.data() + chunk.inOffsets[(index & 63) + 1];
+  }
+
+  /**
+   * Returns number of edges of vertex with dense index
+   *
+   * @param index dense index of Vertex
+   */
+  uint32_t outDegree(uint32_t index) const {
+    const VertexChunk &chunk = chunkOf(index);
+    return chunk.offsets[(index & 63) + 1] - chunk.offsets[index & 63];
+  }
+
+  /**
+   * Returns number of incoming edges of vertex with dense index
+   *
+   * @param index dense index of Vertex
+   */
+  uint32_t inDegree(uint32_t index) const {
+    const VertexChunk &chunk = chunkOf(index);
+    return chunk.inOffsets[(index & 63) + 1] - chunk.inOffsets[index & 63];
+  }
+
+  /**
+   * Checks if labels of vertex with dense index contain all labels of mask and
+   * returns true if do
+   *
+   * @param index dense index of Vertex
+   * @param mask compiled labels for which is checked if they are inserted in
+   * labels of Vertex
+   */
+  bool hasLabel(uint32_t index, const LabelMask &mask) const {
+    return (chunkOf(index).labelBits[index & 63] & mask.bits) == mask.bits &&
+           mask.satisfiable &&
+           (mask.overflow.empty() || hasOverflowLabel(index, mask));
+  }
+
+  /**
+   * Checks labels of up to 64 vertices at once, bit i of result is set if
+   * vertex vertices[i] has all labels of mask
+   *
+   * @param vertices dense indices of vertices, usually edges of one vertex
+   * @param count number of vertices, at most 64
+   * @param mask compiled labels of search
+   */
+  uint64_t matchLabels(const uint32_t *vertices, size_t count,
+                       const LabelMask &mask) const;
+
+  /**
+   * Sets bits of dense indices of vertices that have all labels of mask. Each
+   * chunk is one word of bitmap, so scratch is not used
+   *
+   * @param mask compiled labels of search
+   * @param words cleared bitmap of dense indices
+   * @param scratch bitmap used for intersection of sets of labels
+   */
+  void findVertexBits(const LabelMask &mask, std::vector<uint64_t> &words,
+                      std::vector<uint64_t> &scratch) const;
+
+  /**
+   * Finds shortest path between two Vertices in version, with given query
+   * context
+   *
+   * Vertices in different weakly connected components are rejected without
+   * search, other searches run DirectionOptimizingBfs over version, so paths
+   * are the same as paths of frozen graph. Keys of vertices on found path,
+   * without stop vertex, are left in path of context.
+   *
+   * @param start key id of source Vertex
+   * @param stop key id of destination Vertex
+   * @param label label of Vertices found on shortest path
+   * @param context state of search, used by one thread at a time
+   *
+   * @return true if there is a path between two vertices, where each vertex on
+   * the path has label
+   */
+  bool shortestPath(int start, int stop, const std::vector<std::string> &label,
+                    QueryContext<V> &context) const;
+
+  /**
+   * Finds shortest path between two Vertices in version, into given result
+   *
+   * Same as shortestPath(int start, int stop, const std::vector<std::string>
+   * &label, QueryContext<V> &context), with query context of calling thread.
+   * Keys of vertices on found path, start and stop vertex included, and its
+   * distance are written to result.
+   *
+   * @param start key id of source Vertex
+   * @param stop key id of destination Vertex
+   * @param label label of Vertices found on shortest path
+   * @param result found path, cleared first
+   *
+   * @return true if there is a path between two vertices, where each vertex on
+   * the path has label
+   */
+  bool shortestPath(int start, int stop, const std::vector<std::string> &label,
+                    PathResult &result) const;
+};
+
+template <typename V>
+GraphVersion<V>::GraphVersion(
+    const GraphVersion &previous, const VersionChanges &changes,
+    const std::pmr::vector<LinkedVertices<V> *> &vertices,
+    const std::pmr::vector<LabelSet> &labels,
+    const std::pmr::vector<uint8_t> &removed,
+    const ConnectivityIndex &connectivity,
+    std::shared_ptr<const LabelDictionary> dictionary, uint64_t generation)
+    : vertices(vertices.size()), dictionary(std::move(dictionary)),
+      versionGeneration(generation) {
+  uint32_t chunkCount = static_cast<uint32_t>((vertices.size() + 63) / 64);
+  std::vector<uint32_t> changed;
+  if (changes.allChanged()) {
+    for (uint32_t chunk = 0; chunk < chunkCount; ++chunk) {
+      changed.push_back(chunk);
+    }
+  } else {
+    chunks = previous.chunks;
+    edges = previous.edges;
+    changed = changes.chunks();
+    std::sort(changed.begin(), changed.end());
+  }
+
+  // edges of replaced chunks are counted out, edges of new chunks in
+  std::vector<ChunkTrie<VertexChunk>::Entry> entries;
+  entries.reserve(changed.size());
+  for (auto chunk : changed) {
+    if (chunk >= chunkCount)
+      continue;
+    if (const VertexChunk *old = chunks.find(chunk))
+      edges -= old->offsets[64];
+    entries.emplace_back(
+        chunk, buildChunk(chunk, vertices, labels, removed, connectivity));
+    edges += entries.back().second->offsets[64];
+  }
+  chunks.assign(entries);
+
+  // buckets hold about 16 keys, so number of bits grows with vertices and
+  // all buckets are built again when it does
+  while ((size_t(16) << bucketBits) < vertices.size()) {
+    ++bucketBits;
+  }
+  if (changes.allChanged() || bucketBits != previous.bucketBits) {
+    buildBuckets(vertices, removed);
+  } else {
+    buckets = previous.buckets;
+    updateBuckets(changes.keys());
+  }
+}
+
+template <typename V>
+std::shared_ptr<const VertexChunk> GraphVersion<V>::buildChunk(
+    uint32_t chunk, const std::pmr::vector<LinkedVertices<V> *> &vertices,
+    const std::pmr::vector<LabelSet> &labels,
+    const std::pmr::vector<uint8_t> &removed,
+    const ConnectivityIndex &connectivity) {
+  auto built = std::make_shared<VertexChunk>();
+  uint32_t first = chunk << 6;
+  auto live = [&removed](uint32_t edge) {
+    return edge != LinkedVertices<V>::removedEdge && !removed[edge];
+  };
+  // edges are kept once, in order of their first copy, so top down searches
+  // visit vertices in the same order as in CsrSnapshot
+  std::vector<uint32_t> sorted;
+  std::vector<uint8_t> kept;
+  auto keepFirst = [&sorted, &kept](std::vector<uint32_t> &edges,
+                                    size_t begin) {
+    sorted.assign(edges.begin() + begin, edges.end());
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    if (sorted.size() == edges.size() - begin)
+      return;
+    kept.assign(sorted.size(), 0);
+    size_t end = begin;
+    for (size_t i = begin; i < edges.size(); ++i) {
+      auto position = std::lower_bound(sorted.begin(), sorted.end(), edges[i]) -
+                      sorted.begin();
+      if (!kept[position]) {
+        kept[position] = 1;
+        edges[end++] = edges[i];
+      }
+    }
+    edges.resize(end);
+  };
+
+  for (uint32_t position = 0; position < 64; ++position) {
+    uint32_t index = first + position;
+    built->parents[position] = index;
+    if (index < vertices.size()) {
+      built->keys[position] = vertices[index]->getHead()->id;
+      built->labelBits[position] = labels[index].inlineBits();
+      if (labels[index].hasOverflow())
+        built->overflowLabels.emplace_back(position, labels[index]);
+      built->parents[position] = connectivity.parent(index);
+      if (!removed[index]) {
+        size_t begin = built->neighbors.size();
+        for (auto edge : vertices[index]->returnEdges()) {
+          if (live(edge))
+            built->neighbors.push_back(edge);
+        }
+        keepFirst(built->neighbors, begin);
+        begin = built->inNeighbors.size();
+        for (auto edge : vertices[index]->returnIncomingEdges()) {
+          if (live(edge))
+            built->inNeighbors.push_back(edge);
+        }
+        std::sort(built->inNeighbors.begin() + begin, built->inNeighbors.end());
+        built->inNeighbors.erase(std::unique(built->inNeighbors.begin() + begin,
+                                             built->inNeighbors.end()),
+                                 built->inNeighbors.end());
+      }
+    }
+    built->offsets[position + 1] =
+        static_cast<uint32_t>(built->neighbors.size());
+    built->inOffsets[position + 1] =
+        static_cast<uint32_t>(built->inNeighbors.size());
+  }
+  return built;
+}
+
+template <typename V>
+void GraphVersion<V>::buildBuckets(
+    const std::pmr::vector<LinkedVertices<V> *> &vertices,
+    const std::pmr::vector<uint8_t> &removed) {
+  std::vector<std::pair<uint32_t, uint32_t>> byBucket;
+  byBucket.reserve(vertices.size());
+  for (uint32_t index = 0; index < vertices.size(); ++index) {
+    int key = vertices[index]->getHead()->id;
+    if (!removed[index])
+      byBucket.emplace_back(bucketOf(key, bucketBits), index);
+  }
+  std::sort(byBucket.begin(), byBucket.end());
+  std::vector<ChunkTrie<KeyBucket>::Entry> entries;
+  for (size_t i = 0; i < byBucket.size();) {
+    auto bucket = std::make_shared<KeyBucket>();
+    uint32_t address = byBucket[i].first;
+    for (; i < byBucket.size() && byBucket[i].first == address; ++i) {
+      uint32_t index = byBucket[i].second;
+      bucket->emplace_back(vertices[index]->getHead()->id, index);
+    }
+    entries.emplace_back(address, std::move(bucket));
+  }
+  buckets = ChunkTrie<KeyBucket>();
+  buckets.assign(entries);
+}
+
+template <typename V>
+void GraphVersion<V>::updateBuckets(
+    const std::vector<std::pair<int, uint32_t>> &keys) {
+  // changes of one bucket are applied in order they were made, so key that
+  // was removed and added again ends with its last index
+  std::vector<std::pair<uint32_t, size_t>> byBucket;
+  byBucket.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    byBucket.emplace_back(bucketOf(keys[i].first, bucketBits), i);
+  }
+  std::sort(byBucket.begin(), byBucket.end());
+  std::vector<ChunkTrie<KeyBucket>::Entry> entries;
+  for (size_t i = 0; i < byBucket.size();) {
+    uint32_t address = byBucket[i].first;
+    const KeyBucket *old = buckets.find(address);
+    auto bucket = old != nullptr ? std::make_shared<KeyBucket>(*old)
+                                 : std::make_shared<KeyBucket>();
+    for (; i < byBucket.size() && byBucket[i].first == address; ++i) {
+      const auto &[key, index] = keys[byBucket[i].second];
+      bucket->erase(std::remove_if(bucket->begin(), bucket->end(),
+                                   [key = key](const auto &entry) {
+                                     return entry.first == key;
+                                   }),
+                    bucket->end());
+      if (index != VersionChanges::removedKey)
+        bucket->emplace_back(key, index);
+    }
+    entries.emplace_back(address, std::move(bucket));
+  }
+  buckets.assign(entries);
+}
+
+template <typename V>
+bool GraphVersion<V>::findIndex(int key, uint32_t &index) const {
+  const KeyBucket *bucket = buckets.find(bucketOf(key, bucketBits));
+  if (bucket == nullptr)
+    return false;
+  for (const auto &entry : *bucket) {
+    if (entry.first == key) {
+      index = entry.second;
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename V>
+uint64_t GraphVersion<V>::matchLabels(const uint32_t *vertices, size_t count,
+                                      const LabelMask &mask) const {
+  if (!mask.satisfiable)
+    return 0;
+  // labels are in chunks of vertices, so they are not looked up when search
+  // has no labels
+  if (mask.empty())
+    return count == 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+  uint64_t result = 0;
+  for (size_t i = 0; i < count; ++i) {
+    uint64_t bits = chunkOf(vertices[i]).labelBits[vertices[i] & 63];
+    result |= uint64_t((bits & mask.bits) == mask.bits) << i;
+  }
+  if (!mask.overflow.empty()) {
+    for (uint64_t matched = result; matched != 0; matched &= matched - 1) {
+      size_t i = static_cast<size_t>(__builtin_ctzll(matched));
+      if (!hasOverflowLabel(vertices[i], mask))
+        result &= ~(uint64_t(1) << i);
+    }
+  }
+  return result;
+}
+
+template <typename V>
+void GraphVersion<V>::findVertexBits(const LabelMask &mask,
+                                     std::vector<uint64_t> &words,
+                                     std::vector<uint64_t> &) const {
+  if (!mask.satisfiable)
+    return;
+  chunks.forEach([&](uint32_t chunk, const VertexChunk &vertexChunk) {
+    uint64_t bits = 0;
+    for (uint32_t position = 0; position < 64; ++position) {
+      bits |= uint64_t((vertexChunk.labelBits[position] & mask.bits) ==
+                       mask.bits)
+              << position;
+    }
+    if (!mask.overflow.empty()) {
+      uint64_t overflow = 0;
+      for (const auto &[position, labels] : vertexChunk.overflowLabels) {
+        if (labels.containsOverflow(mask))
+          overflow |= uint64_t(1) << position;
+      }
+      bits &= overflow;
+    }
+    // positions past the last vertex are not vertices
+    size_t count = std::min<size_t>(64, vertices - size_t(chunk) * 64);
+    if (count < 64)
+      bits &= (uint64_t(1) << count) - 1;
+    words[chunk] = bits;
+  });
+}
+
+template <typename V>
+bool GraphVersion<V>::hasOverflowLabel(uint32_t index,
+                                       const LabelMask &mask) const {
+  for (const auto &[position, labels] : chunkOf(index).overflowLabels) {
+    if (position == (index & 63))
+      return labels.containsOverflow(mask);
+  }
+  return false;
+}
+
+template <typename V>
+uint32_t GraphVersion<V>::component(uint32_t index) const {
+  // parents of chunks that were not built again may be older than parents of
+  // graph, they still point to vertices that joined the component later, so
+  // walk ends in root the component had when version was published
+  for (;;) {
+    uint32_t parent = chunkOf(index).parents[index & 63];
+    if (parent == index)
+      return index;
+    index = parent;
+  }
+}
+
+template <typename V>
+bool GraphVersion<V>::shortestPath(int start, int stop,
+                                   const std::vector<std::string> &label,
+                                   QueryContext<V> &context) const {
+  context.begin(vertices);
+  uint32_t startIndex = 0;
+  uint32_t stopIndex = 0;
+  if (!findIndex(start, startIndex) || !findIndex(stop, stopIndex) ||
+      component(startIndex) != component(stopIndex))
+    return false;
+  LabelMask mask = dictionary->compile(label);
+  return context.bfs().search(*this, startIndex, stopIndex, mask,
+                              context.path());
+}
+
+template <typename V>
+bool GraphVersion<V>::shortestPath(int start, int stop,
+                                   const std::vector<std::string> &label,
+                                   PathResult &result) const {
+  result.clear();
+  QueryContext<V> &context = QueryContext<V>::threadContext();
+  if (!shortestPath(start, stop, label, context))
+    return false;
+  result.found = true;
+  result.distance = static_cast<int>(context.path().size());
+  result.path.assign(context.path().begin(), context.path().end());
+  result.path.push_back(stop);
+  return true;
+}
+
+} // namespace graph
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "labelSet.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Implementation of the LabelDictionary class.
+ *
+ * LabelDictionary interns label strings of one graph to small integer ids,
+ * given in order in which labels are first added to vertices. Vertices then
+ * store labels as LabelSet of ids, and label strings of a search are compiled
+ * once to LabelMask.
+ */
+class LabelDictionary {
+private:
+  /**
+   * Map of pair < label, id of label >
+   */
+  std::unordered_map<std::string, uint32_t> ids;
+
+  /**
+   * Labels, indexed by label id
+   */
+  std::vector<std::string> names;
+
+public:
+  /**
+   * Returns id of label, label is inserted in dictionary if it is not there
+   *
+   * @param label label string
+   */
+  uint32_t intern(const std::string &label);
+
+  /**
+   * Finds id of label, without inserting it
+   *
+   * @param label label string
+   * @param id id of label, set if label is found
+   *
+   * @return true if dictionary contains label
+   */
+  bool find(const std::string &label, uint32_t &id) const;
+
+  /**
+   * Returns label string of label id
+   *
+   * @param id label id
+   */
+  const std::string &name(uint32_t id) const { return names[id]; }
+
+  /**
+   * Returns number of labels in dictionary
+   */
+  size_t size() const { return names.size(); }
+
+  /**
+   * Compiles labels of search to LabelMask
+   *
+   * @param label labels that each vertex on path has to have
+   *
+   * @return mask of label ids, not satisfiable if one of labels is not in
+   * dictionary
+   */
+  LabelMask compile(const std::vector<std::string> &label) const;
+
+  /**
+   * Returns label strings of set, sorted
+   *
+   * @param labels set of label ids
+   */
+  std::vector<std::string> labelNames(const LabelSet &labels) const;
+};
+
+inline uint32_t LabelDictionary::intern(const std::string &label) {
+  auto it = ids.find(label);
+  if (it != ids.end())
+    return it->second;
+  uint32_t id = static_cast<uint32_t>(names.size());
+  ids.emplace(label, id);
+  names.push_back(label);
+  return id;
+}
+
+inline bool LabelDictionary::find(const std::string &label,
+                                  uint32_t &id) const {
+  auto it = ids.find(label);
+  if (it == ids.end())
+    return false;
+  id = it->second;
+  return true;
+}
+
+inline LabelMask
+LabelDictionary::compile(const std::vector<std::string> &label) const {
+  LabelMask mask;
+  for (const auto &l : label) {
+    uint32_t id = 0;
+    if (!find(l, id)) {
+      mask.satisfiable = false;
+    } else if (id < LabelSet::inlineLabels) {
+      mask.bits |= uint64_t(1) << id;
+    } else {
+      mask.overflow.push_back(id);
+    }
+  }
+  std::sort(mask.overflow.begin(), mask.overflow.end());
+  mask.overflow.erase(std::unique(mask.overflow.begin(), mask.overflow.end()),
+                      mask.overflow.end());
+  return mask;
+}
+
+inline std::vector<std::string>
+LabelDictionary::labelNames(const LabelSet &labels) const {
+  std::vector<std::string> result;
+  for (auto id : labels.ids()) {
+    result.push_back(names[id]);
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+} // namespace graph
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "compressedVertexSet.h"
+#include "labelSet.h"
+
+namespace graph {
+
+/**
+ * Implementation of the LabelIndex class.
+ *
+ * LabelIndex is an inverted index of vertex labels. For each label id it keeps
+ * CompressedVertexSet of ids of vertices that have the label, so vertices that
+ * have all labels of a LabelMask are found by intersection of sets of its
+ * labels, without checking every vertex of graph.
+ */
+class LabelIndex {
+private:
+  /**
+   * Sets of vertex ids, indexed by label id
+   */
+  std::vector<CompressedVertexSet> sets;
+
+public:
+  /**
+   * Adds vertex id to set of label id
+   *
+   * @param labelId label id
+   * @param vertex vertex id
+   */
+  void add(uint32_t labelId, uint32_t vertex);
+
+  /**
+   * Removes vertex id from set of label id
+   *
+   * @param labelId label id
+   * @param vertex vertex id
+   */
+  void remove(uint32_t labelId, uint32_t vertex);
+
+  /**
+   * Returns set of vertex ids that have label id
+   *
+   * @param labelId label id
+   */
+  const CompressedVertexSet &vertices(uint32_t labelId) const;
+
+  /**
+   * Returns set of vertex ids that have all labels of mask. Sets are
+   * intersected from the smallest one, mask should not be empty.
+   *
+   * @param mask compiled labels
+   */
+  CompressedVertexSet find(const LabelMask &mask) const;
+
+  /**
+   * Sets bits of vertex ids that have all labels of mask in words, that are
+   * cleared before. Set of each label is written to scratch and intersected
+   * with words, so no set is copied.
+   *
+   * @param mask compiled labels
+   * @param words bitmap of vertex ids, cleared, large enough for all ids
+   * @param scratch bitmap used for sets of labels after the first one
+   */
+  void findBits(const LabelMask &mask, std::vector<uint64_t> &words,
+                std::vector<uint64_t> &scratch) const;
+};
+
+inline void LabelIndex::add(uint32_t labelId, uint32_t vertex) {
+  if (labelId >= sets.size())
+    sets.resize(labelId + 1);
+  sets[labelId].add(vertex);
+}
+
+inline void LabelIndex::remove(uint32_t labelId, uint32_t vertex) {
+  if (labelId < sets.size())
+    sets[labelId].remove(vertex);
+}
+
+inline const CompressedVertexSet &
+LabelIndex::vertices(uint32_t labelId) const {
+  static const CompressedVertexSet emptySet;
+  return labelId < sets.size() ? sets[labelId] : emptySet;
+}
+
+inline CompressedVertexSet LabelIndex::find(const LabelMask &mask) const {
+  if (!mask.satisfiable)
+    return CompressedVertexSet();
+
+  std::vector<const CompressedVertexSet *> labelSets;
+  for (uint64_t bits = mask.bits; bits != 0; bits &= bits - 1) {
+    labelSets.push_back(
+        &vertices(static_cast<uint32_t>(__builtin_ctzll(bits))));
+  }
+  for (auto labelId : mask.overflow) {
+    labelSets.push_back(&vertices(labelId));
+  }
+  if (labelSets.empty())
+    return CompressedVertexSet();
+
+  // intersection is never larger than the smallest set, so starting from it
+  // keeps all intermediate results small
+  std::sort(labelSets.begin(), labelSets.end(),
+            [](const CompressedVertexSet *a, const CompressedVertexSet *b) {
+              return a->size() < b->size();
+            });
+  CompressedVertexSet result = *labelSets[0];
+  for (size_t i = 1; i < labelSets.size() && !result.empty(); ++i) {
+    result = CompressedVertexSet::intersect(result, *labelSets[i]);
+  }
+  return result;
+}
+
+inline void LabelIndex::findBits(const LabelMask &mask,
+                                 std::vector<uint64_t> &words,
+                                 std::vector<uint64_t> &scratch) const {
+  if (!mask.satisfiable)
+    return;
+  bool first = true;
+  auto intersect = [&](uint32_t labelId) {
+    if (first) {
+      vertices(labelId).setBits(words);
+      first = false;
+      return;
+    }
+    scratch.assign(words.size(), 0);
+    vertices(labelId).setBits(scratch);
+    for (size_t word = 0; word < words.size(); ++word) {
+      words[word] &= scratch[word];
+    }
+  };
+  for (uint64_t bits = mask.bits; bits != 0; bits &= bits - 1) {
+    intersect(static_cast<uint32_t>(__builtin_ctzll(bits)));
+  }
+  for (auto labelId : mask.overflow) {
+    intersect(labelId);
+  }
+}
+
+} // namespace graph
@@ -0,0 +1,256 @@
+#pragma once
+
+#include "labelDictionary.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Implementation of the StaticLabelMask structure.
+ *
+ * StaticLabelMask is a label requirement of a search known at compile time,
+ * as bits of label ids of BitmaskLabels. Check of vertex against it is AND and
+ * compare with constant, and mask without bits is no check at all, with every
+ * label policy.
+ *
+ * @tparam Bits bits of label ids of search
+ */
+template <uint64_t Bits> struct StaticLabelMask {
+  static constexpr uint64_t bits = Bits; ///< Bits of label ids of search
+};
+
+/**
+ * Implementation of the NoLabels label policy of GraphStore.
+ *
+ * Vertices of graph have no labels, so there is nothing stored for them and
+ * every vertex matches every search. Checks of labels are constant true and
+ * compiler removes them from traversal loop.
+ */
+struct NoLabels {
+  /// True if vertices of graph have labels
+  static constexpr bool enabled = false;
+
+  /**
+   * Label of vertex, graph has none
+   */
+  struct Label {};
+
+  /// Compiled labels of search
+  using Mask = StaticLabelMask<0>;
+
+  /**
+   * Adds vertex without labels
+   */
+  void addVertex() {}
+
+  /**
+   * Compiles labels of search, only search without labels can find path
+   *
+   * @param labels labels of search
+   * @param mask compiled labels
+   *
+   * @return false if no vertex can have labels
+   */
+  bool compile(const std::vector<Label> &labels, Mask &) const {
+    return labels.empty();
+  }
+
+  /**
+   * Returns true, every vertex matches search
+   */
+  template <typename AnyMask>
+  static constexpr bool matches(uint32_t, const AnyMask &) {
+    return true;
+  }
+};
+
+/**
+ * Implementation of the BitmaskLabels label policy of GraphStore.
+ *
+ * Labels are ids 0..63 given by caller, each vertex keeps them as bits of one
+ * word. Labels of search are compiled to one word, or given as
+ * StaticLabelMask, then check of vertex is AND and compare with constant.
+ */
+class BitmaskLabels {
+private:
+  /**
+   * Bits of labels of vertices, indexed by dense index
+   */
+  std::vector<uint64_t> bits;
+
+public:
+  /// True if vertices of graph have labels
+  static constexpr bool enabled = true;
+
+  /// Number of label ids
+  static constexpr uint32_t maxLabels = 64;
+
+  /// Label of vertex, id smaller than maxLabels
+  using Label = uint32_t;
+
+  /// Compiled labels of search
+  using Mask = uint64_t;
+
+  /**
+   * Adds vertex without labels
+   */
+  void addVertex() { bits.push_back(0); }
+
+  /**
+   * Adds label to vertex with dense index, returns false if label id is not
+   * smaller than maxLabels
+   */
+  bool add(uint32_t index, Label label) {
+    if (label >= maxLabels)
+      return false;
+    bits[index] |= uint64_t(1) << label;
+    return true;
+  }
+
+  /**
+   * Removes label from vertex with dense index, returns true if vertex had it
+   */
+  bool remove(uint32_t index, Label label) {
+    if (!contains(index, label))
+      return false;
+    bits[index] &= ~(uint64_t(1) << label);
+    return true;
+  }
+
+  /**
+   * Returns true if vertex with dense index has label
+   */
+  bool contains(uint32_t index, Label label) const {
+    return label < maxLabels && ((bits[index] >> label) & 1) != 0;
+  }
+
+  /**
+   * Compiles labels of search to bits
+   *
+   * @param labels labels of search
+   * @param mask compiled labels
+   *
+   * @return false if no vertex can have labels
+   */
+  bool compile(const std::vector<Label> &labels, Mask &mask) const {
+    mask = 0;
+    for (auto label : labels) {
+      if (label >= maxLabels)
+        return false;
+      mask |= uint64_t(1) << label;
+    }
+    return true;
+  }
+
+  /**
+   * Returns true if vertex with dense index has all labels of mask
+   */
+  bool matches(uint32_t index, Mask mask) const {
+    return (bits[index] & mask) == mask;
+  }
+
+  /**
+   * Returns true if vertex with dense index has all labels of mask known at
+   * compile time, mask without bits is not checked
+   */
+  template <uint64_t Bits>
+  bool matches(uint32_t index, StaticLabelMask<Bits>) const {
+    if constexpr (Bits == 0)
+      return true;
+    else
+      return (bits[index] & Bits) == Bits;
+  }
+};
+
+/**
+ * Implementation of the StringLabels label policy of GraphStore.
+ *
+ * Labels are strings, interned in LabelDictionary of graph, and each vertex
+ * keeps LabelSet of their ids, as vertices of GraphStoreLinked do. Label ids
+ * are given at run time, so only StaticLabelMask without bits is known at
+ * compile time.
+ */
+class StringLabels {
+private:
+  /**
+   * Dictionary of labels of all vertices
+   */
+  LabelDictionary dictionary;
+
+  /**
+   * Label ids of vertices, indexed by dense index
+   */
+  std::vector<LabelSet> sets;
+
+public:
+  /// True if vertices of graph have labels
+  static constexpr bool enabled = true;
+
+  /// Label of vertex
+  using Label = std::string;
+
+  /// Compiled labels of search
+  using Mask = LabelMask;
+
+  /**
+   * Adds vertex without labels
+   */
+  void addVertex() { sets.emplace_back(); }
+
+  /**
+   * Adds label to vertex with dense index
+   */
+  bool add(uint32_t index, const Label &label) {
+    sets[index].add(dictionary.intern(label));
+    return true;
+  }
+
+  /**
+   * Removes label from vertex with dense index, returns true if vertex had it
+   */
+  bool remove(uint32_t index, const Label &label) {
+    uint32_t id = 0;
+    return dictionary.find(label, id) && sets[index].remove(id);
+  }
+
+  /**
+   * Returns true if vertex with dense index has label
+   */
+  bool contains(uint32_t index, const Label &label) const {
+    uint32_t id = 0;
+    return dictionary.find(label, id) && sets[index].contains(id);
+  }
+
+  /**
+   * Compiles labels of search to LabelMask
+   *
+   * @param labels labels of search
+   * @param mask compiled labels
+   *
+   * @return false if no vertex can have labels
+   */
+  bool compile(const std::vector<Label> &labels, Mask &mask) const {
+    mask = dictionary.compile(labels);
+    return mask.satisfiable;
+  }
+
+  /**
+   * Returns true if vertex with dense index has all labels of mask
+   */
+  bool matches(uint32_t index, const Mask &mask) const {
+    return sets[index].containsAll(mask);
+  }
+
+  /**
+   * Returns true, mask without bits is not checked
+   */
+  template <uint64_t Bits>
+  static constexpr bool matches(uint32_t, StaticLabelMask<Bits>) {
+    static_assert(Bits == 0, "label ids of StringLabels are given at run time");
+    return true;
+  }
+};
+
+} // namespace graph
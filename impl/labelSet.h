@@ -0,0 +1,210 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Implementation of the LabelMask structure.
+ *
+ * LabelMask is a label requirement of a search, compiled once from label
+ * strings by LabelDictionary. Labels with id smaller than 64 are set as bits of
+ * bits, other label ids are stored sorted in overflow. If one of the labels is
+ * not known to the dictionary, no vertex can have it and satisfiable is false.
+ */
+struct LabelMask {
+  uint64_t bits = 0;              ///< Bits of labels with id < 64
+  std::vector<uint32_t> overflow; ///< Sorted ids of labels with id >= 64
+  bool satisfiable = true;        ///< False if a label is not in dictionary
+
+  /**
+   * Returns true if mask has no labels, so every vertex matches it
+   */
+  bool empty() const { return satisfiable && bits == 0 && overflow.empty(); }
+};
+
+/**
+ * Implementation of the LabelSet class.
+ *
+ * LabelSet is a set of label ids of one vertex. Labels with id smaller than 64
+ * are kept as bits of one word, so the check if vertex has all labels of a
+ * LabelMask is one AND and compare. Ids of rarely used labels, that get ids
+ * after first 64 labels, are kept sorted in overflow vector, that is allocated
+ * only when vertex has such a label.
+ */
+class LabelSet {
+private:
+  /**
+   * Bits of labels with id < 64
+   */
+  uint64_t bits = 0;
+
+  /**
+   * Sorted ids of labels with id >= 64, nullptr if there are none
+   */
+  std::unique_ptr<std::vector<uint32_t>> overflow = nullptr;
+
+public:
+  /// Number of label ids that are stored as bits
+  static constexpr uint32_t inlineLabels = 64;
+
+  /**
+   * Constructor of LabelSet
+   *
+   * Constructor takes no arguments, set is empty.
+   */
+  LabelSet() = default;
+
+  /**
+   * Copy constructor of LabelSet, overflow vector is copied
+   *
+   * @param rhs set that is copied
+   */
+  LabelSet(const LabelSet &rhs);
+
+  /**
+   * Copy assignment of LabelSet, overflow vector is copied
+   *
+   * @param rhs set that is copied
+   */
+  LabelSet &operator=(const LabelSet &rhs);
+
+  /**
+   * Move constructor of LabelSet, overflow vector is moved
+   *
+   * @param rhs set that is moved
+   */
+  LabelSet(LabelSet &&rhs) noexcept = default;
+
+  /**
+   * Move assignment of LabelSet, overflow vector is moved
+   *
+   * @param rhs set that is moved
+   */
+  LabelSet &operator=(LabelSet &&rhs) noexcept = default;
+
+  /**
+   * Adds label id to set
+   *
+   * @param id label id
+   */
+  void add(uint32_t id);
+
+  /**
+   * Removes label id from set, returns true if set contained id
+   *
+   * @param id label id
+   */
+  bool remove(uint32_t id);
+
+  /**
+   * Returns true if set contains label id
+   *
+   * @param id label id
+   */
+  bool contains(uint32_t id) const;
+
+  /**
+   * Returns true if set contains all labels of mask
+   *
+   * @param mask compiled labels of search
+   */
+  bool containsAll(const LabelMask &mask) const {
+    return (bits & mask.bits) == mask.bits && mask.satisfiable &&
+           (mask.overflow.empty() || containsOverflow(mask));
+  }
+
+  /**
+   * Returns true if set contains all labels of mask with id >= 64
+   *
+   * @param mask compiled labels of search
+   */
+  bool containsOverflow(const LabelMask &mask) const;
+
+  /**
+   * Returns bits of labels with id < 64
+   */
+  uint64_t inlineBits() const { return bits; }
+
+  /**
+   * Returns true if set has labels with id >= 64
+   */
+  bool hasOverflow() const { return overflow != nullptr; }
+
+  /**
+   * Returns all label ids of set, in ascending order
+   */
+  std::vector<uint32_t> ids() const;
+};
+
+inline LabelSet::LabelSet(const LabelSet &rhs) : bits(rhs.bits) {
+  if (rhs.overflow != nullptr)
+    overflow = std::make_unique<std::vector<uint32_t>>(*rhs.overflow);
+}
+
+inline LabelSet &LabelSet::operator=(const LabelSet &rhs) {
+  if (this != &rhs) {
+    bits = rhs.bits;
+    overflow = rhs.overflow != nullptr
+                   ? std::make_unique<std::vector<uint32_t>>(*rhs.overflow)
+                   : nullptr;
+  }
+  return *this;
+}
+
+inline void LabelSet::add(uint32_t id) {
+  if (id < inlineLabels) {
+    bits |= uint64_t(1) << id;
+    return;
+  }
+  if (overflow == nullptr)
+    overflow = std::make_unique<std::vector<uint32_t>>();
+  auto it = std::lower_bound(overflow->begin(), overflow->end(), id);
+  if (it == overflow->end() || *it != id)
+    overflow->insert(it, id);
+}
+
+inline bool LabelSet::remove(uint32_t id) {
+  if (id < inlineLabels) {
+    bool found = contains(id);
+    bits &= ~(uint64_t(1) << id);
+    return found;
+  }
+  if (overflow == nullptr)
+    return false;
+  auto it = std::lower_bound(overflow->begin(), overflow->end(), id);
+  if (it == overflow->end() || *it != id)
+    return false;
+  overflow->erase(it);
+  if (overflow->empty())
+    overflow = nullptr;
+  return true;
+}
+
+inline bool LabelSet::contains(uint32_t id) const {
+  if (id < inlineLabels)
+    return (bits >> id) & 1;
+  return overflow != nullptr &&
+         std::binary_search(overflow->begin(), overflow->end(), id);
+}
+
+inline bool LabelSet::containsOverflow(const LabelMask &mask) const {
+  return overflow != nullptr &&
+         std::includes(overflow->begin(), overflow->end(),
+                       mask.overflow.begin(), mask.overflow.end());
+}
+
+inline std::vector<uint32_t> LabelSet::ids() const {
+  std::vector<uint32_t> result;
+  for (uint64_t word = bits; word != 0; word &= word - 1) {
+    result.push_back(static_cast<uint32_t>(__builtin_ctzll(word)));
+  }
+  if (overflow != nullptr)
+    result.insert(result.end(), overflow->begin(), overflow->end());
+  return result;
+}
+
+} // namespace graph
@@ -0,0 +1,468 @@
+#pragma once
+
+#include "graphFile.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Ways of choosing landmarks of LandmarkIndex
+ */
+enum class LandmarkSelection {
+  Farthest, ///< each next landmark is the vertex farthest from chosen ones
+  Degree    ///< vertices with the most edges and incoming edges
+};
+
+/**
+ * Header of landmark file
+ */
+struct LandmarkFileHeader {
+  char magic[8];          ///< "GRAPHALT"
+  uint32_t version;       ///< version of format
+  uint32_t byteOrder;     ///< 0x01020304 in byte order of file
+  uint64_t vertexCount;   ///< number of vertices of distance arrays
+  uint64_t landmarkCount; ///< number of landmarks
+  uint64_t fingerprint;   ///< fingerprint of graph that landmarks belong to
+  uint64_t dataChecksum;  ///< checksum of all bytes after header
+  uint64_t headerChecksum; ///< checksum of header before this field
+};
+
+/// Magic bytes at start of landmark file
+constexpr char landmarkFileMagic[8] = {'G', 'R', 'A', 'P', 'H', 'A', 'L', 'T'};
+
+/// Version of landmark file format
+constexpr uint32_t landmarkFileVersion = 1;
+
+/**
+ * Implementation of the LandmarkIndex class.
+ *
+ * LandmarkIndex keeps distances from a few landmark vertices to every vertex
+ * and from every vertex to landmarks, for A* search with landmarks (ALT). By
+ * triangle inequality, distance from u to t is at least d(L, t) - d(L, u) and
+ * d(u, L) - d(t, L) for each landmark L, and the largest of these differences
+ * is lower bound that leads search towards t. Vertex that can not reach a
+ * landmark that t reaches, or is reached by a landmark that does not reach t,
+ * has no path to t at all.
+ *
+ * Distances of one vertex to and from all landmarks are next to each other,
+ * so lower bound of vertex reads two short arrays. New edge only shortens
+ * distances, so distances are updated from the edge on, over vertices whose
+ * distance gets shorter. Removed edges and vertices make distances longer,
+ * distances kept from before removal are still lower bounds, so they are not
+ * updated.
+ *
+ * Graph given to methods of index is a view with vertexCount(), live(index),
+ * forEachEdge(index, visit) and forEachIncoming(index, visit), that visit
+ * dense indices of live edges and incoming edges of vertex.
+ */
+class LandmarkIndex {
+public:
+  /// Distance of vertex that is not reached
+  static constexpr int32_t infinity = std::numeric_limits<int32_t>::max();
+
+private:
+  /**
+   * Dense indices of landmarks
+   */
+  std::vector<uint32_t> landmarks;
+
+  /**
+   * Distances from landmarks to vertices and from vertices to landmarks,
+   * distance of vertex v and landmark l at v * landmarks.size() + l
+   */
+  std::vector<int32_t> fromLandmark, toLandmark;
+
+  /**
+   * Number of vertices of distance arrays, vertices added later have no
+   * distances until edge is inserted
+   */
+  size_t vertices = 0;
+
+  /**
+   * Queue of breadth first searches and updates
+   */
+  std::vector<uint32_t> queue;
+
+  /**
+   * Sets distances from source vertex, if forward is true, or to source
+   * vertex, with breadth first search. Distance of vertex v is
+   * distances[v * stride], distances are infinity before search
+   */
+  template <typename Graph>
+  void search(const Graph &graph, uint32_t source, bool forward,
+              int32_t *distances, size_t stride);
+
+  /**
+   * Shortens distances of landmark with position l after edge was inserted,
+   * from stop vertex on if forward is true, or from start vertex back over
+   * incoming edges otherwise
+   */
+  template <typename Graph>
+  void propagate(const Graph &graph, size_t l, uint32_t start, uint32_t stop,
+                 bool forward);
+
+  /**
+   * Grows distance arrays to vertices of graph, with distances of infinity
+   */
+  void grow(size_t vertexCount);
+
+public:
+  /**
+   * Chooses landmarks and computes their distances, index is cleared first
+   *
+   * @param graph view of graph
+   * @param count number of landmarks, fewer if graph has fewer live vertices
+   * with edges
+   * @param selection way of choosing landmarks
+   */
+  template <typename Graph>
+  void build(const Graph &graph, unsigned count, LandmarkSelection selection);
+
+  /**
+   * Computes distances of the same landmarks again, used when many edges were
+   * inserted at once
+   *
+   * @param graph view of graph
+   */
+  template <typename Graph> void rebuild(const Graph &graph);
+
+  /**
+   * Updates distances after edge from start to stop vertex was inserted
+   *
+   * @param graph view of graph, edge is already inserted
+   * @param start dense index of source Vertex
+   * @param stop dense index of destination Vertex
+   */
+  template <typename Graph>
+  void insertEdge(const Graph &graph, uint32_t start, uint32_t stop);
+
+  /**
+   * Removes landmarks and their distances
+   */
+  void clear();
+
+  /**
+   * Returns true if index has no landmarks
+   */
+  bool empty() const { return landmarks.empty(); }
+
+  /**
+   * Returns dense indices of landmarks
+   */
+  const std::vector<uint32_t> &landmarkVertices() const { return landmarks; }
+
+  /**
+   * Returns lower bound of distance from vertex u to vertex t, infinity if
+   * there is no path from u to t, 0 if vertex is newer than distances
+   *
+   * @param u dense index of Vertex
+   * @param t dense index of destination Vertex
+   */
+  int32_t lowerBound(uint32_t u, uint32_t t) const;
+
+  /**
+   * Saves landmarks and distances to landmark file
+   *
+   * @param path path of file, file is replaced
+   * @param fingerprint fingerprint of graph, checked by open
+   *
+   * @return true if file is written
+   */
+  bool save(const std::string &path, uint64_t fingerprint) const;
+
+  /**
+   * Reads landmarks and distances from landmark file, index is not changed
+   * if file is not valid or belongs to other graph
+   *
+   * @param path path of file
+   * @param vertexCount number of vertices of graph
+   * @param fingerprint fingerprint of graph
+   *
+   * @return true if file is read
+   */
+  bool open(const std::string &path, size_t vertexCount, uint64_t fingerprint);
+};
+
+inline void LandmarkIndex::grow(size_t vertexCount) {
+  if (vertexCount <= vertices)
+    return;
+  vertices = vertexCount;
+  fromLandmark.resize(vertices * landmarks.size(), infinity);
+  toLandmark.resize(vertices * landmarks.size(), infinity);
+}
+
+inline void LandmarkIndex::clear() {
+  landmarks.clear();
+  std::vector<int32_t>().swap(fromLandmark);
+  std::vector<int32_t>().swap(toLandmark);
+  vertices = 0;
+}
+
+template <typename Graph>
+void LandmarkIndex::search(const Graph &graph, uint32_t source, bool forward,
+                           int32_t *distances, size_t stride) {
+  distances[source * stride] = 0;
+  queue.assign(1, source);
+  for (size_t i = 0; i < queue.size(); i++) {
+    uint32_t u = queue[i];
+    int32_t next = distances[u * stride] + 1;
+    auto visit = [&](uint32_t v) {
+      if (distances[v * stride] == infinity) {
+        distances[v * stride] = next;
+        queue.push_back(v);
+      }
+    };
+    if (forward)
+      graph.forEachEdge(u, visit);
+    else
+      graph.forEachIncoming(u, visit);
+  }
+}
+
+template <typename Graph>
+void LandmarkIndex::build(const Graph &graph, unsigned count,
+                          LandmarkSelection selection) {
+  clear();
+  size_t n = graph.vertexCount();
+  std::vector<uint32_t> degrees(n, 0);
+  for (uint32_t index = 0; index < n; index++) {
+    if (!graph.live(index))
+      continue;
+    graph.forEachEdge(index, [&](uint32_t) { ++degrees[index]; });
+    graph.forEachIncoming(index, [&](uint32_t) { ++degrees[index]; });
+  }
+  // isolated vertices are never landmarks, they bound nothing
+  std::vector<uint32_t> candidates;
+  for (uint32_t index = 0; index < n; index++) {
+    if (degrees[index] > 0)
+      candidates.push_back(index);
+  }
+  count = static_cast<unsigned>(std::min<size_t>(count, candidates.size()));
+  if (count == 0)
+    return;
+
+  if (selection == LandmarkSelection::Degree) {
+    std::partial_sort(candidates.begin(), candidates.begin() + count,
+                      candidates.end(), [&](uint32_t a, uint32_t b) {
+                        if (degrees[a] != degrees[b])
+                          return degrees[a] > degrees[b];
+                        return a < b;
+                      });
+    landmarks.assign(candidates.begin(), candidates.begin() + count);
+    rebuild(graph);
+    return;
+  }
+
+  // the first landmark is vertex with the most edges, each next one is
+  // vertex with the largest distance, in either direction, to its nearest
+  // landmark. Vertex that no landmark reaches is the farthest of all, so
+  // every component gets a landmark before second one gets another
+  landmarks.reserve(count);
+  landmarks.push_back(*std::max_element(
+      candidates.begin(), candidates.end(), [&](uint32_t a, uint32_t b) {
+        return degrees[a] < degrees[b];
+      }));
+  std::vector<int32_t> nearest(n, infinity);
+  std::vector<int32_t> from, to;
+  for (unsigned l = 0;; l++) {
+    from.assign(n, infinity);
+    to.assign(n, infinity);
+    search(graph, landmarks[l], true, from.data(), 1);
+    search(graph, landmarks[l], false, to.data(), 1);
+    for (uint32_t index = 0; index < n; index++) {
+      nearest[index] = std::min({nearest[index], from[index], to[index]});
+    }
+    if (l + 1 == count)
+      break;
+    uint32_t farthest = candidates.front();
+    for (auto index : candidates) {
+      if (nearest[index] > nearest[farthest] ||
+          (nearest[index] == nearest[farthest] &&
+           degrees[index] > degrees[farthest]))
+        farthest = index;
+    }
+    if (nearest[farthest] == 0)
+      break;
+    landmarks.push_back(farthest);
+  }
+  rebuild(graph);
+}
+
+template <typename Graph> void LandmarkIndex::rebuild(const Graph &graph) {
+  vertices = graph.vertexCount();
+  fromLandmark.assign(vertices * landmarks.size(), infinity);
+  toLandmark.assign(vertices * landmarks.size(), infinity);
+  for (size_t l = 0; l < landmarks.size(); l++) {
+    search(graph, landmarks[l], true, fromLandmark.data() + l,
+           landmarks.size());
+    search(graph, landmarks[l], false, toLandmark.data() + l,
+           landmarks.size());
+  }
+}
+
+template <typename Graph>
+void LandmarkIndex::propagate(const Graph &graph, size_t l, uint32_t start,
+                              uint32_t stop, bool forward) {
+  size_t k = landmarks.size();
+  std::vector<int32_t> &distances = forward ? fromLandmark : toLandmark;
+  uint32_t from = forward ? start : stop;
+  uint32_t to = forward ? stop : start;
+  if (distances[from * k + l] == infinity ||
+      distances[from * k + l] + 1 >= distances[to * k + l])
+    return;
+  distances[to * k + l] = distances[from * k + l] + 1;
+  // distances only get shorter, vertex is queued again when its distance
+  // gets shorter again, so updated distances are exact
+  queue.assign(1, to);
+  for (size_t i = 0; i < queue.size(); i++) {
+    uint32_t u = queue[i];
+    int32_t next = distances[u * k + l] + 1;
+    auto visit = [&](uint32_t v) {
+      if (next < distances[v * k + l]) {
+        distances[v * k + l] = next;
+        queue.push_back(v);
+      }
+    };
+    if (forward)
+      graph.forEachEdge(u, visit);
+    else
+      graph.forEachIncoming(u, visit);
+  }
+}
+
+template <typename Graph>
+void LandmarkIndex::insertEdge(const Graph &graph, uint32_t start,
+                               uint32_t stop) {
+  if (landmarks.empty())
+    return;
+  grow(graph.vertexCount());
+  for (size_t l = 0; l < landmarks.size(); l++) {
+    propagate(graph, l, start, stop, true);
+    propagate(graph, l, start, stop, false);
+  }
+}
+
+inline int32_t LandmarkIndex::lowerBound(uint32_t u, uint32_t t) const {
+  if (u >= vertices || t >= vertices)
+    return 0;
+  size_t k = landmarks.size();
+  const int32_t *fromU = fromLandmark.data() + u * k;
+  const int32_t *fromT = fromLandmark.data() + t * k;
+  const int32_t *toU = toLandmark.data() + u * k;
+  const int32_t *toT = toLandmark.data() + t * k;
+  int32_t bound = 0;
+  for (size_t l = 0; l < k; l++) {
+    // d(L, t) <= d(L, u) + d(u, t), landmark that reaches u and not t shows
+    // that u does not reach t
+    if (fromU[l] != infinity) {
+      if (fromT[l] == infinity)
+        return infinity;
+      bound = std::max(bound, fromT[l] - fromU[l]);
+    }
+    // d(u, L) <= d(u, t) + d(t, L), vertex u that does not reach landmark
+    // that t reaches does not reach t
+    if (toT[l] != infinity) {
+      if (toU[l] == infinity)
+        return infinity;
+      bound = std::max(bound, toU[l] - toT[l]);
+    }
+  }
+  return bound;
+}
+
+inline bool LandmarkIndex::save(const std::string &path,
+                                uint64_t fingerprint) const {
+  std::FILE *file = std::fopen(path.c_str(), "wb");
+  if (file == nullptr)
+    return false;
+  LandmarkFileHeader header{};
+  std::memcpy(header.magic, landmarkFileMagic, sizeof(header.magic));
+  header.version = landmarkFileVersion;
+  header.byteOrder = 0x01020304u;
+  header.vertexCount = vertices;
+  header.landmarkCount = landmarks.size();
+  header.fingerprint = fingerprint;
+
+  // header is written again when checksum of data is known
+  std::fwrite(&header, sizeof(header), 1, file);
+  // landmarks are padded to whole words, distances of both arrays fill whole
+  // words together, so every byte of data is in checksum
+  GraphFileWriter writer(file, sizeof(header));
+  const uint32_t padding = 0;
+  writer.write(landmarks.data(), landmarks.size() * sizeof(uint32_t));
+  if (landmarks.size() % 2 != 0)
+    writer.write(&padding, sizeof(padding));
+  writer.write(fromLandmark.data(), fromLandmark.size() * sizeof(int32_t));
+  writer.write(toLandmark.data(), toLandmark.size() * sizeof(int32_t));
+  header.dataChecksum = writer.checksum();
+  header.headerChecksum = graphFileChecksum(
+      0, reinterpret_cast<const uint64_t *>(&header),
+      offsetof(LandmarkFileHeader, headerChecksum) / sizeof(uint64_t));
+  bool ok = writer.ok() && std::fseek(file, 0, SEEK_SET) == 0 &&
+            std::fwrite(&header, sizeof(header), 1, file) == 1;
+  return std::fclose(file) == 0 && ok;
+}
+
+inline bool LandmarkIndex::open(const std::string &path, size_t vertexCount,
+                                uint64_t fingerprint) {
+  std::FILE *file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr)
+    return false;
+  LandmarkFileHeader header{};
+  bool ok = std::fread(&header, sizeof(header), 1, file) == 1 &&
+            std::memcmp(header.magic, landmarkFileMagic,
+                        sizeof(header.magic)) == 0 &&
+            header.version == landmarkFileVersion &&
+            header.byteOrder == 0x01020304u &&
+            header.headerChecksum ==
+                graphFileChecksum(
+                    0, reinterpret_cast<const uint64_t *>(&header),
+                    offsetof(LandmarkFileHeader, headerChecksum) /
+                        sizeof(uint64_t)) &&
+            header.vertexCount == vertexCount &&
+            header.fingerprint == fingerprint && header.landmarkCount > 0 &&
+            header.landmarkCount <= 64;
+  std::vector<uint32_t> readLandmarks;
+  std::vector<int32_t> readFrom, readTo;
+  if (ok) {
+    size_t k = static_cast<size_t>(header.landmarkCount);
+    size_t landmarkBytes = (k + k % 2) * sizeof(uint32_t);
+    size_t distanceBytes = vertexCount * k * sizeof(int32_t);
+    std::vector<uint64_t> words((landmarkBytes + 2 * distanceBytes) /
+                                sizeof(uint64_t));
+    unsigned char *data = reinterpret_cast<unsigned char *>(words.data());
+    ok = std::fread(data, sizeof(uint64_t), words.size(), file) ==
+             words.size() &&
+         graphFileChecksum(0, words.data(), words.size()) ==
+             header.dataChecksum;
+    if (ok) {
+      readLandmarks.resize(k);
+      readFrom.resize(vertexCount * k);
+      readTo.resize(vertexCount * k);
+      std::memcpy(readLandmarks.data(), data, k * sizeof(uint32_t));
+      std::memcpy(readFrom.data(), data + landmarkBytes, distanceBytes);
+      std::memcpy(readTo.data(), data + landmarkBytes + distanceBytes,
+                  distanceBytes);
+      for (auto landmark : readLandmarks) {
+        ok = ok && landmark < vertexCount;
+      }
+    }
+  }
+  std::fclose(file);
+  if (!ok)
+    return false;
+  landmarks.swap(readLandmarks);
+  fromLandmark.swap(readFrom);
+  toLandmark.swap(readTo);
+  vertices = vertexCount;
+  return true;
+}
+
+} // namespace graph
@@ -1,9 +1,33 @@
 #pragma once
 
+#include "concurrentIngest.h"
+#include "connectivityIndex.h"
+#include "contractionHierarchy.h"
+#include "csrSnapshot.h"
+#include "directionOptimizingBfs.h"
+#include "edgeListReader.h"
+#include "flatHashMap.h"
+#include "frontierQueue.h"
+#include "graphArena.h"
+#include "graphFile.h"
+#include "graphVersion.h"
+#include "labelIndex.h"
+#include "landmarkIndex.h"
 #include "linkedVertices.h"
-#include <deque>
-#include <list>
-#include <map>
+#include "mutationLog.h"
+#include "parallelFor.h"
+#include "pathCache.h"
+#include "pathQuery.h"
+#include "queryContext.h"
+#include "shortestPathTree.h"
+#include "workStealingPool.h"
+#include <atomic>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
+#include <mutex>
+#include <numeric>
+#include <type_traits>
 
 namespace graph {
 
@@ -12,21 +36,231 @@ namespace graph {
  * modified linked list to insert vertices and edges. When the vertex is
  * created, it is inserted as a head vertex in LinkedVertices class, by adding
  * edges to this vertex, we add edge vertex to a vector of edges in
- * LinkedVertices. Each created LinkedVertices object is inserted in map
- * vertexList, where key is an id of head vertex. Map was chosen because it
- * provides an efficient search of vertices.
+ * LinkedVertices. Each created LinkedVertices object gets dense index, in order
+ * of insertion, and is inserted in vector vertexList at that index. Keys of
+ * vertices are mapped to dense indices once, with FlatHashMap vertexIds, and
+ * labels and search elements of vertices are kept in arrays indexed by dense
+ * index, so searches do not look up keys at all.
  *
+ * LinkedVertices, their vectors of edges and arrays of vertices are allocated
+ * from memory resource of graph, GraphArena by default, so that inserting a
+ * vertex does not call global allocator and graph is freed in bulk.
+ *
+ * Removed vertices and edges are only marked as removed, vertex in array of
+ * removed vertices and edge in place in its vector, and searches skip them.
+ * When share of removed edges crosses threshold, compaction removes them,
+ * and parallel edges, from vectors of edges of a few vertices with each
+ * change of graph, so no change waits for compaction of whole graph.
+ *
+ * @tparam V type of data stored in graph vertices
+ * @tparam Resource std::pmr::memory_resource that graph allocates from, it is
+ * default constructible or constructible from upstream memory resource
  */
-template <typename V> class LinkedListOfVertices {
+template <typename V, typename Resource = GraphArena>
+class LinkedListOfVertices {
 private:
   /**
-   * Map of pair < key of head vertex, ptr to entire LinkedVertices<V> that
-   * containes head Vertex and all of the edges connected to head vertex>
+   * Memory resource that vertices, edges and arrays of vertices are allocated
+   * from, declared first so that it is destroyed last
+   */
+  Resource arena;
+
+  /**
+   * Vector of ptrs to entire LinkedVertices<V> that containes head Vertex and
+   * all of the edges connected to head vertex, indexed by dense index of head
+   * vertex. LinkedVertices are allocated from arena
+   */
+  std::pmr::vector<LinkedVertices<V> *> vertexList{&arena};
+
+  /**
+   * Map of pair < key of head vertex, dense index of head vertex >
+   */
+  FlatHashMap<int, uint32_t> vertexIds;
+
+  /**
+   * Keys of vertices, indexed by dense index
+   */
+  std::pmr::vector<int> keys{&arena};
+
+  /**
+   * Label ids of vertices, indexed by dense index
+   */
+  std::pmr::vector<LabelSet> labels{&arena};
+
+  /// Dense index used for no vertex
+  static constexpr uint32_t noVertex = QueryContext<V>::noVertex;
+
+  /**
+   * Removed vertices, 1 for removed vertex, indexed by dense index. Removed
+   * vertex keeps its dense index and its key is erased from vertexIds
+   */
+  std::pmr::vector<uint8_t> removed{&arena};
+
+  /**
+   * Number of edges in vectors of edges, removed edges included, and estimate
+   * of removed edges among them. Edges of removed vertex and edges to it are
+   * counted as removed
+   */
+  size_t storedEdges = 0;
+  size_t removedEdges = 0;
+
+  /**
+   * Share of removed edges of stored edges after which compaction starts,
+   * 0 if compaction runs only with compact()
+   */
+  double compactionThreshold = 0.25;
+
+  /**
+   * True while compaction runs, dense index of next vertex that is compacted
+   * and number of edges removed since compaction started
+   */
+  bool compacting = false;
+  uint32_t compactionCursor = 0;
+  size_t removedSinceCompaction = 0;
+
+  /**
+   * Marks of vertices seen by compaction in vector of edges, indexed by dense
+   * index, and mark of next vector. Kept only while compaction runs
+   */
+  std::vector<uint32_t> compactionMarks;
+  uint32_t compactionStamp = 1;
+
+  /// Number of edges compacted with each change of graph while compaction runs
+  static constexpr size_t compactionStepEdges = 4096;
+
+  /**
+   * True while components are built again after compaction pass, dense index
+   * of next vertex that is added to them and components of vertices before
+   * it. Built components replace connectivity when all vertices are added
+   */
+  bool rebuildingConnectivity = false;
+  uint32_t connectivityCursor = 0;
+  ConnectivityIndex rebuiltConnectivity;
+
+  /**
+   * Returns true if edge is not removed and does not lead to removed vertex
+   *
+   * @param edge dense index of edge from vector of edges
+   */
+  bool liveEdge(uint32_t edge) const {
+    return edge != LinkedVertices<V>::removedEdge && !removed[edge];
+  }
+
+  /**
+   * Counts removed edges and starts compaction if share of removed edges
+   * crossed threshold
+   *
+   * @param count number of removed edges
+   */
+  void edgesRemoved(size_t count);
+
+  /**
+   * Compacts vectors of edges of next vertices, until about given number of
+   * edges is compacted or compaction reaches the last vertex. When compaction
+   * pass finishes, the rest of edges goes to building components again
+   *
+   * @param edges number of edges that are compacted
+   *
+   * @return number of removed edges and incoming edges
+   */
+  size_t compactStep(size_t edges);
+
+  /**
+   * Compacts edges of next vertices if compaction runs, or builds components
+   * of next vertices after it, called after each change of vertices and edges
+   */
+  void compactIfDue() {
+    if (compacting || rebuildingConnectivity)
+      compactStep(compactionStepEdges);
+  }
+
+  /**
+   * Adds next vertices and their live edges to rebuiltConnectivity, until
+   * about given number of edges is added, and replaces connectivity with it
+   * when the last vertex is added, so removed vertices and edges split
+   * components
+   *
+   * @param edges number of edges that are added
+   */
+  void rebuildConnectivityStep(size_t edges);
+
+  /**
+   * Dictionary of labels of all vertices, vertices store label ids
+   */
+  LabelDictionary labelDictionary;
+
+  /**
+   * Inverted index of labels, sets of dense indices of vertices with each
+   * label id
+   */
+  LabelIndex labelIndex;
+
+  /**
+   * Weakly connected components of graph, updated by every new vertex and
+   * edge, so searches between vertices of different components are rejected
+   * without search
+   */
+  ConnectivityIndex connectivity;
+
+  /**
+   * View of graph given to landmarkIndex and hierarchy, visits live edges
+   * and incoming edges of vertices
+   */
+  struct IndexView {
+    const LinkedListOfVertices &graph; ///< viewed graph
+
+    size_t vertexCount() const { return graph.vertexList.size(); }
+    bool live(uint32_t index) const { return !graph.removed[index]; }
+    template <typename Visit>
+    void forEachEdge(uint32_t index, Visit visit) const {
+      for (auto v : graph.vertexList[index]->returnEdges()) {
+        if (graph.liveEdge(v))
+          visit(v);
+      }
+    }
+    template <typename Visit>
+    void forEachIncoming(uint32_t index, Visit visit) const {
+      for (auto v : graph.vertexList[index]->returnIncomingEdges()) {
+        if (graph.liveEdge(v))
+          visit(v);
+      }
+    }
+  };
+
+  /**
+   * Distances to and from landmarks, used by searches in Landmarks mode.
+   * Updated by every new edge once landmarks are built
+   */
+  LandmarkIndex landmarkIndex;
+
+  /**
+   * Contraction hierarchy of graph, used by searches in ContractionHierarchy
+   * mode while edges are not changed after it was built
+   */
+  ContractionHierarchy hierarchy;
+
+  /**
+   * Generation of edges that hierarchy was built from
+   */
+  uint64_t hierarchyGeneration = 0;
+
+  /**
+   * Returns true if hierarchy is built from current edges of graph
+   */
+  bool hierarchyCurrent() const {
+    return hierarchy.vertexCount() != 0 &&
+           hierarchy.vertexCount() == vertexList.size() &&
+           hierarchyGeneration == edgeGeneration;
+  }
+
+  /**
+   * Returns fingerprint of graph that landmark file is checked against, of
+   * keys of vertices and live edges
    */
-  std::map<int, std::shared_ptr<LinkedVertices<V>>> vertexList = {};
+  uint64_t landmarkFingerprint() const;
 
   /**
-   * Checks if key of vertex is inserted in vertexList map.
+   * Checks if key of vertex is inserted in vertexIds map.
    *
    * @param key key id of Vertex
    * return true if vertex is inserted in vertexList
@@ -34,26 +268,330 @@ private:
   bool keyFoundInVertexListAsHead(int key);
 
   /**
-   * Used in Dijkstra algorithm, copy of qBackUp entries
+   * CSR snapshot of vertexList, used for searches when graph is frozen.
+   * Snapshot is rebuilt by the first search after graph was changed, so it
+   * is guarded by snapshotMutex
+   */
+  mutable std::shared_ptr<CsrSnapshot<V>> csrSnapshot = nullptr;
+
+  /**
+   * Guards rebuild of csrSnapshot by concurrent searches
+   */
+  mutable std::mutex snapshotMutex;
+
+  /**
+   * Set to true by freeze(), searches then run over csrSnapshot
+   */
+  bool snapshotEnabled = false;
+
+  /**
+   * Set to true when vertices or edges are inserted after csrSnapshot was
+   * built, snapshot is rebuilt before it is used again
+   */
+  mutable std::atomic<bool> snapshotStale{true};
+
+  /**
+   * Returns CSR snapshot of graph, snapshot is built first if graph was changed
+   * after the last build. Concurrent searches build it only once
+   */
+  const CsrSnapshot<V> &currentSnapshot() const;
+
+  /**
+   * Pool that runs batches of shortest path queries, started by the first
+   * batch
+   */
+  mutable std::unique_ptr<WorkStealingPool> pool = nullptr;
+
+  /**
+   * Query contexts of workers of pool, one for each worker
+   */
+  mutable std::vector<QueryContext<V>> workerContexts;
+
+  /**
+   * Guards pool, one batch runs at a time
+   */
+  mutable std::mutex batchMutex;
+
+  /**
+   * Number of threads of pool, 0 for number of hardware threads
+   */
+  unsigned batchThreads = 0;
+
+  /**
+   * Generation of graph, incremented by every change of vertices, edges and
+   * labels
+   */
+  uint64_t graphGeneration = 0;
+
+  /**
+   * Generation of the last change of edges
+   */
+  uint64_t edgeGeneration = 0;
+
+  /**
+   * Generations of the last changes of labels, by label id
+   */
+  std::vector<uint64_t> labelGenerations;
+
+  /**
+   * Cache of results of findShortestPath, disabled until capacity is set
+   */
+  mutable PathCache pathCache;
+
+  /**
+   * Guards pathCache, searches on many threads share it
    */
-  std::list<int> q;
+  mutable std::mutex cacheMutex;
 
   /**
-   * Used in Dijkstra algorithm, all keys of edges inserted in vertexList, no
-   * duplicates and sorted
+   * Vertices, edges and labels added by many threads while concurrent ingest
+   * runs, nullptr otherwise
    */
-  std::list<int> qBackUp;
+  std::unique_ptr<ConcurrentIngest<V>> ingest = nullptr;
 
   /**
-   * Used in Dijkstra algorithm to print out shortest path between two Vertices
+   * Write-ahead log of mutations of graph, nullptr if graph is not logged
    */
-  std::deque<int> path;
+  std::unique_ptr<MutationLog<V>> mutationLog = nullptr;
 
   /**
-   * Added parameter for testing purposes, if set to true, there is a console
-   * display of Vertices on shortest path between 2 given Vertices
+   * Size of group of records of log and size of log after which checkpoint
+   * is written, given to log when it is opened
    */
-  bool enableOutputPrint = true;
+  size_t logGroupBytes = MutationLogWriter<V>::defaultGroupBytes;
+  uint64_t logCheckpointBytes = 0;
+
+  /**
+   * Writes checkpoint of log if log grew past its size, called after each
+   * logged mutation
+   */
+  void checkpointLogIfDue() {
+    if (mutationLog->checkpointDue())
+      checkpointLog();
+  }
+
+  /**
+   * Latest published version of graph, loaded and stored atomically, so
+   * readers pin it while writer publishes next one
+   */
+  std::shared_ptr<const GraphVersion<V>> publishedVersion =
+      std::make_shared<const GraphVersion<V>>();
+
+  /**
+   * Dictionary of labels of latest published version, copied again only when
+   * new labels were interned
+   */
+  std::shared_ptr<const LabelDictionary> publishedDictionary;
+
+  /**
+   * Generation of graph of latest published version
+   */
+  uint64_t publishedGeneration = 0;
+
+  /**
+   * Number of changes of graph after which new version is published, 0 for
+   * versions published only by publish()
+   */
+  uint64_t publishInterval = 0;
+
+  /**
+   * Chunks of vertices and keys changed since latest published version, only
+   * they are built again for next version
+   */
+  VersionChanges versionChanges;
+
+  /**
+   * Publishes new version if graph was changed publishInterval times since
+   * the last version was published
+   */
+  void publishIfDue();
+
+  /**
+   * Unites components of two vertices, roots of both components are marked
+   * as changed in versionChanges, since one of them gets a parent
+   *
+   * @param start dense index of vertex
+   * @param stop dense index of vertex
+   */
+  void uniteComponents(uint32_t start, uint32_t stop) {
+    uint32_t startRoot = connectivity.component(start);
+    uint32_t stopRoot = connectivity.component(stop);
+    if (connectivity.unite(start, stop)) {
+      versionChanges.vertex(startRoot);
+      versionChanges.vertex(stopRoot);
+    }
+    // components that are built again get edge too, if both vertices were
+    // already added to them
+    if (rebuildingConnectivity && start < connectivityCursor &&
+        stop < connectivityCursor)
+      rebuiltConnectivity.unite(start, stop);
+  }
+
+  /**
+   * Returns generation since which cached results of searches with mask are
+   * valid. Changes of edges make all results stale, changes of label only
+   * results of searches with that label. New vertices have no edges, so they
+   * do not change results of other vertices
+   *
+   * @param mask compiled label of search
+   */
+  uint64_t validSince(const LabelMask &mask) const;
+
+  /**
+   * Sets generation of labels to new generation of graph
+   *
+   * @param labelIds ids of changed labels
+   */
+  void labelsChanged(const std::vector<uint32_t> &labelIds);
+
+  /**
+   * Searches shortest path between start and stop vertex with search of given
+   * mode and fills path of context. Search is not started if stop vertex does
+   * not have labels
+   *
+   * @param start dense index of source Vertex
+   * @param stop dense index of destination Vertex
+   * @param mask compiled label of Vertices found on shortest path
+   * @param context state of search, begun for this search
+   * @param mode search mode
+   */
+  void searchPath(uint32_t start, uint32_t stop, const LabelMask &mask,
+                  QueryContext<V> &context, SearchMode mode) const;
+
+  /**
+   * Returns query context of calling thread, used by searches that are not
+   * given a context. Storage of context is reused by all searches of thread
+   */
+  static QueryContext<V> &threadContext();
+
+  /**
+   * Searches shortest paths from start vertex to all target vertices over
+   * vertexList, with one Dijkstra search that ends when every target is
+   * visited. Paths are left in previous vertices of context
+   *
+   * @param start dense index of source Vertex
+   * @param targets sorted dense indices of destination Vertices, that have
+   * labels, without duplicates
+   * @param mask compiled label of Vertices found on shortest path
+   * @param context state of search, begun for this search
+   */
+  void searchTargets(uint32_t start, const std::vector<uint32_t> &targets,
+                     const LabelMask &mask, QueryContext<V> &context) const;
+
+  /**
+   * Answers group of queries of batch, that have the same start vertex and
+   * labels, or one query in bidirectional mode
+   *
+   * @param queries queries of batch
+   * @param masks compiled labels of queries
+   * @param group positions of queries of group in queries
+   * @param results results of batch, results of group are set
+   * @param context state of search
+   */
+  void answerGroup(const std::vector<PathQuery> &queries,
+                   const std::vector<LabelMask> &masks,
+                   const std::vector<size_t> &group,
+                   std::vector<PathResult> &results,
+                   QueryContext<V> &context) const;
+
+  /**
+   * Searches shortest path between start and stop vertex over vertexList and
+   * fills path of context, used by findShortestPath when graph is not frozen
+   *
+   * @param start dense index of source Vertex
+   * @param stop dense index of destination Vertex
+   * @param mask compiled label of Vertices found on shortest path
+   * @param context state of search
+   */
+  void searchVertexList(uint32_t start, uint32_t stop, const LabelMask &mask,
+                        QueryContext<V> &context) const;
+
+  /**
+   * Searches shortest path between start and stop vertex over vertexList with
+   * A* algorithm, lower bounds of distances to stop vertex are taken from
+   * landmarkIndex, and fills path of context
+   *
+   * @param start dense index of source Vertex
+   * @param stop dense index of destination Vertex
+   * @param mask compiled label of Vertices found on shortest path
+   * @param context state of search
+   */
+  void searchLandmarks(uint32_t start, uint32_t stop, const LabelMask &mask,
+                       QueryContext<V> &context) const;
+
+  /**
+   * Searches shortest path between start and stop vertex in hierarchy, with
+   * upward searches from both vertices, and fills path of context
+   *
+   * @param start dense index of source Vertex
+   * @param stop dense index of destination Vertex
+   * @param context state of search
+   */
+  void searchHierarchy(uint32_t start, uint32_t stop,
+                       QueryContext<V> &context) const;
+
+  /**
+   * Searches shortest path between start and stop vertex over vertexList from
+   * both vertices, using edges and incoming edges of LinkedVertices, and fills
+   * path of context
+   *
+   * @param start dense index of source Vertex
+   * @param stop dense index of destination Vertex
+   * @param mask compiled label of Vertices found on shortest path
+   * @param context state of search
+   */
+  void searchBidirectional(uint32_t start, uint32_t stop,
+                           const LabelMask &mask,
+                           QueryContext<V> &context) const;
+
+  /**
+   * Expands one level of bidirectional search, from start vertex if forward
+   * is true, or from stop vertex otherwise. Returns dense index of vertex where
+   * the two searches meet on the shortest path, or noVertex if they did not
+   * meet.
+   *
+   * @param forward true for search from start vertex
+   * @param start dense index of source Vertex
+   * @param mask compiled label of Vertices found on shortest path
+   * @param context state of search
+   */
+  uint32_t expandBidirectionalLevel(bool forward, uint32_t start,
+                                    const LabelMask &mask,
+                                    QueryContext<V> &context) const;
+
+  /**
+   * Reserves vertexList, vertexIds and arrays of vertices for count more
+   * vertices
+   *
+   * @param count number of vertices that will be inserted
+   */
+  void reserveVertices(size_t count);
+
+  /// Smallest number of edges given to each thread of insertEdges
+  static constexpr size_t minEdgesPerThread = size_t(1) << 14;
+
+  /**
+   * Inserts edges of range as insertEdges does, or, if parallel is true,
+   * keeps edges that range has more than once and edges that graph already
+   * has, as parallel edges. Edges kept as parallel edges are logged one by
+   * one, so replay of log keeps them too
+   *
+   * @tparam edges range of pairs < id of source Vertex, id of destination
+   * Vertex >
+   * @param threads number of threads, 0 for number of hardware threads
+   * @param parallel true to keep parallel edges
+   *
+   * @return number of inserted edges
+   */
+  template <typename Range>
+  size_t insertEdgeRange(const Range &edges, unsigned threads, bool parallel);
+
+  /**
+   * Copies new labels of vertex to csrSnapshot, if snapshot is up to date
+   *
+   * @param index dense index of Vertex
+   */
+  void patchSnapshotLabels(uint32_t index);
 
 public:
   /**
@@ -64,10 +602,20 @@ public:
    */
   LinkedListOfVertices() = default;
 
+  /**
+   * Constructor of LinkedListOfVertices
+   *
+   * @param upstream memory resource that arena of graph takes memory from
+   */
+  explicit LinkedListOfVertices(std::pmr::memory_resource *upstream)
+      : arena(upstream) {}
+
   /**
    * Destructor  of Linked List
    *
-   * Default implementation.
+   * LinkedVertices are destroyed, if their memory has to be given back to
+   * arena one by one. With GraphArena and data that does not need destructor,
+   * arena frees all of them at once.
    *
    */
   ~LinkedListOfVertices();
@@ -81,15 +629,16 @@ public:
   /**
    * Add Vertex to Graph
    *
-   * This method checks if this vertex is already inserted in vertexList, if
-   * yes, it returns false. If vertex is not already inserted, new pair is
-   * created in vertexList, that has key parameter as key of vertexList and
-   * LinkedVertices is created, with the head vertex with key as vertex id.
+   * This method checks if this vertex is already inserted in vertexIds, if
+   * yes, it returns false. If vertex is not already inserted, vertex gets next
+   * dense index, pair of key and dense index is inserted in vertexIds and
+   * LinkedVertices is created, with the head vertex with key as vertex id, and
+   * appended to vertexList.
    *
    * @param key id of Vertex
    * @tparam info Vertex info
    *
-   * @return true if vertexList does not contain this key
+   * @return true if vertexIds does not contain this key
    */
   bool insertNodeVertexAsHead(int key, const V &info);
 
@@ -97,9 +646,8 @@ public:
    * Create Edge in Graph
    *
    * This method checks if both start and stop vertex are already inserted in
-   * vertexList, if not, it returns false. If they are, vertexList is searched
-   * for start key and in LinkedVertices, that has a head with this key, stop
-   * vertex is added in vector of edges.
+   * vertexList, if not, it returns false. If they are, in LinkedVertices, that
+   * has a head with start key, stop vertex is added in vector of edges.
    *
    * @param start id of source Vertex
    * @param stop id of destination Vertex
@@ -109,246 +657,2071 @@ public:
   bool addEdgeToHeadNodeVertex(int start, int stop);
 
   /**
-   * Add Label to Vertex
-   *
-   * This method checks if this vertex is inserted in vertexList, if
-   * yes, it returns true. Before return, LinkedVertices method void
-   * addLabel(const std::string &label) is called, that inserts label in
-   * labelVec of head vertex.
+   * Removes vertex with key from graph, with its edges and incoming edges.
+   * Vertex is marked as removed at once, its edges stay in vectors of edges
+   * until they are compacted and searches skip them. Vertex keeps its dense
+   * index and key can be inserted again, as new vertex. Vertex can not be
+   * removed while concurrent ingest runs
    *
-   * @param key id of Vertex
-   * @param label Vertex label
+   * @param key key id of Vertex
    *
-   * @return true if if vertexList has key vertex
+   * @return true if vertex is removed, false if graph does not have it
    */
-  bool addLabelToVertex(int key, const std::vector<std::string> &label);
+  bool removeVertex(int key);
 
   /**
-   * Add Label to Vertex
+   * Removes edge from start vertex to stop vertex, with its parallel edges.
+   * Edge is found by scan of edges of start vertex and incoming edges of stop
+   * vertex, so removal takes time linear in their degrees, and is marked as
+   * removed in place, so other edges are not moved. Components are not split
+   * until they are built again after compaction pass. Edge can not be removed
+   * while concurrent ingest runs
    *
-   * This method checks if this vertex is inserted in vertexList, if
-   * yes, it returns true. Before return, LinkedVertices method void
-   * removeLabel(const std::string &label) is called, that removes label from
-   * labelVec of head vertex.
+   * @param start key id of source Vertex
+   * @param stop key id of destination Vertex
    *
-   * @param key id of Vertex
-   * @param label Vertex label
+   * @return true if edge is removed, false if graph does not have it
+   */
+  bool removeEdge(int start, int stop);
+
+  /**
+   * Compacts vectors of edges of all vertices at once. Removed edges, edges of
+   * removed vertices and parallel edges are removed, and vectors that shrink
+   * give their memory back to memory resource of graph. Components are then
+   * built again from live edges at once too. Results of searches are not
+   * changed, so snapshot, cache and published version are kept
    *
-   * @return true if if vertexList has key vertex
+   * @return number of removed edges and incoming edges
    */
-  bool removeLabelFromVertex(int key, const std::vector<std::string> &label);
+  size_t compact();
 
   /**
-   * This method checks if this vertex is inserted in vertexList, if
-   * yes, it calls for LinkedVertices method void getVertexInfo(int key) const
-   * on head vertex.
+   * Sets share of removed edges, of all edges in vectors of edges, after
+   * which compaction starts on its own. Compaction then compacts edges of a
+   * few vertices with each change of vertices and edges, until all vertices
+   * are compacted
    *
-   * @param key key id of Vertex
+   * @param threshold share of removed edges, 0 to compact only with compact()
    */
-  void getVertexInfo(int key);
+  void setCompactionThreshold(double threshold) {
+    compactionThreshold = threshold;
+  }
 
   /**
-   * Finds shortest path between two Vertices in Graph
+   * Add Vertices to Graph
    *
-   * This method uses Dijkstra algorithm. Step by step explenation is given in
-   * function comments.
+   * Storage of graph is reserved once for all vertices, then each vertex is
+   * inserted as with insertNodeVertexAsHead. Vertices with keys that are
+   * already inserted are skipped. While concurrent ingest runs, vertices are
+   * added to ingest and storage is not reserved, since threads of ingest read
+   * keys of graph.
    *
-   * @tparam start key id of source Vertex
-   * @tparam stop key id of destination Vertex
-   * @param label label of Vertices found on shortest path
+   * @tparam vertices range of pairs < key id of Vertex, Vertex info >
    *
-   * @return true if there is a path between two vertices, where each vertex on
-   * the path has label
+   * @return number of inserted vertices
    */
-  bool findShortestPath(int start, int stop, std::vector<std::string> &label);
+  template <typename Range> size_t insertVertices(const Range &vertices);
 
   /**
-   * Disables console print of Vertices that are found in function
-   * shortestPath(int start, int stop, std::vector<std::string>
-   * &label).
+   * Create Edges in Graph
+   *
+   * Keys of edges are resolved to dense indices, edges are sorted by start
+   * and stop vertex and duplicates are removed, both duplicates in range and
+   * edges that graph already has. Vectors of edges and incoming edges of each
+   * vertex are then reserved once and filled in one pass. Edges with start or
+   * stop vertex that is not inserted are skipped.
+   *
+   * Edges are split in parts by dense index of start vertex and each part is
+   * resolved, sorted and appended on its own thread. Ranges that are not
+   * random access, and small ranges, use fewer threads. Edges are not
+   * inserted while concurrent ingest runs, ingest keeps parallel edges and
+   * this method removes them.
+   *
+   * @tparam edges range of pairs < id of source Vertex, id of destination
+   * Vertex >
+   * @param threads number of threads, 0 for number of hardware threads
    *
-   * Helper function added for testing purposes, when benchmark is run.
+   * @return number of inserted edges, 0 while concurrent ingest runs
    */
-  void disableOutputPrint() { enableOutputPrint = false; }
-};
-
-template <typename V> LinkedListOfVertices<V>::~LinkedListOfVertices() {}
+  template <typename Range>
+  size_t insertEdges(const Range &edges, unsigned threads = 1);
 
-template <typename V>
-bool LinkedListOfVertices<V>::keyFoundInVertexListAsHead(int key) {
-  if (vertexList.find(key) != vertexList.end())
-    return true;
-  return false;
-}
+  /**
+   * Starts concurrent ingest
+   *
+   * Until endIngest() is called, insertNodeVertexAsHead,
+   * addEdgeToHeadNodeVertex and addLabelToVertex can be called by many threads
+   * at the same time. They collect vertices, edges and labels in
+   * ConcurrentIngest, with the same results as they have on graph: vertex with
+   * key that graph has, or that was added, is rejected, edge and label are
+   * rejected if their vertices were not added. Graph itself is not changed, so
+   * searches of graph and of its versions still see graph as it was.
+   * insertVertices also adds vertices to ingest. insertEdges, removeVertex,
+   * removeEdge and removeLabelFromVertex are rejected while ingest runs, and
+   * no other method that changes graph is called.
+   */
+  void beginIngest();
 
-template <typename V>
-bool LinkedListOfVertices<V>::insertNodeVertexAsHead(int key, const V &info) {
-  if (keyFoundInVertexListAsHead(key))
-    return false;
-  else {
-    vertexList.insert(std::pair<int, std::shared_ptr<LinkedVertices<V>>>(
-        key, std::make_shared<LinkedVertices<V>>(key, info)));
-    return true;
+  /**
+   * Ends concurrent ingest and inserts collected vertices, edges and labels
+   * in graph, with insertVertices and bulk insert of edges. Called when no
+   * thread adds anything. Edge that was added more than once, or that graph
+   * already has, is inserted as parallel edge, as addEdgeToHeadNodeVertex
+   * does without ingest
+   *
+   * @param threads number of threads of insertEdges, 0 for number of hardware
+   * threads
+   *
+   * @return number of inserted edges, parallel edges included
+   */
+  size_t endIngest(unsigned threads = 0);
+
+  /**
+   * Returns true while concurrent ingest runs
+   */
+  bool ingesting() const { return ingest != nullptr; }
+
+  /**
+   * Loads edges of text edge list file in Graph
+   *
+   * File has one edge per line, "start stop", comments start with '#' or '%'.
+   * File is read with EdgeListReader, in chunks that are parsed on threads,
+   * and edges of each chunk are inserted with insertEdges before next chunk
+   * is read, so memory used besides graph is bounded by size of chunk.
+   * Vertices of edges that are not in graph are inserted first, with given
+   * info, in order in which their keys appear in file. Not called while
+   * concurrent ingest runs.
+   *
+   * @param path path of file
+   * @param info Vertex info of inserted vertices
+   * @param threads number of threads, 0 for number of hardware threads
+   * @param chunkBytes size of chunk of file that is read at once
+   *
+   * @return number of inserted edges, 0 if file can not be opened
+   */
+  size_t loadEdgeList(const std::string &path, const V &info = V(),
+                      unsigned threads = 1,
+                      size_t chunkBytes = EdgeListReader::defaultChunkBytes);
+
+  /**
+   * Loads labels of text label file in Graph
+   *
+   * File has key of vertex and its labels on each line, "key label label
+   * ...", and is read in chunks as with loadEdgeList. Labels of vertices that
+   * are not in graph are skipped.
+   *
+   * @param path path of file
+   * @param threads number of threads that parse file, 0 for number of
+   * hardware threads
+   * @param chunkBytes size of chunk of file that is read at once
+   *
+   * @return number of labels added to vertices, 0 if file can not be opened
+   */
+  size_t loadLabels(const std::string &path, unsigned threads = 1,
+                    size_t chunkBytes = EdgeListReader::defaultChunkBytes);
+
+  /**
+   * Opens write-ahead mutation log of graph
+   *
+   * Checkpoint and log that are already at path are replayed into graph
+   * first, so graph is recovered as it was at last commit. Then every new
+   * vertex, edge, added and removed label is appended to log, in groups that
+   * are committed when they reach size set with setLogGroupBytes(). Full
+   * group is written and synced by flusher thread of log, so mutations are
+   * durable after commitLog() returns. Graph is usually empty when log is
+   * opened, vertices that graph already has are written to checkpoint at
+   * once.
+   *
+   * @param path path of log file, checkpoint is kept in path.checkpoint
+   *
+   * @return false if log is already open, V has no LogCodec, or files can not
+   * be read or written
+   */
+  bool openLog(const std::string &path);
+
+  /**
+   * Commits and closes mutation log, graph is not logged any more
+   */
+  void closeLog() { mutationLog = nullptr; }
+
+  /**
+   * Commits records of mutation log that are not committed yet, so that they
+   * survive crash
+   *
+   * @return true if log is open and records are written and synced
+   */
+  bool commitLog() { return mutationLog != nullptr && mutationLog->commit(); }
+
+  /**
+   * Writes checkpoint of graph and starts empty log, so that recovery replays
+   * checkpoint and only mutations after it
+   *
+   * @return true if log is open and checkpoint is written
+   */
+  bool checkpointLog();
+
+  /**
+   * Sets size of group of records of mutation log, that is committed with one
+   * write and fdatasync
+   *
+   * @param bytes size of group, 0 to commit each mutation on its own
+   */
+  void setLogGroupBytes(size_t bytes) {
+    logGroupBytes = bytes;
+    if (mutationLog != nullptr)
+      mutationLog->writer().setGroupBytes(bytes);
+  }
+
+  /**
+   * Sets size of mutation log after which checkpoint is written on its own
+   *
+   * @param bytes size of log, 0 for checkpoints only with checkpointLog()
+   */
+  void setCheckpointBytes(uint64_t bytes) {
+    logCheckpointBytes = bytes;
+    if (mutationLog != nullptr)
+      mutationLog->setCheckpointBytes(bytes);
+  }
+
+  /**
+   * Add Label to Vertex
+   *
+   * This method checks if this vertex is inserted in vertexList, if
+   * yes, it returns true. Before return, each label is interned in
+   * labelDictionary and label id is inserted in labels of vertex. Vertex is
+   * added to labelIndex set of each label.
+   *
+   * @param key id of Vertex
+   * @param label Vertex label
+   *
+   * @return true if if vertexList has key vertex
+   */
+  bool addLabelToVertex(int key, const std::vector<std::string> &label);
+
+  /**
+   * Add Label to Vertex
+   *
+   * This method checks if this vertex is inserted in vertexList, if
+   * yes, it returns true if all labels were found. Before return, label id of
+   * each label is removed from labels of vertex. Vertex is removed from
+   * labelIndex set of each removed label.
+   *
+   * @param key id of Vertex
+   * @param label Vertex label
+   *
+   * @return true if if vertexList has key vertex, false while concurrent
+   * ingest runs
+   */
+  bool removeLabelFromVertex(int key, const std::vector<std::string> &label);
+
+  /**
+   * This method checks if this vertex is inserted in vertexList, if
+   * yes, it calls for LinkedVertices method void getVertexInfo(const
+   * LabelDictionary &dictionary, const LabelSet &labels) const on head vertex.
+   *
+   * @param key key id of Vertex
+   */
+  void getVertexInfo(int key);
+
+  /**
+   * Does nothing, searches do not print found paths any more, they are
+   * printed by caller with operator<< of PathResult.
+   *
+   * @deprecated kept for existing callers, helper function added for testing
+   * purposes, when benchmark is run
+   */
+  void disableOutputPrint() {}
+
+  /**
+   * Finds all Vertices that have all given labels
+   *
+   * Sets of vertices of each label are taken from labelIndex and intersected,
+   * so vertices without labels are never checked. If label is empty, all
+   * vertices are returned.
+   *
+   * @param label labels that each found Vertex has to have
+   *
+   * @return keys of found Vertices, in ascending order
+   */
+  std::vector<int> findVerticesWithLabel(const std::vector<std::string> &label);
+
+  /**
+   * Finds shortest path between two Vertices in Graph
+   *
+   * In Forward mode, this method uses Dijkstra algorithm, with FrontierQueue
+   * binary heap as a queue of reached vertices, or DirectionOptimizingBfs if
+   * graph is frozen. In Bidirectional mode, searches from start vertex over
+   * edges and from stop vertex over incoming edges are expanded level by level,
+   * until they meet. In Landmarks mode, A* search is led towards stop vertex
+   * by lower bounds of distances from landmarks, built by buildLandmarks(),
+   * or runs as Forward search if landmarks are not built. In
+   * ContractionHierarchy mode, searches from both vertices go only upwards in
+   * hierarchy built by buildContractionHierarchy(), or Forward search runs if
+   * hierarchy is not built from current edges or label is given. All modes find
+   * paths of the same length, but on equal lengths they can choose different
+   * paths. Vertices in different weakly
+   * connected components are rejected without search. Step by step
+   * explenation is given in function comments.
+   *
+   * Graph is not changed by search, all state of search is kept in query
+   * context of calling thread, so searches can run at the same time on many
+   * threads, as long as graph is not changed.
+   *
+   * @tparam start key id of source Vertex
+   * @tparam stop key id of destination Vertex
+   * @param label label of Vertices found on shortest path
+   * @param mode search mode
+   *
+   * @return true if there is a path between two vertices, where each vertex on
+   * the path has label
+   */
+  bool findShortestPath(int start, int stop,
+                        const std::vector<std::string> &label,
+                        SearchMode mode = SearchMode::Forward) const;
+
+  /**
+   * Finds shortest path between two Vertices in Graph, with given query
+   * context
+   *
+   * Same as findShortestPath(int start, int stop, const
+   * std::vector<std::string> &label, SearchMode mode), keys of vertices on
+   * found path, without stop vertex, are left in path of context.
+   *
+   * @tparam start key id of source Vertex
+   * @tparam stop key id of destination Vertex
+   * @param label label of Vertices found on shortest path
+   * @param context state of search, used by one thread at a time
+   * @param mode search mode
+   *
+   * @return true if there is a path between two vertices, where each vertex on
+   * the path has label
+   */
+  bool findShortestPath(int start, int stop,
+                        const std::vector<std::string> &label,
+                        QueryContext<V> &context,
+                        SearchMode mode = SearchMode::Forward) const;
+
+  /**
+   * Finds shortest path between two Vertices in Graph, into given result
+   *
+   * Same as findShortestPath(int start, int stop, const
+   * std::vector<std::string> &label, SearchMode mode), keys of vertices on
+   * found path, start and stop vertex included, and its distance are written
+   * to result. Storage of result path is reused, so searches with a reused
+   * result do not allocate, once result and context of thread have grown to
+   * size of paths and graph.
+   *
+   * @tparam start key id of source Vertex
+   * @tparam stop key id of destination Vertex
+   * @param label label of Vertices found on shortest path
+   * @param result found path, cleared first
+   * @param mode search mode
+   *
+   * @return true if there is a path between two vertices, where each vertex on
+   * the path has label
+   */
+  bool findShortestPath(int start, int stop,
+                        const std::vector<std::string> &label,
+                        PathResult &result,
+                        SearchMode mode = SearchMode::Forward) const;
+
+  /**
+   * Finds shortest paths of batch of queries
+   *
+   * Queries in Forward mode that have the same start vertex and labels are
+   * grouped and answered with one search from start vertex, that ends when all
+   * their stop vertices are visited. Groups, and queries in Bidirectional
+   * mode, are answered on WorkStealingPool, each worker with its own query
+   * context. Found paths are the same as paths found by findShortestPath.
+   *
+   * @param queries queries of batch
+   * @param results results of queries, in order of queries
+   */
+  void findShortestPaths(const std::vector<PathQuery> &queries,
+                         std::vector<PathResult> &results) const;
+
+  /**
+   * Sets number of threads that run batches of queries, pool is started again
+   * by the next batch
+   *
+   * @param threads number of threads, 0 for number of hardware threads
+   */
+  void setBatchThreads(unsigned threads);
+
+  /**
+   * Sets number of cached results of findShortestPath, cache is cleared
+   *
+   * Results are cached by start and stop vertex, search mode and labels, in
+   * any order. Cached result is used until graph is changed in a way that can
+   * change it: any change of edges, or change of one of its labels on any
+   * vertex. Capacity is set while no search runs.
+   *
+   * @param capacity maximum number of results, 0 disables cache
+   */
+  void setPathCacheCapacity(size_t capacity);
+
+  /**
+   * Returns counters of hits and misses of path cache
+   */
+  PathCacheStats pathCacheStats() const;
+
+  /**
+   * Returns generation of graph, that is incremented by every change of
+   * vertices, edges or labels
+   */
+  uint64_t generation() const { return graphGeneration; }
+
+  /**
+   * Checks if two Vertices are in the same weakly connected component, that is
+   * if they are connected when direction of edges is ignored. Vertices in
+   * different components have no path between them. Removed vertices and
+   * edges split components only when components are built again, in a few
+   * changes of graph after compaction pass, until then result is upper
+   * bound, vertices can stay in one component after edges between them were
+   * removed
+   *
+   * @param start key id of Vertex
+   * @param stop key id of Vertex
+   *
+   * @return true if both Vertices are in graph and in the same component
+   */
+  bool connected(int start, int stop) const;
+
+  /**
+   * Returns number of weakly connected components of graph. After vertices
+   * or edges are removed, components are counted as before removals, removed
+   * vertices included, until components are built again after compaction
+   * pass
+   */
+  size_t componentCount() const { return connectivity.components(); }
+
+  /**
+   * Finds shortest paths from start Vertex to all Vertices reached from it
+   *
+   * Search visits all vertices that can be reached from start vertex over
+   * vertices with labels, level by level, and keeps them in tree. Previous
+   * vertex of each reached vertex is its neighbor in previous level with the
+   * largest dense index, so paths in tree are the same as paths found by
+   * findShortestPath.
+   *
+   * @param start key id of start Vertex
+   * @param label label of Vertices on paths, start Vertex excluded
+   * @param tree found shortest path tree, cleared first
+   *
+   * @return true if start Vertex is in graph
+   */
+  bool findShortestPathTree(int start, const std::vector<std::string> &label,
+                            ShortestPathTree &tree) const;
+
+  /**
+   * Finds shortest paths from start Vertex to all Vertices reached from it,
+   * with given query context
+   *
+   * Same as findShortestPathTree(int start, const std::vector<std::string>
+   * &label, ShortestPathTree &tree).
+   *
+   * @param start key id of start Vertex
+   * @param label label of Vertices on paths, start Vertex excluded
+   * @param tree found shortest path tree, cleared first
+   * @param context state of search, used by one thread at a time
+   *
+   * @return true if start Vertex is in graph
+   */
+  bool findShortestPathTree(int start, const std::vector<std::string> &label,
+                            ShortestPathTree &tree,
+                            QueryContext<V> &context) const;
+
+  /**
+   * Compiles labels to mask of label ids of this graph
+   *
+   * @param label labels that each vertex on path has to have
+   */
+  LabelMask compileLabels(const std::vector<std::string> &label) const {
+    return labelDictionary.compile(label);
+  }
+
+  /**
+   * Builds CSR snapshot of graph and freezes graph, so that all following
+   * searches run over snapshot, with DirectionOptimizingBfs. Graph can still be
+   * changed, label changes are patched in snapshot, any other change makes
+   * snapshot rebuilt before the next search.
+   */
+  void freeze();
+
+  /**
+   * Releases CSR snapshot, searches run over vertexList again
+   */
+  void thaw();
+
+  /**
+   * Returns CSR snapshot of graph, snapshot is built first if graph was changed
+   * after the last build
+   */
+  const CsrSnapshot<V> &snapshot() const { return currentSnapshot(); }
+
+  /**
+   * Saves graph to binary graph file, that MappedGraph opens without
+   * rebuilding graph. Snapshot of frozen graph is written as it is, other
+   * graphs are written from snapshot built for save
+   *
+   * @param path path of file, file is replaced
+   *
+   * @return true if file is written
+   */
+  bool save(const std::string &path) const;
+
+  /**
+   * Chooses landmarks and computes distances from them to all vertices and
+   * from all vertices to them, used by searches in SearchMode::Landmarks.
+   * Distances are updated by every new edge afterwards
+   *
+   * @param count number of landmarks
+   * @param selection way of choosing landmarks
+   */
+  void
+  buildLandmarks(unsigned count,
+                 LandmarkSelection selection = LandmarkSelection::Farthest);
+
+  /**
+   * Returns number of landmarks, 0 if landmarks are not built
+   */
+  size_t landmarkCount() const {
+    return landmarkIndex.landmarkVertices().size();
+  }
+
+  /**
+   * Saves landmarks and their distances to landmark file, kept next to graph
+   * file or log of graph
+   *
+   * @param path path of file, file is replaced
+   *
+   * @return true if landmarks are built and file is written
+   */
+  bool saveLandmarks(const std::string &path) const;
+
+  /**
+   * Builds contraction hierarchy of graph, used by searches in
+   * SearchMode::ContractionHierarchy. Hierarchy is used until edges or
+   * vertices of graph are changed, then searches in this mode fall back to
+   * search over vertexList until it is built again
+   */
+  void buildContractionHierarchy() {
+    hierarchy.build(IndexView{*this});
+    hierarchyGeneration = edgeGeneration;
+  }
+
+  /**
+   * Returns number of shortcuts of contraction hierarchy, 0 if hierarchy is
+   * not built
+   */
+  size_t shortcutCount() const { return hierarchy.shortcutCount(); }
+
+  /**
+   * Reads landmarks and their distances from landmark file, saved from the
+   * same graph, with the same keys and edges
+   *
+   * @param path path of file
+   *
+   * @return true if file is read
+   */
+  bool openLandmarks(const std::string &path);
+
+  /**
+   * Publishes current graph as new GraphVersion
+   *
+   * Version is built on this thread and then replaces published version
+   * atomically, so readers that pinned older versions keep them and are not
+   * blocked. Only chunks of 64 vertices that were changed since the last
+   * version are built from vertex arrays of graph, all other chunks are
+   * shared with it, so publishing after each change costs edges of changed
+   * chunks and not size of graph. The first version, and the first version
+   * after components are built again, builds all chunks. Nothing is built if
+   * graph was not changed since the last version. Called by writer of graph.
+   */
+  void publish();
+
+  /**
+   * Sets number of changes of graph after which writer publishes new version
+   * on its own, so that versions pinned by readers stay at most that many
+   * changes behind graph
+   *
+   * @param changes number of changes, 0 for versions published only by
+   * publish()
+   */
+  void setPublishInterval(uint64_t changes) { publishInterval = changes; }
+
+  /**
+   * Returns latest published version of graph, that reader keeps for as long
+   * as it searches it. Can be called by many threads, while writer changes
+   * graph
+   */
+  std::shared_ptr<const GraphVersion<V>> pin() const {
+    return std::atomic_load(&publishedVersion);
+  }
+};
+
+template <typename V, typename Resource>
+LinkedListOfVertices<V, Resource>::~LinkedListOfVertices() {
+  if constexpr (!std::is_same_v<Resource, GraphArena> ||
+                !std::is_trivially_destructible_v<V>) {
+    std::pmr::polymorphic_allocator<LinkedVertices<V>> allocator(&arena);
+    for (auto vertex : vertexList) {
+      vertex->~LinkedVertices<V>();
+      allocator.deallocate(vertex, 1);
+    }
   }
 }
 
-template <typename V>
-bool LinkedListOfVertices<V>::addEdgeToHeadNodeVertex(int start, int stop) {
-  auto itStart = vertexList.find(start);
-  auto itStop = vertexList.find(stop);
+template <typename V, typename Resource>
+bool LinkedListOfVertices<V, Resource>::keyFoundInVertexListAsHead(int key) {
+  return vertexIds.contains(key);
+}
+
+template <typename V, typename Resource>
+bool LinkedListOfVertices<V, Resource>::insertNodeVertexAsHead(int key,
+                                                               const V &info) {
+  if (ingest != nullptr)
+    return ingest->addVertex(key, info);
+  uint32_t index = static_cast<uint32_t>(vertexList.size());
+  if (!vertexIds.insert(key, index))
+    return false;
+  std::pmr::polymorphic_allocator<LinkedVertices<V>> allocator(&arena);
+  LinkedVertices<V> *vertex = allocator.allocate(1);
+  new (vertex) LinkedVertices<V>(key, index, info, &arena);
+  vertexList.push_back(vertex);
+  keys.push_back(key);
+  labels.emplace_back();
+  removed.push_back(0);
+  connectivity.add();
+  versionChanges.vertex(index);
+  versionChanges.key(key, index);
+  snapshotStale = true;
+  ++graphGeneration;
+  if (mutationLog != nullptr) {
+    mutationLog->writer().addVertex(key, info);
+    checkpointLogIfDue();
+  }
+  compactIfDue();
+  publishIfDue();
+  return true;
+}
 
-  if (itStart != vertexList.end() && itStop != vertexList.end()) {
-    itStart->second->insertNodeVertex(itStop->second->getHead());
-    // if the vertexList has a lot of vertices, but not so many connected edges,
-    // it is more efficient to store keys of connected vertices in qBackUp list
-    // to be used in Dijkstra algorithm
-    qBackUp.push_back(start);
-    qBackUp.push_back(stop);
+template <typename V, typename Resource>
+bool LinkedListOfVertices<V, Resource>::addEdgeToHeadNodeVertex(int start,
+                                                                int stop) {
+  if (ingest != nullptr)
+    return ingest->addEdge(start, stop);
+  uint32_t startIndex = 0;
+  uint32_t stopIndex = 0;
+  if (vertexIds.find(start, startIndex) && vertexIds.find(stop, stopIndex)) {
+    vertexList[startIndex]->insertNodeVertex(stopIndex);
+    vertexList[stopIndex]->insertIncomingNodeVertex(startIndex);
+    versionChanges.vertex(startIndex);
+    versionChanges.vertex(stopIndex);
+    uniteComponents(startIndex, stopIndex);
+    if (!landmarkIndex.empty())
+      landmarkIndex.insertEdge(IndexView{*this}, startIndex, stopIndex);
+    ++storedEdges;
+    snapshotStale = true;
+    edgeGeneration = ++graphGeneration;
+    if (mutationLog != nullptr) {
+      mutationLog->writer().addEdge(start, stop);
+      checkpointLogIfDue();
+    }
+    compactIfDue();
+    publishIfDue();
     return true;
   }
   return false;
 }
 
-template <typename V>
-bool LinkedListOfVertices<V>::addLabelToVertex(
+template <typename V, typename Resource>
+bool LinkedListOfVertices<V, Resource>::removeVertex(int key) {
+  uint32_t index = 0;
+  if (ingest != nullptr || !vertexIds.find(key, index))
+    return false;
+  vertexIds.erase(key);
+  removed[index] = 1;
+  // labels are removed at once, so label index does not return vertex
+  std::vector<uint32_t> labelIds = labels[index].ids();
+  for (auto labelId : labelIds) {
+    labelIndex.remove(labelId, index);
+  }
+  labels[index] = LabelSet();
+  // vertex is left out of edges of its neighbors in next version
+  versionChanges.vertex(index);
+  versionChanges.key(key, VersionChanges::removedKey);
+  for (auto edges : {vertexList[index]->returnEdges(),
+                     vertexList[index]->returnIncomingEdges()}) {
+    for (auto v : edges) {
+      if (v != LinkedVertices<V>::removedEdge)
+        versionChanges.vertex(v);
+    }
+  }
+  edgesRemoved(vertexList[index]->returnEdges().size() +
+               vertexList[index]->returnIncomingEdges().size());
+  snapshotStale = true;
+  edgeGeneration = ++graphGeneration;
+  labelsChanged(labelIds);
+  if (mutationLog != nullptr) {
+    mutationLog->writer().removeVertex(key);
+    checkpointLogIfDue();
+  }
+  compactIfDue();
+  publishIfDue();
+  return true;
+}
+
+template <typename V, typename Resource>
+bool LinkedListOfVertices<V, Resource>::removeEdge(int start, int stop) {
+  uint32_t startIndex = 0;
+  uint32_t stopIndex = 0;
+  if (ingest != nullptr || !vertexIds.find(start, startIndex) ||
+      !vertexIds.find(stop, stopIndex))
+    return false;
+  size_t count = vertexList[startIndex]->removeNodeVertex(stopIndex);
+  if (count == 0)
+    return false;
+  vertexList[stopIndex]->removeIncomingNodeVertex(startIndex);
+  versionChanges.vertex(startIndex);
+  versionChanges.vertex(stopIndex);
+  // components are split only when they are built again after compaction
+  // pass, until then vertices may stay in one component without path between
+  // them and searches find no path
+  edgesRemoved(count);
+  snapshotStale = true;
+  edgeGeneration = ++graphGeneration;
+  if (mutationLog != nullptr) {
+    mutationLog->writer().removeEdge(start, stop);
+    checkpointLogIfDue();
+  }
+  compactIfDue();
+  publishIfDue();
+  return true;
+}
+
+template <typename V, typename Resource>
+void LinkedListOfVertices<V, Resource>::edgesRemoved(size_t count) {
+  removedEdges += count;
+  if (compacting) {
+    removedSinceCompaction += count;
+  } else if (compactionThreshold > 0 &&
+             double(removedEdges) > compactionThreshold * double(storedEdges)) {
+    compacting = true;
+    compactionCursor = 0;
+    removedSinceCompaction = 0;
+  }
+}
+
+template <typename V, typename Resource>
+size_t LinkedListOfVertices<V, Resource>::compactStep(size_t edges) {
+  // compaction does not change results of searches, so snapshot, cached
+  // paths and published version stay valid. Components are split only when
+  // they are built again after compaction pass, searches between them found
+  // no path before
+  size_t compacted = 0;
+  size_t removedCount = 0;
+  if (compacting) {
+    compactionMarks.resize(vertexList.size(), 0);
+    auto live = [this](uint32_t index) { return !removed[index]; };
+    while (compactionCursor < vertexList.size() && compacted < edges) {
+      LinkedVertices<V> *vertex = vertexList[compactionCursor];
+      compacted += 1 + vertex->returnEdges().size() +
+                   vertex->returnIncomingEdges().size();
+      if (compactionStamp > std::numeric_limits<uint32_t>::max() - 2) {
+        std::fill(compactionMarks.begin(), compactionMarks.end(), 0);
+        compactionStamp = 1;
+      }
+      std::pair<size_t, size_t> count{0, 0};
+      if (removed[compactionCursor]) {
+        count.first = vertex->returnEdges().size();
+        count.second = vertex->clearEdges() - count.first;
+      } else {
+        count = vertex->compactEdges(live, compactionMarks, compactionStamp);
+      }
+      storedEdges -= count.first;
+      removedCount += count.first + count.second;
+      ++compactionCursor;
+    }
+    if (compactionCursor == vertexList.size()) {
+      // edges removed while compaction ran may be behind cursor, so they are
+      // still counted. Components that were built again in earlier pass are
+      // dropped, they may have edges that this pass removed
+      compacting = false;
+      removedEdges = std::min(removedSinceCompaction, storedEdges);
+      std::vector<uint32_t>().swap(compactionMarks);
+      compactionStamp = 1;
+      rebuildingConnectivity = true;
+      connectivityCursor = 0;
+      rebuiltConnectivity = ConnectivityIndex();
+      rebuiltConnectivity.reserve(vertexList.size());
+    }
+  }
+  if (rebuildingConnectivity && !compacting && compacted < edges)
+    rebuildConnectivityStep(edges - compacted);
+  return removedCount;
+}
+
+template <typename V, typename Resource>
+void LinkedListOfVertices<V, Resource>::rebuildConnectivityStep(size_t edges) {
+  // edge is united when the later of its vertices is added, from edges and
+  // incoming edges of that vertex, so no vertex is added ahead of cursor.
+  // Removed vertices keep their dense indices, as components of their own
+  // that are not counted
+  size_t added = 0;
+  while (connectivityCursor < vertexList.size() && added < edges) {
+    uint32_t index = connectivityCursor;
+    LinkedVertices<V> *vertex = vertexList[index];
+    added += 1 + vertex->returnEdges().size() +
+             vertex->returnIncomingEdges().size();
+    if (removed[index]) {
+      rebuiltConnectivity.addRemoved();
+    } else {
+      rebuiltConnectivity.add();
+      for (auto list : {vertex->returnEdges(), vertex->returnIncomingEdges()}) {
+        for (auto v : list) {
+          if (v < index && liveEdge(v))
+            rebuiltConnectivity.unite(index, v);
+        }
+      }
+    }
+    ++connectivityCursor;
+  }
+  if (connectivityCursor == vertexList.size()) {
+    connectivity = std::move(rebuiltConnectivity);
+    rebuiltConnectivity = ConnectivityIndex();
+    rebuildingConnectivity = false;
+    versionChanges.all();
+  }
+}
+
+template <typename V, typename Resource>
+size_t LinkedListOfVertices<V, Resource>::compact() {
+  compacting = true;
+  compactionCursor = 0;
+  removedSinceCompaction = 0;
+  return compactStep(std::numeric_limits<size_t>::max());
+}
+
+template <typename V, typename Resource>
+void LinkedListOfVertices<V, Resource>::beginIngest() {
+  if (ingest == nullptr)
+    ingest = std::make_unique<ConcurrentIngest<V>>(vertexIds);
+}
+
+template <typename V, typename Resource>
+size_t LinkedListOfVertices<V, Resource>::endIngest(unsigned threads) {
+  if (ingest == nullptr)
+    return 0;
+  std::vector<std::pair<int, V>> vertices;
+  std::vector<std::pair<int, int>> edges;
+  std::vector<std::pair<int, std::string>> labels;
+  ingest->take(vertices, edges, labels);
+  // ingest is released first, so that vertices, edges and labels are inserted
+  // in graph and not collected again
+  ingest = nullptr;
+  insertVertices(vertices);
+  size_t inserted = insertEdgeRange(edges, threads, true);
+  for (const auto &[key, label] : labels) {
+    addLabelToVertex(key, {label});
+  }
+  return inserted;
+}
+
+template <typename V, typename Resource>
+size_t LinkedListOfVertices<V, Resource>::loadEdgeList(const std::string &path,
+                                                       const V &info,
+                                                       unsigned threads,
+                                                       size_t chunkBytes) {
+  EdgeListReader reader(threads, chunkBytes);
+  if (ingest != nullptr || !reader.open(path))
+    return 0;
+  std::vector<std::vector<std::pair<int, int>>> parts;
+  std::vector<std::pair<int, int>> edges;
+  size_t inserted = 0;
+  while (reader.nextEdges(parts)) {
+    edges.clear();
+    for (const auto &part : parts) {
+      edges.insert(edges.end(), part.begin(), part.end());
+    }
+    for (const auto &[start, stop] : edges) {
+      insertNodeVertexAsHead(start, info);
+      insertNodeVertexAsHead(stop, info);
+    }
+    inserted += insertEdges(edges, reader.threads());
+  }
+  return inserted;
+}
+
+template <typename V, typename Resource>
+size_t LinkedListOfVertices<V, Resource>::loadLabels(const std::string &path,
+                                                     unsigned threads,
+                                                     size_t chunkBytes) {
+  EdgeListReader reader(threads, chunkBytes);
+  if (!reader.open(path))
+    return 0;
+  std::vector<std::vector<std::pair<int, std::string_view>>> parts;
+  std::vector<std::string> label(1);
+  size_t added = 0;
+  while (reader.nextLabels(parts)) {
+    for (const auto &part : parts) {
+      for (const auto &[key, name] : part) {
+        label[0].assign(name);
+        if (addLabelToVertex(key, label))
+          ++added;
+      }
+    }
+  }
+  return added;
+}
+
+template <typename V, typename Resource>
+bool LinkedListOfVertices<V, Resource>::openLog(const std::string &path) {
+  if (!LogCodec<V>::supported || mutationLog != nullptr)
+    return false;
+  bool hadVertices = !vertexList.empty();
+  auto log = std::make_unique<MutationLog<V>>();
+  // records are replayed with the same methods that logged them, before log
+  // is set, so they are not logged again
+  bool opened = log->open(path, [this](const LogRecord<V> &record) {
+    switch (record.type) {
+    case LogRecordType::AddVertex:
+      insertNodeVertexAsHead(record.key, record.info);
+      break;
+    case LogRecordType::AddEdge:
+      addEdgeToHeadNodeVertex(record.key, record.stop);
+      break;
+    case LogRecordType::AddEdges:
+      insertEdges(record.edges);
+      break;
+    case LogRecordType::AddLabel:
+      addLabelToVertex(record.key, record.labels);
+      break;
+    case LogRecordType::RemoveLabel:
+      removeLabelFromVertex(record.key, record.labels);
+      break;
+    case LogRecordType::RemoveVertex:
+      removeVertex(record.key);
+      break;
+    case LogRecordType::RemoveEdge:
+      removeEdge(record.key, record.stop);
+      break;
+    }
+  });
+  if (!opened)
+    return false;
+  log->writer().setGroupBytes(logGroupBytes);
+  log->setCheckpointBytes(logCheckpointBytes);
+  mutationLog = std::move(log);
+  return !hadVertices || checkpointLog();
+}
+
+template <typename V, typename Resource>
+bool LinkedListOfVertices<V, Resource>::checkpointLog() {
+  if (mutationLog == nullptr)
+    return false;
+  return mutationLog->checkpoint([this](MutationLogWriter<V> &out) {
+    // vertices first, in order of dense indices, so recovered graph gives
+    // them the same order, then labels and edges of each vertex. Removed
+    // vertices and edges are not written
+    for (uint32_t index = 0; index < vertexList.size(); ++index) {
+      if (!removed[index])
+        out.addVertex(keys[index], vertexList[index]->getHead()->data);
+    }
+    std::vector<std::string> names;
+    for (uint32_t index = 0; index < vertexList.size(); ++index) {
+      names.clear();
+      for (auto labelId : labels[index].ids()) {
+        names.push_back(labelDictionary.name(labelId));
+      }
+      if (!names.empty())
+        out.label(LogRecordType::AddLabel, keys[index], names);
+    }
+    for (uint32_t index = 0; index < vertexList.size(); ++index) {
+      if (removed[index])
+        continue;
+      for (auto stop : vertexList[index]->returnEdges()) {
+        if (liveEdge(stop))
+          out.addEdge(keys[index], keys[stop]);
+      }
+    }
+  });
+}
+
+template <typename V, typename Resource>
+void LinkedListOfVertices<V, Resource>::reserveVertices(size_t count) {
+  size_t size = vertexList.size() + count;
+  if (size <= vertexList.capacity())
+    return;
+  // capacity still grows geometrically, if vertices are inserted in many small
+  // ranges
+  size = std::max(size, vertexList.capacity() * 2);
+  vertexIds.reserve(size);
+  vertexList.reserve(size);
+  keys.reserve(size);
+  labels.reserve(size);
+  removed.reserve(size);
+  connectivity.reserve(size);
+}
+
+template <typename V, typename Resource>
+template <typename Range>
+size_t
+LinkedListOfVertices<V, Resource>::insertVertices(const Range &vertices) {
+  if (ingest == nullptr)
+    reserveVertices(static_cast<size_t>(
+        std::distance(std::begin(vertices), std::end(vertices))));
+  size_t inserted = 0;
+  for (const auto &[key, info] : vertices) {
+    if (insertNodeVertexAsHead(key, info))
+      ++inserted;
+  }
+  return inserted;
+}
+
+template <typename V, typename Resource>
+template <typename Range>
+size_t LinkedListOfVertices<V, Resource>::insertEdges(const Range &edges,
+                                                      unsigned threads) {
+  if (ingest != nullptr)
+    return 0;
+  return insertEdgeRange(edges, threads, false);
+}
+
+template <typename V, typename Resource>
+template <typename Range>
+size_t LinkedListOfVertices<V, Resource>::insertEdgeRange(const Range &edges,
+                                                          unsigned threads,
+                                                          bool parallel) {
+  using Iterator = decltype(std::begin(edges));
+  size_t count = static_cast<size_t>(
+      std::distance(std::begin(edges), std::end(edges)));
+  size_t vertexCount = vertexList.size();
+  if (count == 0 || vertexCount == 0)
+    return 0;
+
+  // parts of range are found with std::advance, so only random access ranges
+  // are split between threads
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  if constexpr (!std::is_base_of_v<
+                    std::random_access_iterator_tag,
+                    typename std::iterator_traits<Iterator>::iterator_category>)
+    threads = 1;
+  threads = static_cast<unsigned>(
+      std::min<size_t>(threads, count / minEdgesPerThread + 1));
+
+  // edge is packed as start index << 32 | stop index, so sorted packed edges
+  // of one start vertex are sorted by stop vertex. Part of edge is range of
+  // dense indices that its start vertex is in
+  auto partOf = [vertexCount, threads](uint32_t index) {
+    return static_cast<size_t>(uint64_t(index) * threads / vertexCount);
+  };
+  auto partBegin = [vertexCount, threads](unsigned part) {
+    return static_cast<uint32_t>((uint64_t(part) * vertexCount + threads - 1) /
+                                 threads);
+  };
+  using Parts = std::vector<std::vector<uint64_t>>;
+
+  // each thread resolves keys of its part of range, and splits edges by parts
+  // of start vertices
+  std::vector<Parts> resolved(threads, Parts(threads));
+  parallelFor(threads, [&](unsigned thread) {
+    auto first = std::begin(edges);
+    std::advance(first, count * thread / threads);
+    size_t size = count * (thread + 1) / threads - count * thread / threads;
+    for (auto &part : resolved[thread]) {
+      part.reserve(size / threads);
+    }
+    // edge lists are usually grouped by start vertex, so index of last start
+    // vertex is kept and its key is not looked up again
+    int lastStart = 0;
+    uint32_t startIndex = noVertex;
+    for (size_t i = 0; i < size; i++, ++first) {
+      const auto &[start, stop] = *first;
+      if (startIndex == noVertex || start != lastStart) {
+        lastStart = start;
+        if (!vertexIds.find(start, startIndex)) {
+          startIndex = noVertex;
+          continue;
+        }
+      }
+      uint32_t stopIndex = 0;
+      if (vertexIds.find(stop, stopIndex))
+        resolved[thread][partOf(startIndex)].push_back(
+            uint64_t(startIndex) << 32 | stopIndex);
+    }
+  });
+
+  // each thread groups edges of its part of start vertices by start vertex,
+  // with counting sort, then sorts edges of each start vertex and removes
+  // duplicates. Edges of part are also split by parts of stop vertices, in
+  // order of start vertices, so that incoming edges are appended on threads
+  Parts sorted(threads);
+  std::vector<Parts> byStop(threads > 1 ? threads : 0, Parts(threads));
+  std::vector<uint32_t> incomingCount(vertexCount, 0);
+  parallelFor(threads, [&](unsigned part) {
+    uint32_t first = partBegin(part);
+    uint32_t last = partBegin(part + 1);
+    std::vector<size_t> offsets(last - first + 1, 0);
+    for (const auto &parts : resolved) {
+      for (auto edge : parts[part]) {
+        ++offsets[(edge >> 32) - first + 1];
+      }
+    }
+    for (size_t i = 1; i < offsets.size(); i++) {
+      offsets[i] += offsets[i - 1];
+    }
+    std::vector<uint64_t> &partEdges = sorted[part];
+    partEdges.resize(offsets.back());
+    // offsets are used as positions of next edges, after edges are placed
+    // offset of each start vertex is where edges of previous vertex were
+    for (auto &parts : resolved) {
+      for (auto edge : parts[part]) {
+        partEdges[offsets[(edge >> 32) - first]++] = edge;
+      }
+      std::vector<uint64_t>().swap(parts[part]);
+    }
+
+    // edges that start vertex already has are removed too, unless parallel
+    // edges are kept. Edges of vertex are not sorted, so they are copied and
+    // sorted first
+    std::vector<uint32_t> existing;
+    size_t kept = 0;
+    for (uint32_t start = first; start < last; start++) {
+      auto begin = partEdges.begin() +
+                   (start == first ? 0 : offsets[start - first - 1]);
+      auto end = partEdges.begin() + offsets[start - first];
+      if (begin == end)
+        continue;
+      std::sort(begin, end);
+      if (parallel) {
+        for (; begin != end; ++begin) {
+          partEdges[kept++] = *begin;
+        }
+        continue;
+      }
+      end = std::unique(begin, end);
+      const auto &nodes = vertexList[start]->nodes;
+      existing.assign(nodes.begin(), nodes.end());
+      std::sort(existing.begin(), existing.end());
+      for (; begin != end; ++begin) {
+        auto stop = static_cast<uint32_t>(*begin);
+        if (!std::binary_search(existing.begin(), existing.end(), stop))
+          partEdges[kept++] = *begin;
+      }
+    }
+    partEdges.resize(kept);
+
+    if (threads > 1) {
+      for (auto edge : partEdges) {
+        byStop[part][partOf(static_cast<uint32_t>(edge))].push_back(edge);
+      }
+    }
+  });
+
+  // edges of part of start vertices with stop vertex in part of stop vertices
+  auto stopEdges = [&](unsigned startPart,
+                       unsigned stopPart) -> const std::vector<uint64_t> & {
+    return threads > 1 ? byStop[startPart][stopPart] : sorted[startPart];
+  };
+  parallelFor(threads, [&](unsigned part) {
+    for (unsigned startPart = 0; startPart < threads; startPart++) {
+      for (auto edge : stopEdges(startPart, part)) {
+        ++incomingCount[static_cast<uint32_t>(edge)];
+      }
+    }
+  });
+
+  // vectors of edges are reserved on this thread, since memory resource of
+  // graph is not thread safe. Capacity grows at least twice, so that many
+  // small ranges do not reallocate vectors each time
+  auto grow = [](std::pmr::vector<uint32_t> &vector, size_t count) {
+    if (vector.size() + count > vector.capacity())
+      vector.reserve(std::max(vector.size() + count, vector.capacity() * 2));
+  };
+  for (const auto &partEdges : sorted) {
+    for (size_t i = 0; i < partEdges.size();) {
+      uint64_t start = partEdges[i] >> 32;
+      size_t first = i;
+      while (i < partEdges.size() && partEdges[i] >> 32 == start) {
+        i++;
+      }
+      grow(vertexList[start]->nodes, i - first);
+    }
+  }
+  for (size_t index = 0; index < vertexCount; index++) {
+    if (incomingCount[index] > 0)
+      grow(vertexList[index]->incoming, incomingCount[index]);
+  }
+
+  // each thread appends edges of its part of start vertices and incoming
+  // edges of its part of stop vertices, vectors are not reallocated
+  parallelFor(threads, [&](unsigned part) {
+    for (auto edge : sorted[part]) {
+      vertexList[edge >> 32]->insertNodeVertex(static_cast<uint32_t>(edge));
+    }
+    for (unsigned startPart = 0; startPart < threads; startPart++) {
+      for (auto edge : stopEdges(startPart, part)) {
+        vertexList[static_cast<uint32_t>(edge)]->insertIncomingNodeVertex(
+            static_cast<uint32_t>(edge >> 32));
+      }
+    }
+  });
+
+  // components are united on this thread, in one pass over new edges
+  size_t inserted = 0;
+  for (const auto &partEdges : sorted) {
+    inserted += partEdges.size();
+    for (auto edge : partEdges) {
+      versionChanges.vertex(static_cast<uint32_t>(edge >> 32));
+      versionChanges.vertex(static_cast<uint32_t>(edge));
+      uniteComponents(static_cast<uint32_t>(edge >> 32),
+                      static_cast<uint32_t>(edge));
+    }
+  }
+  // distances of landmarks are updated edge by edge, unless so many edges
+  // are inserted that searches from landmarks are faster
+  if (inserted > 0 && !landmarkIndex.empty()) {
+    if (inserted > vertexCount / 8) {
+      landmarkIndex.rebuild(IndexView{*this});
+    } else {
+      for (const auto &partEdges : sorted) {
+        for (auto edge : partEdges) {
+          landmarkIndex.insertEdge(IndexView{*this},
+                                   static_cast<uint32_t>(edge >> 32),
+                                   static_cast<uint32_t>(edge));
+        }
+      }
+    }
+  }
+  if (inserted > 0) {
+    storedEdges += inserted;
+    snapshotStale = true;
+    edgeGeneration = ++graphGeneration;
+    // range is logged as it was given, replay of it inserts the same edges.
+    // Parallel edges are logged one by one, replay of range would drop them
+    if (mutationLog != nullptr) {
+      if (parallel) {
+        for (const auto &[start, stop] : edges) {
+          mutationLog->writer().addEdge(start, stop);
+        }
+      } else {
+        mutationLog->writer().addEdges(edges);
+      }
+      checkpointLogIfDue();
+    }
+    publishIfDue();
+  }
+  return inserted;
+}
+
+template <typename V, typename Resource>
+bool LinkedListOfVertices<V, Resource>::addLabelToVertex(
     int key, const std::vector<std::string> &label) {
-  auto itNode = vertexList.find(key);
-  if (itNode != vertexList.end()) {
+  if (ingest != nullptr)
+    return ingest->addLabel(key, label);
+  uint32_t index = 0;
+  if (vertexIds.find(key, index)) {
+    std::vector<uint32_t> labelIds;
     for (const auto &l : label) {
-      itNode->second->addLabel(l);
+      uint32_t labelId = labelDictionary.intern(l);
+      labels[index].add(labelId);
+      labelIndex.add(labelId, index);
+      labelIds.push_back(labelId);
+    }
+    versionChanges.vertex(index);
+    patchSnapshotLabels(index);
+    labelsChanged(labelIds);
+    if (mutationLog != nullptr) {
+      mutationLog->writer().label(LogRecordType::AddLabel, key, label);
+      checkpointLogIfDue();
     }
+    publishIfDue();
     return true;
   }
   return false;
 }
 
-template <typename V>
-bool LinkedListOfVertices<V>::removeLabelFromVertex(
+template <typename V, typename Resource>
+bool LinkedListOfVertices<V, Resource>::removeLabelFromVertex(
     int key, const std::vector<std::string> &label) {
   bool hasThisString = true;
-  auto itNode = vertexList.find(key);
-  if (itNode != vertexList.end()) {
-    for (auto l : label) {
-      if (!itNode->second->removeLabel(l))
+  uint32_t index = 0;
+  if (ingest != nullptr)
+    return false;
+  if (vertexIds.find(key, index)) {
+    std::vector<uint32_t> labelIds;
+    for (const auto &l : label) {
+      uint32_t labelId = 0;
+      if (!labelDictionary.find(l, labelId) ||
+          !labels[index].remove(labelId)) {
         hasThisString = false;
+      } else {
+        labelIndex.remove(labelId, index);
+        labelIds.push_back(labelId);
+      }
+    }
+    versionChanges.vertex(index);
+    patchSnapshotLabels(index);
+    labelsChanged(labelIds);
+    if (mutationLog != nullptr) {
+      mutationLog->writer().label(LogRecordType::RemoveLabel, key, label);
+      checkpointLogIfDue();
     }
+    publishIfDue();
     return hasThisString;
   }
   return hasThisString;
 }
 
-template <typename V> void LinkedListOfVertices<V>::getVertexInfo(int key) {
-  for (auto &vertex : vertexList) {
-    if (vertex.second->getHead()->id == key) {
-      vertex.second->getVertexInfo();
+template <typename V, typename Resource>
+void LinkedListOfVertices<V, Resource>::getVertexInfo(int key) {
+  uint32_t index = 0;
+  if (vertexIds.find(key, index))
+    vertexList[index]->getVertexInfo(labelDictionary, labels[index]);
+}
+
+template <typename V, typename Resource>
+std::vector<int> LinkedListOfVertices<V, Resource>::findVerticesWithLabel(
+    const std::vector<std::string> &label) {
+  std::vector<int> result;
+  LabelMask mask = labelDictionary.compile(label);
+  if (mask.empty()) {
+    for (uint32_t index = 0; index < keys.size(); index++) {
+      if (!removed[index])
+        result.push_back(keys[index]);
     }
+  } else {
+    CompressedVertexSet vertices = labelIndex.find(mask);
+    result.reserve(vertices.size());
+    vertices.forEach([this, &result](uint32_t index) {
+      result.push_back(keys[index]);
+    });
   }
+  // dense indices are given in order of insertion, not in order of keys
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+template <typename V, typename Resource>
+QueryContext<V> &LinkedListOfVertices<V, Resource>::threadContext() {
+  // each thread keeps its own context, storage of context is reused by all
+  // searches of the thread
+  return QueryContext<V>::threadContext();
+}
+
+template <typename V, typename Resource>
+bool LinkedListOfVertices<V, Resource>::findShortestPath(
+    int start, int stop, const std::vector<std::string> &label,
+    SearchMode mode) const {
+  return findShortestPath(start, stop, label, threadContext(), mode);
+}
+
+template <typename V, typename Resource>
+bool LinkedListOfVertices<V, Resource>::findShortestPath(
+    int start, int stop, const std::vector<std::string> &label,
+    PathResult &result, SearchMode mode) const {
+  result.clear();
+  QueryContext<V> &context = threadContext();
+  if (!findShortestPath(start, stop, label, context, mode))
+    return false;
+  result.found = true;
+  result.distance = static_cast<int>(context.path().size());
+  result.path.assign(context.path().begin(), context.path().end());
+  result.path.push_back(stop);
+  return true;
 }
 
-template <typename V>
-bool LinkedListOfVertices<V>::findShortestPath(
-    int start, int stop, std::vector<std::string> &label) {
+template <typename V, typename Resource>
+bool LinkedListOfVertices<V, Resource>::findShortestPath(
+    int start, int stop, const std::vector<std::string> &label,
+    QueryContext<V> &context, SearchMode mode) const {
+  uint32_t startIndex = 0;
+  uint32_t stopIndex = 0;
 
-  auto startNode = vertexList.find(start);
-  auto stopNode = vertexList.find(stop);
+  // new search in context, elements of all vertices are reset and path deque
+  // is cleared, in case it contains infos from previous calculations
+  context.begin(vertexList.size());
 
-  // if the vertexList does not contain start or stop key, return false and do
+  // if the vertexIds does not contain start or stop key, return false and do
   // not proceed with calculation
-  if (startNode == vertexList.end() || stopNode == vertexList.end()) {
-    std::cout << "No start or stop node in graph" << std::endl;
+  if (!vertexIds.find(start, startIndex) || !vertexIds.find(stop, stopIndex))
     return false;
+
+  // there is no path between vertices of different weakly connected
+  // components, so they are rejected before labels are compiled and cache is
+  // locked
+  if (!connectivity.connected(startIndex, stopIndex))
+    return false;
+
+  // labels are compiled once to mask of label ids, so that label check of
+  // each vertex is one AND and compare
+  LabelMask mask = labelDictionary.compile(label);
+
+  // cached result is used if graph was not changed in a way that changes it,
+  // searches with labels that are not in graph are not cached
+  bool cached = pathCache.capacity() > 0 && mask.satisfiable;
+  PathCache::Key cacheKey{start, stop, mode, mask.bits, {}};
+  if (cached) {
+    cacheKey.overflow = mask.overflow;
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    bool found = false;
+    if (pathCache.find(cacheKey, validSince(mask), found, context.path()))
+      return found;
   }
 
-  // sort keys of connected vertices in qBackUp and remove duplicates
-  qBackUp.sort();
-  qBackUp.unique();
+  searchPath(startIndex, stopIndex, mask, context, mode);
 
-  // clear q list and path deque, in case they contain infos from previous
-  // calculations
-  path.clear();
-  q.clear();
+  if (cached) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    pathCache.insert(cacheKey, graphGeneration, !context.path().empty(),
+                     context.path());
+  }
 
-  // loop through qBackUp and set each entry distance to INF and previous
-  // visited vertex to -INF and copy all entries in q list
-  for (const auto &element : qBackUp) {
-    q.push_back(element);
-    auto node = vertexList.find(element);
-    node->second->getHead()->setVertexDistance(std::numeric_limits<int>::max());
-    node->second->getHead()->setPreviousNode(std::numeric_limits<int>::min());
+  // if above check inserted some values in path, it means that there is a
+  // shortest path between two vertices
+  return !context.path().empty();
+}
+
+template <typename V, typename Resource>
+void LinkedListOfVertices<V, Resource>::searchPath(uint32_t start,
+                                                   uint32_t stop,
+                                                   const LabelMask &mask,
+                                                   QueryContext<V> &context,
+                                                   SearchMode mode) const {
+  // stop vertex has to have labels, as every vertex on path except start
+  // vertex, so search is not started if it does not have them. This also
+  // rejects labels that no vertex has
+  if (!labels[stop].containsAll(mask))
+    return;
+
+  // bidirectional and landmark searches run over vertexList, search in
+  // hierarchy runs without labels over hierarchy built from current edges,
+  // otherwise if graph is frozen, breadth first search runs over contiguous
+  // arrays of CSR snapshot, that uses the same dense indices
+  if (mode == SearchMode::Bidirectional) {
+    searchBidirectional(start, stop, mask, context);
+  } else if (mode == SearchMode::Landmarks && !landmarkIndex.empty()) {
+    searchLandmarks(start, stop, mask, context);
+  } else if (mode == SearchMode::ContractionHierarchy && mask.empty() &&
+             hierarchyCurrent()) {
+    searchHierarchy(start, stop, context);
+  } else if (snapshotEnabled) {
+    context.bfs().search(currentSnapshot(), start, stop, mask,
+                         context.path());
+  } else {
+    searchVertexList(start, stop, mask, context);
   }
+}
 
-  // set distance of start vertex to 0
-  startNode->second->getHead()->setVertexDistance(0);
+template <typename V, typename Resource>
+void LinkedListOfVertices<V, Resource>::findShortestPaths(
+    const std::vector<PathQuery> &queries,
+    std::vector<PathResult> &results) const {
+  // results keep storage of their paths from previous batches
+  results.resize(queries.size());
+  for (auto &result : results) {
+    result.clear();
+  }
+  if (queries.empty())
+    return;
+
+  // labels of each query are compiled once, queries are sorted by mode,
+  // start vertex and compiled labels, so that queries in Forward mode of one
+  // group are next to each other
+  std::vector<LabelMask> masks(queries.size());
+  for (size_t i = 0; i < queries.size(); i++) {
+    masks[i] = labelDictionary.compile(queries[i].label);
+  }
+  std::vector<size_t> order(queries.size());
+  std::iota(order.begin(), order.end(), 0);
+  auto groupKey = [&](size_t i) {
+    return std::tie(queries[i].mode, queries[i].start, masks[i].satisfiable,
+                    masks[i].bits, masks[i].overflow);
+  };
+  std::sort(order.begin(), order.end(),
+            [&](size_t a, size_t b) { return groupKey(a) < groupKey(b); });
+
+  std::vector<std::vector<size_t>> groups;
+  for (size_t i = 0; i < order.size(); i++) {
+    size_t query = order[i];
+    if (i == 0 || queries[query].mode != SearchMode::Forward ||
+        groupKey(query) != groupKey(order[i - 1]))
+      groups.emplace_back();
+    groups.back().push_back(query);
+  }
+
+  std::lock_guard<std::mutex> lock(batchMutex);
+  if (pool == nullptr) {
+    pool = std::make_unique<WorkStealingPool>(batchThreads);
+    workerContexts.resize(pool->size());
+  }
+  // groups are tasks of pool, each worker searches with its own context. With
+  // one worker, or one group, groups are answered on this thread
+  auto task = [&](size_t group, unsigned worker) {
+    answerGroup(queries, masks, groups[group], results,
+                workerContexts[worker]);
+  };
+  if (pool->size() == 1 || groups.size() == 1) {
+    for (size_t group = 0; group < groups.size(); group++) {
+      task(group, 0);
+    }
+  } else {
+    pool->run(groups.size(), task);
+  }
+}
+
+template <typename V, typename Resource>
+void LinkedListOfVertices<V, Resource>::answerGroup(
+    const std::vector<PathQuery> &queries, const std::vector<LabelMask> &masks,
+    const std::vector<size_t> &group, std::vector<PathResult> &results,
+    QueryContext<V> &context) const {
+  const PathQuery &first = queries[group.front()];
+  const LabelMask &mask = masks[group.front()];
+  context.begin(vertexList.size());
+  uint32_t startIndex = 0;
+  if (!vertexIds.find(first.start, startIndex))
+    return;
+
+  // one query is searched as with findShortestPath
+  if (group.size() == 1) {
+    uint32_t stopIndex = 0;
+    if (!vertexIds.find(first.stop, stopIndex) ||
+        !connectivity.connected(startIndex, stopIndex))
+      return;
+    searchPath(startIndex, stopIndex, mask, context, first.mode);
+    PathResult &result = results[group.front()];
+    if (!context.path().empty()) {
+      result.found = true;
+      result.distance = static_cast<int>(context.path().size());
+      result.path.assign(context.path().begin(), context.path().end());
+      result.path.push_back(first.stop);
+    }
+    return;
+  }
+
+  // stop vertices that are not in graph, do not have labels or are in other
+  // component, are not searched for, start vertex is never reached as stop
+  // vertex
+  std::vector<uint32_t> targets;
+  std::vector<uint32_t> stops(group.size(), noVertex);
+  for (size_t i = 0; i < group.size(); i++) {
+    uint32_t stopIndex = 0;
+    if (vertexIds.find(queries[group[i]].stop, stopIndex) &&
+        stopIndex != startIndex && labels[stopIndex].containsAll(mask) &&
+        connectivity.connected(startIndex, stopIndex)) {
+      stops[i] = stopIndex;
+      targets.push_back(stopIndex);
+    }
+  }
+  if (targets.empty())
+    return;
+  std::sort(targets.begin(), targets.end());
+  targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+  searchTargets(startIndex, targets, mask, context);
+
+  for (size_t i = 0; i < group.size(); i++) {
+    if (stops[i] == noVertex ||
+        context.distance(stops[i]) == QueryContext<V>::infinity)
+      continue;
+    PathResult &result = results[group[i]];
+    result.found = true;
+    result.distance = context.distance(stops[i]);
+    for (uint32_t index = stops[i]; index != noVertex;
+         index = context.previous(index)) {
+      result.path.push_back(keys[index]);
+    }
+    std::reverse(result.path.begin(), result.path.end());
+  }
+}
+
+template <typename V, typename Resource>
+void LinkedListOfVertices<V, Resource>::searchTargets(
+    uint32_t start, const std::vector<uint32_t> &targets,
+    const LabelMask &mask, QueryContext<V> &context) const {
+  FrontierQueue<uint32_t> &frontier = context.frontier();
+  size_t remaining = targets.size();
+
+  context.setDistance(start, 0, noVertex);
+  frontier.push(0, start);
+
+  // same Dijkstra search as searchVertexList, each vertex is visited with its
+  // final previous vertex, so paths are the same as paths of single searches
+  while (!frontier.empty() && remaining > 0) {
+    auto [uDistance, u] = frontier.pop();
+    if (uDistance > context.distance(u))
+      continue;
+    if (std::binary_search(targets.begin(), targets.end(), u))
+      --remaining;
+
+    for (auto v : vertexList[u]->returnEdges()) {
+      if (!liveEdge(v))
+        continue;
+      int edgeDistance = context.distance(v);
+      if (uDistance < edgeDistance && labels[v].containsAll(mask)) {
+        context.setDistance(v, uDistance + 1, u);
+        if (uDistance + 1 < edgeDistance)
+          frontier.push(uDistance + 1, v);
+      }
+    }
+  }
+}
+
+template <typename V, typename Resource>
+void LinkedListOfVertices<V, Resource>::setBatchThreads(unsigned threads) {
+  std::lock_guard<std::mutex> lock(batchMutex);
+  batchThreads = threads;
+  pool = nullptr;
+  workerContexts.clear();
+}
+
+template <typename V, typename Resource>
+bool LinkedListOfVertices<V, Resource>::findShortestPathTree(
+    int start, const std::vector<std::string> &label,
+    ShortestPathTree &tree) const {
+  return findShortestPathTree(start, label, tree, threadContext());
+}
 
-  int tempNodeKey = 0;
+template <typename V, typename Resource>
+bool LinkedListOfVertices<V, Resource>::findShortestPathTree(
+    int start, const std::vector<std::string> &label, ShortestPathTree &tree,
+    QueryContext<V> &context) const {
+  tree.clear();
+  context.begin(vertexList.size());
+  uint32_t startIndex = 0;
+  if (!vertexIds.find(start, startIndex))
+    return false;
+  LabelMask mask = labelDictionary.compile(label);
 
-  // loop until q is empty
-  while (!q.empty()) {
-    // take first key from q list and save it in int u
-    int u = q.front();
+  std::vector<uint32_t> &level = context.forwardLevel();
+  std::vector<uint32_t> &nextLevel = context.nextLevel();
+  context.setDistance(startIndex, 0, noVertex);
+  level.assign(1, startIndex);
+  tree.add(start, 0, ShortestPathTree::noParent);
 
-    // check if any of the keys in q list has smaller distance then the distance
-    // of u, if yes, save that one in u
-    for (auto current : q) {
-      if (vertexList.find(current)->second->getHead()->getVertexDistance() <
-          vertexList.find(u)->second->getHead()->getVertexDistance()) {
-        u = current;
+  // position in tree of first vertex of current level
+  uint32_t levelBegin = 0;
+  for (int distance = 1; !level.empty(); distance++) {
+    // level is sorted, vertex reached again from the same level takes the
+    // later vertex as previous, as it does in Dijkstra search, where vertices
+    // of equal distance are visited in order of dense index
+    nextLevel.clear();
+    for (auto u : level) {
+      for (auto v : vertexList[u]->returnEdges()) {
+        if (!liveEdge(v))
+          continue;
+        int vDistance = context.distance(v);
+        if (vDistance < distance ||
+            (vDistance == QueryContext<V>::infinity &&
+             !labels[v].containsAll(mask)))
+          continue;
+        if (vDistance == QueryContext<V>::infinity)
+          nextLevel.push_back(v);
+        context.setDistance(v, distance, u);
       }
     }
-    // if u is stop key, clear q list, since this is destination vertex, no need
-    // for further calculation
+
+    // vertices are added to tree in order of dense index, position of their
+    // previous vertex is found in sorted current level
+    std::sort(nextLevel.begin(), nextLevel.end());
+    for (auto v : nextLevel) {
+      auto position = std::lower_bound(level.begin(), level.end(),
+                                       context.previous(v)) -
+                      level.begin();
+      tree.add(keys[v], distance,
+               levelBegin + static_cast<uint32_t>(position));
+    }
+    levelBegin += static_cast<uint32_t>(level.size());
+    level.swap(nextLevel);
+  }
+  return true;
+}
+
+template <typename V, typename Resource>
+void LinkedListOfVertices<V, Resource>::setPathCacheCapacity(size_t capacity) {
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  pathCache.setCapacity(capacity);
+}
+
+template <typename V, typename Resource>
+PathCacheStats LinkedListOfVertices<V, Resource>::pathCacheStats() const {
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  return pathCache.stats();
+}
+
+template <typename V, typename Resource>
+void LinkedListOfVertices<V, Resource>::publish() {
+  if (graphGeneration == publishedGeneration)
+    return;
+  if (publishedDictionary == nullptr ||
+      publishedDictionary->size() != labelDictionary.size())
+    publishedDictionary =
+        std::make_shared<const LabelDictionary>(labelDictionary);
+  // only changed chunks are built, other chunks are shared with latest
+  // version, that only writer replaces
+  std::shared_ptr<const GraphVersion<V>> version =
+      std::make_shared<const GraphVersion<V>>(
+          *publishedVersion, versionChanges, vertexList, labels, removed,
+          connectivity, publishedDictionary, graphGeneration);
+  std::atomic_store(&publishedVersion, std::move(version));
+  publishedGeneration = graphGeneration;
+  versionChanges.clear();
+}
+
+template <typename V, typename Resource>
+void LinkedListOfVertices<V, Resource>::publishIfDue() {
+  if (publishInterval > 0 &&
+      graphGeneration - publishedGeneration >= publishInterval)
+    publish();
+}
+
+template <typename V, typename Resource>
+bool LinkedListOfVertices<V, Resource>::connected(int start, int stop) const {
+  uint32_t startIndex = 0;
+  uint32_t stopIndex = 0;
+  return vertexIds.find(start, startIndex) && vertexIds.find(stop, stopIndex) &&
+         connectivity.connected(startIndex, stopIndex);
+}
+
+template <typename V, typename Resource>
+uint64_t
+LinkedListOfVertices<V, Resource>::validSince(const LabelMask &mask) const {
+  uint64_t since = edgeGeneration;
+  auto labelGeneration = [this](uint32_t labelId) {
+    return labelId < labelGenerations.size() ? labelGenerations[labelId] : 0;
+  };
+  for (uint64_t bits = mask.bits; bits != 0; bits &= bits - 1) {
+    since = std::max(
+        since, labelGeneration(static_cast<uint32_t>(__builtin_ctzll(bits))));
+  }
+  for (auto labelId : mask.overflow) {
+    since = std::max(since, labelGeneration(labelId));
+  }
+  return since;
+}
+
+template <typename V, typename Resource>
+void LinkedListOfVertices<V, Resource>::labelsChanged(
+    const std::vector<uint32_t> &labelIds) {
+  if (labelIds.empty())
+    return;
+  ++graphGeneration;
+  for (auto labelId : labelIds) {
+    if (labelId >= labelGenerations.size())
+      labelGenerations.resize(labelId + 1, 0);
+    labelGenerations[labelId] = graphGeneration;
+  }
+}
+
+template <typename V, typename Resource>
+void LinkedListOfVertices<V, Resource>::searchVertexList(
+    uint32_t start, uint32_t stop, const LabelMask &mask,
+    QueryContext<V> &context) const {
+  // frontier heap is cleared by context.begin(). Distance of every vertex is
+  // INF and previous visited vertex is noVertex, until search sets them
+  FrontierQueue<uint32_t> &frontier = context.frontier();
+
+  // set distance of start vertex to 0 and push it to frontier
+  context.setDistance(start, 0, noVertex);
+  frontier.push(0, start);
+
+  bool stopReached = false;
+
+  // loop until frontier is empty
+  while (!frontier.empty()) {
+    // take vertex with the smallest distance from frontier, on equal distances
+    // vertex with smaller dense index is taken first
+    auto [uDistance, u] = frontier.pop();
+
+    // u was pushed again with smaller distance, this entry is outdated
+    if (uDistance > context.distance(u))
+      continue;
+
+    context.visit();
+
+    // if u is stop vertex, this is destination vertex, no need for further
+    // calculation
     if (u == stop) {
-      tempNodeKey = u;
-      q.clear();
+      stopReached = true;
+      break;
     }
 
-    // we do a calculation for u, so we can remove it from q list
-    q.remove(u);
     // for every connected edge to u, we check if its distance is greater then u
     // distance, and does it have that label, if yes, set distance of edge to
-    // distance of u + 1 and previous visited vertex to u
-    for (auto edge : vertexList.find(u)->second->returnEdges()) {
-      int newDistance =
-          vertexList.find(u)->second->getHead()->getVertexDistance();
-
-      if (newDistance < edge->getVertexDistance() && edge->hasLabel(label)) {
-        edge->setVertexDistance(newDistance + 1);
-        edge->setPreviousNode(u);
+    // distance of u + 1 and previous visited vertex to u. Edge is pushed to
+    // frontier only if its distance got smaller
+    for (auto v : vertexList[u]->returnEdges()) {
+      if (!liveEdge(v))
+        continue;
+      int edgeDistance = context.distance(v);
+      if (uDistance < edgeDistance && labels[v].containsAll(mask)) {
+        context.setDistance(v, uDistance + 1, u);
+        if (uDistance + 1 < edgeDistance)
+          frontier.push(uDistance + 1, v);
       }
     }
   }
 
-  // first fetch LinkedVertices for tempNodeKey that is stop key, if exists
-  if (vertexList.find(tempNodeKey)->second != nullptr) {
-    // while previous vertex is not -INF, push at the front path deque previous
-    // vertex id value
-    while (vertexList.find(tempNodeKey)->second->getHead()->getPreviousNode() !=
-           std::numeric_limits<int>::min()) {
-      path.push_front(
-          vertexList.find(tempNodeKey)->second->getHead()->getPreviousNode());
-      // fetch previous vertex and save it as new tempNodeKey value
-      tempNodeKey =
-          vertexList.find(tempNodeKey)->second->getHead()->getPreviousNode();
+  // if stop vertex is reached, while previous vertex is not noVertex, push
+  // key of previous vertex to path, then reverse path
+  if (stopReached) {
+    std::vector<int> &path = context.path();
+    for (uint32_t index = context.previous(stop); index != noVertex;
+         index = context.previous(index)) {
+      path.push_back(keys[index]);
     }
+    std::reverse(path.begin(), path.end());
   }
+}
 
-  // if above check inserted some values in path, it means that there is a
-  // shortest path between two vertices
-  if (path.size() > 0) {
-    // if not benchmark testing, print vertices ids on the shortest path between
-    // start and stop vertex
-    if (enableOutputPrint == true) {
-      std::cout << "Start Vertex: " << startNode->first
-                << " to Stop Vertex: " << stopNode->first << " shortest path: ";
-      for (const auto p : path) {
-        std::cout << vertexList.find(p)->first << "->";
+template <typename V, typename Resource>
+void LinkedListOfVertices<V, Resource>::searchLandmarks(
+    uint32_t start, uint32_t stop, const LabelMask &mask,
+    QueryContext<V> &context) const {
+  FrontierQueue<uint64_t> &frontier = context.estimateFrontier();
+
+  // frontier is ordered by distance from start vertex plus lower bound of
+  // distance to stop vertex, and on equal estimates by lower bound, so that
+  // of many equal paths, as in grids, only one is followed. Lower bound of
+  // vertex is computed once, when it is reached, and kept as its reverse
+  // distance
+  int32_t bound = landmarkIndex.lowerBound(start, stop);
+  if (bound == LandmarkIndex::infinity)
+    return;
+  context.setDistance(start, 0, noVertex);
+  context.setReverseDistance(start, bound, noVertex);
+  frontier.push(bound, uint64_t(bound) << 32 | start);
+
+  bool stopReached = false;
+  while (!frontier.empty()) {
+    auto [uEstimate, entry] = frontier.pop();
+    auto u = static_cast<uint32_t>(entry);
+    int uDistance = context.distance(u);
+
+    // u was pushed again with smaller distance, this entry is outdated
+    if (uEstimate > uDistance + context.reverseDistance(u))
+      continue;
+    context.visit();
+    if (u == stop) {
+      stopReached = true;
+      break;
+    }
+
+    // lower bounds are consistent, bound of u is at most 1 more than bound
+    // of its edge, so each vertex is visited once, with its final distance
+    for (auto v : vertexList[u]->returnEdges()) {
+      if (!liveEdge(v))
+        continue;
+      int edgeDistance = context.distance(v);
+      if (uDistance + 1 >= edgeDistance || !labels[v].containsAll(mask))
+        continue;
+      if (edgeDistance == QueryContext<V>::infinity) {
+        bound = landmarkIndex.lowerBound(v, stop);
+        if (bound == LandmarkIndex::infinity)
+          continue;
+        context.setReverseDistance(v, bound, noVertex);
       }
-      std::cout << stopNode->first << std::endl;
+      context.setDistance(v, uDistance + 1, u);
+      int vBound = context.reverseDistance(v);
+      frontier.push(uDistance + 1 + vBound, uint64_t(vBound) << 32 | v);
     }
-    return true;
   }
-  // no path between two vertices, return false
-  return false;
+
+  if (stopReached) {
+    std::vector<int> &path = context.path();
+    for (uint32_t index = context.previous(stop); index != noVertex;
+         index = context.previous(index)) {
+      path.push_back(keys[index]);
+    }
+    std::reverse(path.begin(), path.end());
+  }
+}
+
+template <typename V, typename Resource>
+void LinkedListOfVertices<V, Resource>::searchHierarchy(
+    uint32_t start, uint32_t stop, QueryContext<V> &context) const {
+  if (start == stop)
+    return;
+  uint32_t meeting = hierarchy.search(start, stop, context);
+  if (meeting == noVertex)
+    return;
+  // levels of context are storage of unpacked path and of its shortcuts,
+  // stop vertex is not part of path
+  std::vector<uint32_t> &vertices = context.forwardLevel();
+  hierarchy.unpack(meeting, context, vertices, context.backwardLevel());
+  std::vector<int> &path = context.path();
+  for (size_t i = 0; i + 1 < vertices.size(); i++) {
+    path.push_back(keys[vertices[i]]);
+  }
+}
+
+template <typename V, typename Resource>
+void LinkedListOfVertices<V, Resource>::searchBidirectional(
+    uint32_t start, uint32_t stop, const LabelMask &mask,
+    QueryContext<V> &context) const {
+  if (start == stop)
+    return;
+
+  context.setDistance(start, 0, noVertex);
+  context.setReverseDistance(stop, 0, noVertex);
+  context.forwardLevel().assign(1, start);
+  context.backwardLevel().assign(1, stop);
+
+  // expand the smaller level, until searches meet or one of them has no
+  // vertices left
+  uint32_t meeting = noVertex;
+  while (meeting == noVertex && !context.forwardLevel().empty() &&
+         !context.backwardLevel().empty()) {
+    meeting = expandBidirectionalLevel(context.forwardLevel().size() <=
+                                           context.backwardLevel().size(),
+                                       start, mask, context);
+  }
+
+  if (meeting != noVertex) {
+    // push vertices from start to meeting vertex, then from meeting vertex to
+    // stop vertex, stop vertex is not part of path
+    std::vector<int> &path = context.path();
+    for (uint32_t index = meeting; index != noVertex;
+         index = context.previous(index)) {
+      path.push_back(keys[index]);
+    }
+    std::reverse(path.begin(), path.end());
+    for (uint32_t index = context.next(meeting); index != noVertex;
+         index = context.next(index)) {
+      path.push_back(keys[index]);
+    }
+    path.pop_back();
+  }
+}
+
+template <typename V, typename Resource>
+uint32_t LinkedListOfVertices<V, Resource>::expandBidirectionalLevel(
+    bool forward, uint32_t start, const LabelMask &mask,
+    QueryContext<V> &context) const {
+  std::vector<uint32_t> &level =
+      forward ? context.forwardLevel() : context.backwardLevel();
+  std::vector<uint32_t> &nextLevel = context.nextLevel();
+  uint32_t meeting = noVertex;
+  nextLevel.clear();
+
+  for (auto u : level) {
+    // search from start vertex follows edges, search from stop vertex follows
+    // incoming edges. All vertices on path, except start vertex, have label
+    int uDistance = forward ? context.distance(u) : context.reverseDistance(u);
+    for (auto v : forward ? vertexList[u]->returnEdges()
+                          : vertexList[u]->returnIncomingEdges()) {
+      if (!liveEdge(v))
+        continue;
+      int vDistance =
+          forward ? context.distance(v) : context.reverseDistance(v);
+      if (vDistance != QueryContext<V>::infinity ||
+          (v != start && !labels[v].containsAll(mask)))
+        continue;
+
+      if (forward)
+        context.setDistance(v, uDistance + 1, u);
+      else
+        context.setReverseDistance(v, uDistance + 1, u);
+
+      // vertex is reached by both searches. All vertices where searches meet
+      // in this level are on the shortest paths, since there was no meeting
+      // in previous levels
+      if (context.distance(v) != QueryContext<V>::infinity &&
+          context.reverseDistance(v) != QueryContext<V>::infinity) {
+        meeting = v;
+        break;
+      }
+      nextLevel.push_back(v);
+    }
+    if (meeting != noVertex)
+      break;
+  }
+
+  level.swap(nextLevel);
+  return meeting;
+}
+
+template <typename V, typename Resource>
+void LinkedListOfVertices<V, Resource>::patchSnapshotLabels(uint32_t index) {
+  if (csrSnapshot != nullptr && !snapshotStale)
+    csrSnapshot->patchLabels(index, labels[index]);
+}
+
+template <typename V, typename Resource>
+void LinkedListOfVertices<V, Resource>::freeze() {
+  csrSnapshot =
+      std::make_shared<CsrSnapshot<V>>(vertexList, labels, removed, vertexIds);
+  snapshotStale = false;
+  snapshotEnabled = true;
+}
+
+template <typename V, typename Resource>
+void LinkedListOfVertices<V, Resource>::thaw() {
+  csrSnapshot = nullptr;
+  snapshotStale = true;
+  snapshotEnabled = false;
+}
+
+template <typename V, typename Resource>
+bool LinkedListOfVertices<V, Resource>::save(const std::string &path) const {
+  if (snapshotEnabled)
+    return saveGraphFile(path, currentSnapshot(), labels, labelDictionary,
+                         connectivity, vertexList);
+  CsrSnapshot<V> csr(vertexList, labels, removed, vertexIds);
+  return saveGraphFile(path, csr, labels, labelDictionary, connectivity,
+                       vertexList);
+}
+
+template <typename V, typename Resource>
+void LinkedListOfVertices<V, Resource>::buildLandmarks(
+    unsigned count, LandmarkSelection selection) {
+  landmarkIndex.build(IndexView{*this}, count, selection);
+}
+
+template <typename V, typename Resource>
+uint64_t LinkedListOfVertices<V, Resource>::landmarkFingerprint() const {
+  uint64_t hash = vertexList.size();
+  uint64_t words[2];
+  for (uint32_t index = 0; index < vertexList.size(); index++) {
+    words[0] = static_cast<uint32_t>(keys[index]) |
+               (uint64_t(removed[index]) << 32);
+    words[1] = 0;
+    for (auto v : vertexList[index]->returnEdges()) {
+      if (liveEdge(v))
+        words[1] = words[1] * 31 + v + 1;
+    }
+    hash = graphFileChecksum(hash, words, 2);
+  }
+  return hash;
+}
+
+template <typename V, typename Resource>
+bool LinkedListOfVertices<V, Resource>::saveLandmarks(
+    const std::string &path) const {
+  return !landmarkIndex.empty() &&
+         landmarkIndex.save(path, landmarkFingerprint());
+}
+
+template <typename V, typename Resource>
+bool LinkedListOfVertices<V, Resource>::openLandmarks(const std::string &path) {
+  return landmarkIndex.open(path, vertexList.size(), landmarkFingerprint());
+}
+
+template <typename V, typename Resource>
+const CsrSnapshot<V> &
+LinkedListOfVertices<V, Resource>::currentSnapshot() const {
+  // snapshot is changed only while it is stale, so searches that find it up
+  // to date use it without lock
+  if (snapshotStale.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    if (snapshotStale.load(std::memory_order_relaxed)) {
+      csrSnapshot = std::make_shared<CsrSnapshot<V>>(vertexList, labels,
+                                                     removed, vertexIds);
+      snapshotStale.store(false, std::memory_order_release);
+    }
+  }
+  return *csrSnapshot;
 }
 
 } // namespace graph
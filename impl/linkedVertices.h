@@ -1,8 +1,12 @@
 #pragma once
 
+#include "labelDictionary.h"
+#include "vertexSpan.h"
 #include <algorithm>
 #include <iostream>
-#include <memory>
+#include <limits>
+#include <memory_resource>
+#include <utility>
 #include <vector>
 
 namespace graph {
@@ -11,14 +15,22 @@ namespace graph {
  * Implementation of the Linked Vertices class.
  *
  * Linked Vertices is a linear collection of data elements in which every
- * element has id, data, labelVec, vector of labels for that Node, distance and
- * previous, elements used in Dijkstra algorithm. Class has head Node Vertex and
- * vector of edges that are connected to head Node Vertex.
+ * element has id, dense index of vertex in graph and data. Labels and search
+ * elements of vertices are stored in LinkedListOfVertices, in arrays indexed by
+ * dense index. Class has head Node Vertex, vector of edges that are connected
+ * to head Node Vertex and vector of incoming edges, vertices that have head
+ * Node Vertex as an edge. Edges are stored as 32 bit dense indices of vertices
+ * and are returned as VertexSpan, so they are not copied. Vectors of edges are
+ * allocated from memory resource of graph. Removed edges are overwritten with
+ * removedEdge and keep their place, until vectors are compacted.
  *
  * @tparam V type of data stored in Linked Vertices
  */
 template <typename V> class LinkedVertices {
 public:
+  /// Value of removed edge in vectors of edges
+  static constexpr uint32_t removedEdge = std::numeric_limits<uint32_t>::max();
+
   /**
    * Implementation of the NodeVertex structure.
    *
@@ -28,90 +40,64 @@ public:
    * @tparam V data type in NodeVertex
    */
   struct NodeVertex {
-    int id;                            ///< NodeVertex id
-    V data;                            ///< NodeVertex data
-    std::vector<std::string> labelVec; ///< Vertex label
-    int distance =
-        std::numeric_limits<int>::max(); ///< Used in Dijkstra alghorithm
-    int previous =
-        std::numeric_limits<int>::min(); ///< Used in Dijkstra alghorithm
+    int id;         ///< NodeVertex id
+    uint32_t index; ///< Dense index of NodeVertex in graph
+    V data;         ///< NodeVertex data
 
     /**
      * Node constructor.
-     * Each NodeVertex is constructed using key value.
+     * Each NodeVertex is constructed using key value and dense index.
      *
      * @param vertexKey Vertex id
+     * @param vertexIndex Vertex dense index
      */
-    explicit NodeVertex(int vertexKey) : id(vertexKey) {}
+    explicit NodeVertex(int vertexKey, uint32_t vertexIndex)
+        : id(vertexKey), index(vertexIndex) {}
 
     /**
      * Node constructor.
-     * Each NodeVertex is constructed using key value and data of
+     * Each NodeVertex is constructed using key value, dense index and data of
      * NodeVertex.
      *
      * @param vertexKey Vertex id
+     * @param vertexIndex Vertex dense index
      * @tparam info Vertex data
      */
-    explicit NodeVertex(int vertexKey, V info) : id(vertexKey), data(info) {}
-
-    /**
-     * Sets distance of node vertex to new distance value
-     *
-     * @param distance new distance of node vertex
-     */
-    void setVertexDistance(int distance) { this->distance = distance; }
-
-    /**
-     * Sets previous node of node vertex to new previous value
-     *
-     * @param previous new previous of node vertex
-     */
-    void setPreviousNode(int previous) { this->previous = previous; }
-
-    /**
-     * Returns distance of node vertex
-     */
-    int getVertexDistance() { return this->distance; }
-
-    /**
-     * Returns previous of node vertex
-     */
-    int getPreviousNode() { return this->previous; }
-
-    /**
-     * Checks if labelVec of node vertex contains all labels and returns true if
-     * does
-     *
-     * @param label vector of labels for which is checked if it is inserted in
-     * labelVec
-     */
-    bool hasLabel(std::vector<std::string> &label) const {
-      return std::includes(this->labelVec.begin(), this->labelVec.end(),
-                           label.begin(), label.end());
-    }
+    explicit NodeVertex(int vertexKey, uint32_t vertexIndex, V info)
+        : id(vertexKey), index(vertexIndex), data(info) {}
   };
 
   /**
    * Head node vertex.
    */
-  std::shared_ptr<NodeVertex> head = nullptr;
+  NodeVertex head;
 
   /**
-   * Vector of edges that are connected to head node vertex.
+   * Vector of dense indices of edges that are connected to head node vertex.
    */
-  std::vector<std::shared_ptr<NodeVertex>> nodes;
+  std::pmr::vector<uint32_t> nodes;
+
+  /**
+   * Vector of dense indices of vertices that have an edge to head node vertex.
+   */
+  std::pmr::vector<uint32_t> incoming;
 
 public:
   /**
    * Constructor of LinkedVertices
    *
    * During LinkedVertices object construction,
-   * head NodeVertex is created, with vertexKey as id and info as data
+   * head NodeVertex is created, with vertexKey as id, vertexIndex as dense
+   * index and info as data
    *
    * @param vertexKey id of node vertex head
+   * @param vertexIndex dense index of node vertex head
    * @tparam info node vertex head data
+   * @param resource memory resource of vectors of edges
    */
-  explicit LinkedVertices(int vertexKey, const V &info);
+  explicit LinkedVertices(
+      int vertexKey, uint32_t vertexIndex, const V &info,
+      std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
   /**
    * Destructor  of Linked List
@@ -128,97 +114,186 @@ public:
   LinkedVertices &operator=(const LinkedVertices &rhs) = delete;
 
   /**
-   * Inserts node vertex newNode in vector of node vertices nodes
+   * Inserts dense index of node vertex in vector of edges nodes
+   *
+   * @param newNode dense index of node that is inserted in nodes
+   */
+  void insertNodeVertex(uint32_t newNode);
+
+  /**
+   * Inserts dense index of node vertex, that has an edge to head node vertex,
+   * in vector of incoming edges incoming
+   *
+   * @param sourceNode dense index of node that is inserted in incoming
+   */
+  void insertIncomingNodeVertex(uint32_t sourceNode);
+
+  /**
+   * Marks all edges to node vertex as removed, in vector of edges nodes
+   *
+   * @param node dense index of node that is removed from nodes
+   *
+   * @return number of removed edges
+   */
+  size_t removeNodeVertex(uint32_t node) { return markRemoved(nodes, node); }
+
+  /**
+   * Marks all incoming edges from node vertex as removed, in vector of
+   * incoming edges incoming
+   *
+   * @param sourceNode dense index of node that is removed from incoming
+   *
+   * @return number of removed incoming edges
+   */
+  size_t removeIncomingNodeVertex(uint32_t sourceNode) {
+    return markRemoved(incoming, sourceNode);
+  }
+
+  /**
+   * Removes edges that are removed, or lead to vertices for which live returns
+   * false, and repeated edges from vectors of edges and incoming edges. Order
+   * of other edges is kept. Vector that shrinks to half of its capacity is
+   * reallocated, so its memory is given back to memory resource
+   *
+   * @param live function that returns false for dense index of removed vertex
+   * @param marks marks of vertices seen in vector, indexed by dense index
+   * @param stamp mark that is not in marks yet, incremented for each vector
+   *
+   * @return pair < number of removed edges, number of removed incoming edges >
+   */
+  template <typename Live>
+  std::pair<size_t, size_t> compactEdges(Live live,
+                                         std::vector<uint32_t> &marks,
+                                         uint32_t &stamp) {
+    size_t removedNodes = compact(nodes, live, marks, stamp++);
+    return {removedNodes, compact(incoming, live, marks, stamp++)};
+  }
+
+  /**
+   * Removes all edges and incoming edges and gives memory of their vectors
+   * back to memory resource
    *
-   * @param newNode node that is inserted in nodes
+   * @return number of removed edges and incoming edges
    */
-  void insertNodeVertex(const std::shared_ptr<NodeVertex> newNode);
+  size_t clearEdges();
 
   /**
    * Returns ptr to head node
    *
    */
-  std::shared_ptr<NodeVertex> getHead() const;
+  const NodeVertex *getHead() const { return &head; }
 
   /**
    * Returns info for head node vertex, id and labels
    *
+   * @param dictionary label dictionary of graph, used to print label strings
+   * @param labels label ids of head node vertex
    */
-  void getVertexInfo() const;
+  void getVertexInfo(const LabelDictionary &dictionary,
+                     const LabelSet &labels) const;
 
   /**
-   * Adds label to labelVec of head
+   * Returns dense indices of vertices that are connected to head node
    *
-   * @param label that is to be inserted in labelVec
    */
-  void addLabel(const std::string &label);
+  VertexSpan returnEdges() const {
+    return VertexSpan(nodes.data(), nodes.data() + nodes.size());
+  }
 
   /**
-   * Removes label from labelVec of head. returns true if that label was not
-   * found in labelVec.
+   * Returns dense indices of vertices that have an edge to head node
    *
-   * @param label that is to be removed from labelVec
    */
-  bool removeLabel(const std::string &label);
+  VertexSpan returnIncomingEdges() const {
+    return VertexSpan(incoming.data(), incoming.data() + incoming.size());
+  }
 
+private:
   /**
-   * Returns vertices that are connected to head node
-   *
+   * Overwrites all copies of node in edges with removedEdge, returns their
+   * number
+   */
+  static size_t markRemoved(std::pmr::vector<uint32_t> &edges, uint32_t node);
+
+  /**
+   * Removes removed edges, edges to vertices that are not live and repeated
+   * edges from edges, returns number of removed edges
    */
-  std::vector<std::shared_ptr<NodeVertex>> returnEdges();
+  template <typename Live>
+  static size_t compact(std::pmr::vector<uint32_t> &edges, Live live,
+                        std::vector<uint32_t> &marks, uint32_t stamp);
 };
 
 template <typename V>
-LinkedVertices<V>::LinkedVertices(int vertexKey, const V &info) {
-  head = std::make_shared<NodeVertex>(vertexKey, info);
-}
+LinkedVertices<V>::LinkedVertices(int vertexKey, uint32_t vertexIndex,
+                                  const V &info,
+                                  std::pmr::memory_resource *resource)
+    : head(vertexKey, vertexIndex, info), nodes(resource), incoming(resource) {}
 
 template <typename V> LinkedVertices<V>::~LinkedVertices() {}
 
 template <typename V>
-void LinkedVertices<V>::insertNodeVertex(
-    const std::shared_ptr<NodeVertex> newNode) {
+void LinkedVertices<V>::insertNodeVertex(uint32_t newNode) {
   nodes.push_back(newNode);
 }
 
 template <typename V>
-std::shared_ptr<typename LinkedVertices<V>::NodeVertex>
-LinkedVertices<V>::getHead() const {
-  return head;
+void LinkedVertices<V>::insertIncomingNodeVertex(uint32_t sourceNode) {
+  incoming.push_back(sourceNode);
 }
 
-template <typename V>
-void LinkedVertices<V>::addLabel(const std::string &label) {
-  head->labelVec.push_back(label);
-  std::sort(head->labelVec.begin(), head->labelVec.end());
+template <typename V> size_t LinkedVertices<V>::clearEdges() {
+  size_t removed = nodes.size() + incoming.size();
+  std::pmr::vector<uint32_t>(nodes.get_allocator()).swap(nodes);
+  std::pmr::vector<uint32_t>(incoming.get_allocator()).swap(incoming);
+  return removed;
 }
 
 template <typename V>
-bool LinkedVertices<V>::removeLabel(const std::string &label) {
-  size_t labelVecBefore = head->labelVec.size();
-  head->labelVec.erase(
-      std::remove(head->labelVec.begin(), head->labelVec.end(), label),
-      head->labelVec.end());
-  if (labelVecBefore == head->labelVec.size()) {
-    std::sort(head->labelVec.begin(), head->labelVec.end());
-    return false;
+size_t LinkedVertices<V>::markRemoved(std::pmr::vector<uint32_t> &edges,
+                                      uint32_t node) {
+  size_t removed = 0;
+  for (auto &edge : edges) {
+    if (edge == node) {
+      edge = removedEdge;
+      ++removed;
+    }
   }
-  std::sort(head->labelVec.begin(), head->labelVec.end());
-  return true;
+  return removed;
 }
 
-template <typename V> void LinkedVertices<V>::getVertexInfo() const {
-  std::cout << "Node id " << head->id << " , label ";
-  for (const auto &l : head->labelVec) {
-    std::cout << l << " ";
+template <typename V>
+template <typename Live>
+size_t LinkedVertices<V>::compact(std::pmr::vector<uint32_t> &edges, Live live,
+                                  std::vector<uint32_t> &marks,
+                                  uint32_t stamp) {
+  // the first copy of each edge is kept, so edges keep the order in which
+  // searches visit them
+  size_t kept = 0;
+  for (auto edge : edges) {
+    if (edge == removedEdge || !live(edge) || marks[edge] == stamp)
+      continue;
+    marks[edge] = stamp;
+    edges[kept++] = edge;
   }
-  std::cout << std::endl;
+  size_t removed = edges.size() - kept;
+  edges.resize(kept);
+  if (removed > 0 && kept <= edges.capacity() / 2) {
+    std::pmr::vector<uint32_t> shrunk(edges.begin(), edges.end(),
+                                      edges.get_allocator());
+    edges.swap(shrunk);
+  }
+  return removed;
 }
 
 template <typename V>
-std::vector<std::shared_ptr<typename LinkedVertices<V>::NodeVertex>>
-LinkedVertices<V>::returnEdges() {
-  return nodes;
+void LinkedVertices<V>::getVertexInfo(const LabelDictionary &dictionary,
+                                      const LabelSet &labels) const {
+  std::cout << "Node id " << head.id << " , label ";
+  for (const auto &l : dictionary.labelNames(labels)) {
+    std::cout << l << " ";
+  }
+  std::cout << std::endl;
 }
 
 } // namespace graph
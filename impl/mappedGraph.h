@@ -0,0 +1,530 @@
+#pragma once
+
+#include "graphFile.h"
+#include "labelDictionary.h"
+#include "pathQuery.h"
+#include "queryContext.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace graph {
+
+/**
+ * Implementation of the MappedGraph class.
+ *
+ * MappedGraph opens graph file written by saveGraphFile, by mapping it in
+ * memory read only. Arrays of sections are used in place, so opening file
+ * reads only its header and labels, and pages of edges are read by operating
+ * system when searches first touch them. MappedGraph has the same accessors
+ * as CsrSnapshot, so DirectionOptimizingBfs searches it as it searches
+ * snapshot, and paths are the same as paths of frozen graph that was saved.
+ *
+ * Header is always checked, checksum of data only if asked, since it reads
+ * the whole file. Graph can not be changed, many threads can search it at
+ * the same time, each with its own query context.
+ *
+ * @tparam V type of data stored in graph vertices
+ */
+template <typename V> class MappedGraph {
+private:
+  /**
+   * Start of mapped file, nullptr if no file is open
+   */
+  const unsigned char *base = nullptr;
+
+  /**
+   * Size of mapped file
+   */
+  size_t mappedSize = 0;
+
+  /**
+   * Header of mapped file
+   */
+  const GraphFileHeader *header = nullptr;
+
+  /**
+   * Number of bits of slot index of id table
+   */
+  unsigned slotBits = 0;
+
+  /// Arrays of sections of mapped file
+  const int32_t *keys = nullptr;
+  const GraphFileSlot *slots = nullptr;
+  const uint32_t *offsets = nullptr;
+  const uint32_t *neighbors = nullptr;
+  const uint32_t *inOffsets = nullptr;
+  const uint32_t *inNeighbors = nullptr;
+  const uint64_t *labelBits = nullptr;
+  const GraphFileLabel *overflow = nullptr;
+  const uint32_t *components = nullptr;
+  const unsigned char *payload = nullptr;
+
+  /**
+   * Dictionary of labels, rebuilt from names of labels when file is opened
+   */
+  LabelDictionary dictionary;
+
+  /**
+   * Returns pointer to section of mapped file
+   */
+  template <typename T> const T *section(GraphFileSection section) const {
+    return reinterpret_cast<const T *>(
+        base + header->sections[static_cast<size_t>(section)]);
+  }
+
+  /**
+   * Checks that header describes sections that fit in mapped file
+   */
+  bool validHeader() const;
+
+  /**
+   * Checks if vertex with dense index has labels of mask with id >= 64
+   */
+  bool hasOverflowLabel(uint32_t index, const LabelMask &mask) const;
+
+public:
+  /**
+   * Constructor of MappedGraph
+   *
+   * Constructor takes no arguments, no file is open.
+   */
+  MappedGraph() = default;
+
+  /**
+   * Destructor of MappedGraph
+   *
+   * Unmaps open file.
+   */
+  ~MappedGraph() { close(); }
+
+  /// Disabling construction of MappedGraph object using copy constructor
+  MappedGraph(const MappedGraph &rhs) = delete;
+
+  /// Disabling construction of MappedGraph object using copy assignment
+  MappedGraph &operator=(const MappedGraph &rhs) = delete;
+
+  /**
+   * Opens graph file, file that is open is closed first
+   *
+   * @param path path of file
+   * @param verify if true, checksum of all data of file is checked
+   *
+   * @return true if file is opened, false if it can not be mapped, is not
+   * graph file, was written on machine with different byte order, data of
+   * vertices has different size or checksum does not match
+   */
+  bool open(const std::string &path, bool verify = false);
+
+  /**
+   * Unmaps open file
+   */
+  void close();
+
+  /**
+   * Returns true if file is open
+   */
+  bool isOpen() const { return base != nullptr; }
+
+  /**
+   * Returns number of vertices in graph
+   */
+  size_t vertexCount() const { return header ? header->vertexCount : 0; }
+
+  /**
+   * Returns number of edges in graph
+   */
+  size_t edgeCount() const { return header ? header->edgeCount : 0; }
+
+  /**
+   * Returns dictionary of labels of graph
+   */
+  const LabelDictionary &labelDictionary() const { return dictionary; }
+
+  /**
+   * Returns true if graph contains Vertex with key
+   *
+   * @param key key id of Vertex
+   */
+  bool contains(int key) const {
+    uint32_t index = 0;
+    return findIndex(key, index);
+  }
+
+  /**
+   * Finds data of Vertex with key
+   *
+   * @param key key id of Vertex
+   * @param info Vertex info, set if vertex is found
+   *
+   * @return true if vertex is found and file stores data of vertices
+   */
+  bool info(int key, V &info) const;
+
+  /**
+   * Finds dense index of vertex with given key
+   *
+   * @param key key id of Vertex
+   * @param index dense index of Vertex, set if vertex is found
+   *
+   * @return true if graph contains vertex with key
+   */
+  bool findIndex(int key, uint32_t &index) const;
+
+  /**
+   * Returns key of vertex with dense index
+   *
+   * @param index dense index of Vertex
+   */
+  int keyOf(uint32_t index) const { return keys[index]; }
+
+  /**
+   * Returns pointer to first edge of vertex with dense index
+   *
+   * @param index dense index of Vertex
+   */
+  const uint32_t *edgesBegin(uint32_t index) const {
+    return neighbors + offsets[index];
+  }
+
+  /**
+   * Returns pointer past the last edge of vertex with dense index
+   *
+   * @param index dense index of Vertex
+   */
+  const uint32_t *edgesEnd(uint32_t index) const {
+    return neighbors + offsets[index + 1];
+  }
+
+  /**
+   * Returns pointer to first incoming edge of vertex with dense index
+   *
+   * @param index dense index of Vertex
+   */
+  const uint32_t *incomingBegin(uint32_t index) const {
+    return inNeighbors + inOffsets[index];
+  }
+
+  /**
+   * Returns pointer past the last incoming edge of vertex with dense index
+   *
+   * @param index dense index of Vertex
+   */
+  const uint32_t *incomingEnd(uint32_t index) const {
+    return inNeighbors + inOffsets[index + 1];
+  }
+
+  /**
+   * Returns number of edges of vertex with dense index
+   *
+   * @param index dense index of Vertex
+   */
+  uint32_t outDegree(uint32_t index) const {
+    return offsets[index + 1] - offsets[index];
+  }
+
+  /**
+   * Returns number of incoming edges of vertex with dense index
+   *
+   * @param index dense index of Vertex
+   */
+  uint32_t inDegree(uint32_t index) const {
+    return inOffsets[index + 1] - inOffsets[index];
+  }
+
+  /**
+   * Checks if labels of vertex with dense index contain all labels of mask and
+   * returns true if do
+   *
+   * @param index dense index of Vertex
+   * @param mask compiled labels of search
+   */
+  bool hasLabel(uint32_t index, const LabelMask &mask) const {
+    return (labelBits[index] & mask.bits) == mask.bits && mask.satisfiable &&
+           (mask.overflow.empty() || hasOverflowLabel(index, mask));
+  }
+
+  /**
+   * Checks labels of up to 64 vertices at once, bit i of result is set if
+   * vertex vertices[i] has all labels of mask
+   *
+   * @param vertices dense indices of vertices
+   * @param count number of vertices, at most 64
+   * @param mask compiled labels of search
+   */
+  uint64_t matchLabels(const uint32_t *vertices, size_t count,
+                       const LabelMask &mask) const;
+
+  /**
+   * Sets bits of dense indices of vertices that have all labels of mask. File
+   * has no inverted index of labels, so bits of labels of all vertices are
+   * scanned
+   *
+   * @param mask compiled labels of search
+   * @param words cleared bitmap of dense indices
+   * @param scratch not used, kept for the same signature as CsrSnapshot
+   */
+  void findVertexBits(const LabelMask &mask, std::vector<uint64_t> &words,
+                      std::vector<uint64_t> &scratch) const;
+
+  /**
+   * Finds shortest path between two Vertices, with given query context
+   *
+   * Vertices in different weakly connected components are rejected without
+   * search. Keys of vertices on found path, without stop vertex, are left in
+   * path of context.
+   *
+   * @param start key id of source Vertex
+   * @param stop key id of destination Vertex
+   * @param label label of Vertices found on shortest path
+   * @param context state of search, used by one thread at a time
+   *
+   * @return true if there is a path between two vertices, where each vertex on
+   * the path has label
+   */
+  bool shortestPath(int start, int stop, const std::vector<std::string> &label,
+                    QueryContext<V> &context) const;
+
+  /**
+   * Finds shortest path between two Vertices, into given result
+   *
+   * Same as shortestPath(int start, int stop, const std::vector<std::string>
+   * &label, QueryContext<V> &context), with query context of calling thread.
+   *
+   * @param start key id of source Vertex
+   * @param stop key id of destination Vertex
+   * @param label label of Vertices found on shortest path
+   * @param result found path, cleared first
+   *
+   * @return true if there is a path between two vertices, where each vertex on
+   * the path has label
+   */
+  bool shortestPath(int start, int stop, const std::vector<std::string> &label,
+                    PathResult &result) const;
+};
+
+template <typename V>
+bool MappedGraph<V>::open(const std::string &path, bool verify) {
+  close();
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat status;
+  if (::fstat(fd, &status) != 0 ||
+      static_cast<size_t>(status.st_size) < sizeof(GraphFileHeader)) {
+    ::close(fd);
+    return false;
+  }
+  void *mapped = ::mmap(nullptr, static_cast<size_t>(status.st_size),
+                        PROT_READ, MAP_SHARED, fd, 0);
+  // mapping keeps file open, so descriptor is not needed any more
+  ::close(fd);
+  if (mapped == MAP_FAILED)
+    return false;
+  base = static_cast<const unsigned char *>(mapped);
+  mappedSize = static_cast<size_t>(status.st_size);
+  header = reinterpret_cast<const GraphFileHeader *>(base);
+
+  if (!validHeader()) {
+    close();
+    return false;
+  }
+  if (verify) {
+    uint64_t begin = header->sections[0];
+    const uint64_t *words = reinterpret_cast<const uint64_t *>(base + begin);
+    if (graphFileChecksum(0, words, (mappedSize - begin) / 8) !=
+        header->dataChecksum) {
+      close();
+      return false;
+    }
+  }
+
+  keys = section<int32_t>(GraphFileSection::Keys);
+  slots = section<GraphFileSlot>(GraphFileSection::Slots);
+  offsets = section<uint32_t>(GraphFileSection::Offsets);
+  neighbors = section<uint32_t>(GraphFileSection::Neighbors);
+  inOffsets = section<uint32_t>(GraphFileSection::InOffsets);
+  inNeighbors = section<uint32_t>(GraphFileSection::InNeighbors);
+  labelBits = section<uint64_t>(GraphFileSection::LabelBits);
+  overflow = section<GraphFileLabel>(GraphFileSection::Overflow);
+  components = section<uint32_t>(GraphFileSection::Components);
+  payload = header->payloadSize == 0
+                ? nullptr
+                : section<unsigned char>(GraphFileSection::Payload);
+  slotBits = 0;
+  while ((uint64_t(1) << slotBits) < header->slotCount) {
+    ++slotBits;
+  }
+
+  // labels are interned in order of their ids, so ids are the same as in file
+  const uint32_t *nameOffsets =
+      section<uint32_t>(GraphFileSection::NameOffsets);
+  const char *names = section<char>(GraphFileSection::Names);
+  for (uint64_t id = 0; id < header->labelCount; ++id) {
+    dictionary.intern(std::string(names + nameOffsets[id],
+                                  nameOffsets[id + 1] - nameOffsets[id]));
+  }
+  if (dictionary.size() != header->labelCount) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+template <typename V> void MappedGraph<V>::close() {
+  if (base != nullptr)
+    ::munmap(const_cast<unsigned char *>(base), mappedSize);
+  base = nullptr;
+  header = nullptr;
+  mappedSize = 0;
+  dictionary = LabelDictionary();
+}
+
+template <typename V> bool MappedGraph<V>::validHeader() const {
+  uint64_t words[offsetof(GraphFileHeader, headerChecksum) / 8];
+  std::memcpy(words, header, sizeof(words));
+  if (std::memcmp(header->magic, graphFileMagic, sizeof(header->magic)) != 0 ||
+      header->version != graphFileVersion ||
+      header->byteOrder != 0x01020304u ||
+      header->headerChecksum !=
+          graphFileChecksum(0, words, sizeof(words) / 8) ||
+      header->fileSize != mappedSize)
+    return false;
+  if (header->payloadSize != 0 &&
+      (!std::is_trivially_copyable_v<V> || header->payloadSize != sizeof(V)))
+    return false;
+  if (header->vertexCount >= noSlotIndex ||
+      header->slotCount < header->vertexCount ||
+      (header->slotCount & (header->slotCount - 1)) != 0)
+    return false;
+
+  uint64_t n = header->vertexCount;
+  uint64_t sizes[static_cast<size_t>(GraphFileSection::Count)] = {
+      n * sizeof(int32_t),
+      header->slotCount * sizeof(GraphFileSlot),
+      (n + 1) * sizeof(uint32_t),
+      header->edgeCount * sizeof(uint32_t),
+      (n + 1) * sizeof(uint32_t),
+      header->edgeCount * sizeof(uint32_t),
+      n * sizeof(uint64_t),
+      header->overflowCount * sizeof(GraphFileLabel),
+      (header->labelCount + 1) * sizeof(uint32_t),
+      header->nameBytes,
+      n * sizeof(uint32_t),
+      n * header->payloadSize};
+  for (size_t i = 0; i < static_cast<size_t>(GraphFileSection::Count); ++i) {
+    if (header->sections[i] % graphFileAlignment != 0 ||
+        header->sections[i] < sizeof(GraphFileHeader) ||
+        header->sections[i] > mappedSize ||
+        sizes[i] > mappedSize - header->sections[i])
+      return false;
+  }
+  return true;
+}
+
+template <typename V>
+bool MappedGraph<V>::findIndex(int key, uint32_t &index) const {
+  if (header == nullptr || header->slotCount == 0)
+    return false;
+  uint64_t mask = header->slotCount - 1;
+  for (uint64_t slot = graphFileSlotOf(key, slotBits);;
+       slot = (slot + 1) & mask) {
+    if (slots[slot].index == noSlotIndex)
+      return false;
+    if (slots[slot].key == key) {
+      index = slots[slot].index;
+      return true;
+    }
+  }
+}
+
+template <typename V> bool MappedGraph<V>::info(int key, V &info) const {
+  uint32_t index = 0;
+  if (payload == nullptr || !findIndex(key, index))
+    return false;
+  std::memcpy(static_cast<void *>(&info), payload + size_t(index) * sizeof(V),
+              sizeof(V));
+  return true;
+}
+
+template <typename V>
+uint64_t MappedGraph<V>::matchLabels(const uint32_t *vertices, size_t count,
+                                     const LabelMask &mask) const {
+  if (!mask.satisfiable)
+    return 0;
+  uint64_t result = 0;
+  for (size_t i = 0; i < count; ++i) {
+    result |= uint64_t((labelBits[vertices[i]] & mask.bits) == mask.bits) << i;
+  }
+  if (!mask.overflow.empty()) {
+    for (uint64_t matched = result; matched != 0; matched &= matched - 1) {
+      size_t i = static_cast<size_t>(__builtin_ctzll(matched));
+      if (!hasOverflowLabel(vertices[i], mask))
+        result &= ~(uint64_t(1) << i);
+    }
+  }
+  return result;
+}
+
+template <typename V>
+void MappedGraph<V>::findVertexBits(const LabelMask &mask,
+                                    std::vector<uint64_t> &words,
+                                    std::vector<uint64_t> &) const {
+  for (uint32_t index = 0; index < vertexCount(); ++index) {
+    if (hasLabel(index, mask))
+      words[index >> 6] |= uint64_t(1) << (index & 63);
+  }
+}
+
+template <typename V>
+bool MappedGraph<V>::hasOverflowLabel(uint32_t index,
+                                      const LabelMask &mask) const {
+  // pairs are sorted by vertex and label id, so labels of vertex are one range
+  // and both ranges of ids are sorted
+  auto byVertex = [](const GraphFileLabel &label, uint32_t vertex) {
+    return label.vertex < vertex;
+  };
+  const GraphFileLabel *end = overflow + header->overflowCount;
+  const GraphFileLabel *it = std::lower_bound(overflow, end, index, byVertex);
+  for (auto labelId : mask.overflow) {
+    while (it != end && it->vertex == index && it->labelId < labelId) {
+      ++it;
+    }
+    if (it == end || it->vertex != index || it->labelId != labelId)
+      return false;
+  }
+  return true;
+}
+
+template <typename V>
+bool MappedGraph<V>::shortestPath(int start, int stop,
+                                  const std::vector<std::string> &label,
+                                  QueryContext<V> &context) const {
+  context.begin(vertexCount());
+  uint32_t startIndex = 0;
+  uint32_t stopIndex = 0;
+  if (!findIndex(start, startIndex) || !findIndex(stop, stopIndex) ||
+      components[startIndex] != components[stopIndex])
+    return false;
+  LabelMask mask = dictionary.compile(label);
+  return context.bfs().search(*this, startIndex, stopIndex, mask,
+                              context.path());
+}
+
+template <typename V>
+bool MappedGraph<V>::shortestPath(int start, int stop,
+                                  const std::vector<std::string> &label,
+                                  PathResult &result) const {
+  result.clear();
+  QueryContext<V> &context = QueryContext<V>::threadContext();
+  if (!shortestPath(start, stop, label, context))
+    return false;
+  result.found = true;
+  result.distance = static_cast<int>(context.path().size());
+  result.path.assign(context.path().begin(), context.path().end());
+  result.path.push_back(stop);
+  return true;
+}
+
+} // namespace graph
@@ -0,0 +1,830 @@
+#pragma once
+
+#include "graphFile.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Types of records of mutation log
+ */
+enum class LogRecordType : uint8_t {
+  AddVertex = 1,    ///< key, Vertex info
+  AddEdge = 2,      ///< start key, stop key
+  AddEdges = 3,     ///< number of edges, start and stop key of each edge
+  AddLabel = 4,     ///< key, number of labels, labels
+  RemoveLabel = 5,  ///< key, number of labels, labels
+  RemoveVertex = 6, ///< key
+  RemoveEdge = 7,   ///< start key, stop key
+};
+
+/**
+ * Record of mutation log, decoded when log is replayed
+ *
+ * @tparam V type of data stored in graph vertices
+ */
+template <typename V> struct LogRecord {
+  LogRecordType type = LogRecordType::AddVertex; ///< type of record
+  int key = 0;                                   ///< key, or start key
+  int stop = 0;                                  ///< stop key of edge
+  V info{};                                      ///< info of AddVertex
+  std::vector<std::pair<int, int>> edges;        ///< edges of AddEdges
+  std::vector<std::string> labels;               ///< labels of label records
+};
+
+/**
+ * Encoding of varints of records of mutation log. Values are written in 7 bit
+ * groups, lowest first, to buffer that has room for them
+ */
+struct LogVarint {
+  /// Largest size of encoded value
+  static constexpr size_t maxBytes = 10;
+
+  /// Writes value and returns position after it
+  static unsigned char *encode(unsigned char *out, uint64_t value) {
+    while (value >= 0x80) {
+      *out++ = static_cast<unsigned char>(value | 0x80);
+      value >>= 7;
+    }
+    *out++ = static_cast<unsigned char>(value);
+    return out;
+  }
+
+  /// Writes key, zigzag encoded so that small negative keys stay short
+  static unsigned char *encodeKey(unsigned char *out, int key) {
+    uint32_t value = static_cast<uint32_t>(key);
+    return encode(out, (value << 1) ^ (key < 0 ? 0xFFFFFFFFu : 0));
+  }
+
+  /// Writes string as length and bytes
+  static unsigned char *encodeString(unsigned char *out,
+                                     const std::string &text) {
+    out = encode(out, text.size());
+    std::memcpy(out, text.data(), text.size());
+    return out + text.size();
+  }
+
+  /// Decodes value and moves position past it, returns false if record ends
+  static bool decode(const unsigned char *&position, const unsigned char *end,
+                     uint64_t &value) {
+    value = 0;
+    for (unsigned shift = 0; position < end && shift < 64; shift += 7) {
+      unsigned char byte = *position++;
+      value |= uint64_t(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0)
+        return true;
+    }
+    return false;
+  }
+
+  /// Decodes zigzag encoded key
+  static bool decodeKey(const unsigned char *&position,
+                        const unsigned char *end, int &key) {
+    uint64_t value = 0;
+    if (!decode(position, end, value) || value > 0xFFFFFFFFu)
+      return false;
+    uint32_t bits = static_cast<uint32_t>(value);
+    key = static_cast<int>((bits >> 1) ^ (0u - (bits & 1)));
+    return true;
+  }
+
+  /// Decodes string written by encodeString
+  static bool decodeString(const unsigned char *&position,
+                           const unsigned char *end, std::string &text) {
+    uint64_t size = 0;
+    if (!decode(position, end, size) ||
+        size > static_cast<uint64_t>(end - position))
+      return false;
+    text.assign(reinterpret_cast<const char *>(position), size);
+    position += size;
+    return true;
+  }
+};
+
+/**
+ * Encoding of Vertex info in records of mutation log. Trivially copyable
+ * types are copied as bytes and strings are written as length and bytes,
+ * other types need specialization with supported set to true and the same
+ * functions, graphs of them can not open log otherwise
+ *
+ * @tparam V type of data stored in graph vertices
+ */
+template <typename V, typename Enable = void> struct LogCodec {
+  /// True if info of type V can be logged
+  static constexpr bool supported = false;
+
+  /// Returns largest size of encoded info
+  static size_t maxBytes(const V &) { return 0; }
+
+  /// Writes info and returns position after it
+  static unsigned char *encode(unsigned char *out, const V &) { return out; }
+
+  /// Decodes info and moves position past it, returns false if record ends
+  static bool decode(const unsigned char *&, const unsigned char *, V &) {
+    return false;
+  }
+};
+
+/**
+ * Encoding of trivially copyable Vertex info, copied as bytes
+ */
+template <typename V>
+struct LogCodec<V, std::enable_if_t<std::is_trivially_copyable_v<V>>> {
+  /// True if info of type V can be logged
+  static constexpr bool supported = true;
+
+  /// Returns largest size of encoded info
+  static size_t maxBytes(const V &) { return sizeof(V); }
+
+  /// Writes info and returns position after it
+  static unsigned char *encode(unsigned char *out, const V &info) {
+    std::memcpy(out, &info, sizeof(V));
+    return out + sizeof(V);
+  }
+
+  /// Decodes info and moves position past it, returns false if record ends
+  static bool decode(const unsigned char *&position, const unsigned char *end,
+                     V &info) {
+    if (static_cast<size_t>(end - position) < sizeof(V))
+      return false;
+    std::memcpy(static_cast<void *>(&info), position, sizeof(V));
+    position += sizeof(V);
+    return true;
+  }
+};
+
+/**
+ * Encoding of std::string Vertex info, written as length and bytes
+ */
+template <> struct LogCodec<std::string> {
+  /// True if info of type V can be logged
+  static constexpr bool supported = true;
+
+  /// Returns largest size of encoded info
+  static size_t maxBytes(const std::string &info) {
+    return LogVarint::maxBytes + info.size();
+  }
+
+  /// Writes info and returns position after it
+  static unsigned char *encode(unsigned char *out, const std::string &info) {
+    return LogVarint::encodeString(out, info);
+  }
+
+  /// Decodes info and moves position past it, returns false if record ends
+  static bool decode(const unsigned char *&position, const unsigned char *end,
+                     std::string &info) {
+    return LogVarint::decodeString(position, end, info);
+  }
+};
+
+/// Magic bytes at start of mutation log and checkpoint files
+constexpr char mutationLogMagic[8] = {'G', 'R', 'A', 'P', 'H', 'L', 'O', 'G'};
+
+/// Version of mutation log format
+constexpr uint32_t mutationLogVersion = 1;
+
+/**
+ * Header of mutation log and checkpoint files. Checkpoint with epoch e holds
+ * graph as it was when log of epoch e was started, so log is replayed after
+ * checkpoint only if their epochs are the same
+ */
+struct MutationLogHeader {
+  char magic[8];    ///< "GRAPHLOG"
+  uint32_t version; ///< version of format
+  uint32_t kind;    ///< 0 for log, 1 for checkpoint
+  uint64_t epoch;   ///< number of checkpoint that log follows
+};
+
+/**
+ * Header of group of records, written at once. Records are padded with zeros
+ * to multiple of 8 bytes, checksum covers padded records
+ */
+struct MutationLogFrame {
+  uint32_t bytes;    ///< size of records, without padding
+  uint32_t records;  ///< number of records
+  uint64_t checksum; ///< checksum of padded records
+};
+
+/**
+ * Implementation of the MutationLogWriter class.
+ *
+ * MutationLogWriter encodes records of mutations of graph in buffer of group
+ * of records. Full group is handed to flusher thread, that writes it to file
+ * as one frame and syncs file with fdatasync, while next group is encoded, so
+ * mutations wait for disk only if flusher is still busy with previous group.
+ * Used for mutation log and for checkpoints.
+ *
+ * @tparam V type of data stored in graph vertices
+ */
+template <typename V> class MutationLogWriter {
+public:
+  /// Default size of group of records that is committed at once
+  static constexpr size_t defaultGroupBytes = size_t(1) << 20;
+
+private:
+  /**
+   * Descriptor of file, -1 if no file is open
+   */
+  int fd = -1;
+
+  /**
+   * Header of frame and encoded records of group that is not committed yet
+   */
+  std::vector<unsigned char> buffer;
+
+  /**
+   * Size of header of frame and records in buffer
+   */
+  size_t used = sizeof(MutationLogFrame);
+
+  /**
+   * Number of records in buffer
+   */
+  uint32_t records = 0;
+
+  /**
+   * Size of file, with groups handed to flusher
+   */
+  uint64_t written = 0;
+
+  /**
+   * Size of group of records that is committed on its own
+   */
+  size_t groupBytes = defaultGroupBytes;
+
+  /// Group that flusher writes, guarded by mutex
+  std::vector<unsigned char> flushing;
+
+  /// Thread that writes and syncs groups
+  std::thread flusher;
+
+  /// Guards flushing, busy, stopping and failed
+  std::mutex mutex;
+
+  /// Signals new group for flusher and written group for writer
+  std::condition_variable changed;
+
+  /// True while flusher has group to write
+  bool busy = false;
+
+  /// True when flusher has to stop
+  bool stopping = false;
+
+  /// True if write or sync of any group failed
+  bool failed = false;
+
+  /**
+   * Writes all bytes, returns false on error
+   */
+  bool writeAll(const void *data, size_t bytes);
+
+  /**
+   * Writes groups handed over by commit, runs on flusher thread
+   */
+  void flush();
+
+  /**
+   * Returns position in buffer with room for given number of bytes
+   */
+  unsigned char *reserve(size_t bytes) {
+    if (buffer.size() < used + bytes)
+      buffer.resize(std::max(buffer.size() * 2, used + bytes));
+    return buffer.data() + used;
+  }
+
+  /**
+   * Counts record that ends at position and commits group if it is full
+   */
+  void added(unsigned char *end) {
+    used = static_cast<size_t>(end - buffer.data());
+    ++records;
+    if (pendingBytes() >= groupBytes)
+      commit(false);
+  }
+
+public:
+  /**
+   * Constructor of MutationLogWriter
+   *
+   * Constructor takes no arguments, no file is open.
+   */
+  MutationLogWriter() = default;
+
+  /**
+   * Destructor of MutationLogWriter
+   *
+   * Commits records and closes file.
+   */
+  ~MutationLogWriter() { close(); }
+
+  /// Disabling construction of MutationLogWriter object using copy constructor
+  MutationLogWriter(const MutationLogWriter &rhs) = delete;
+
+  /// Disabling construction of MutationLogWriter object using copy assignment
+  MutationLogWriter &operator=(const MutationLogWriter &rhs) = delete;
+
+  /**
+   * Creates file with header, or opens existing file and appends after given
+   * size, file is truncated to it
+   *
+   * @param path path of file
+   * @param kind 0 for log, 1 for checkpoint
+   * @param epoch epoch written to header of new file
+   * @param size size of valid part of existing file, 0 to create new file
+   *
+   * @return true if file is opened
+   */
+  bool open(const std::string &path, uint32_t kind, uint64_t epoch,
+            uint64_t size = 0);
+
+  /**
+   * Commits records and closes file
+   *
+   * @return true if all records were written and synced
+   */
+  bool close();
+
+  /**
+   * Hands records of buffer to flusher as one group
+   *
+   * @param wait if true, returns when group is written and synced
+   *
+   * @return true if no write or sync failed so far
+   */
+  bool commit(bool wait = true);
+
+  /**
+   * Returns size of records that are not committed
+   */
+  size_t pendingBytes() const { return used - sizeof(MutationLogFrame); }
+
+  /**
+   * Returns size of file, records that are not committed excluded
+   */
+  uint64_t fileBytes() const { return written; }
+
+  /**
+   * Sets size of group of records, group is committed when its records take
+   * that many bytes
+   *
+   * @param bytes size of group, 0 to commit each record on its own
+   */
+  void setGroupBytes(size_t bytes) { groupBytes = bytes; }
+
+  /// Encodes record of vertex
+  void addVertex(int key, const V &info) {
+    unsigned char *out =
+        reserve(1 + LogVarint::maxBytes + LogCodec<V>::maxBytes(info));
+    *out++ = static_cast<uint8_t>(LogRecordType::AddVertex);
+    out = LogVarint::encodeKey(out, key);
+    added(LogCodec<V>::encode(out, info));
+  }
+
+  /// Encodes record of edge
+  void addEdge(int start, int stop) {
+    unsigned char *out = reserve(1 + 2 * LogVarint::maxBytes);
+    *out++ = static_cast<uint8_t>(LogRecordType::AddEdge);
+    out = LogVarint::encodeKey(out, start);
+    added(LogVarint::encodeKey(out, stop));
+  }
+
+  /// Encodes record of removed vertex
+  void removeVertex(int key) {
+    unsigned char *out = reserve(1 + LogVarint::maxBytes);
+    *out++ = static_cast<uint8_t>(LogRecordType::RemoveVertex);
+    added(LogVarint::encodeKey(out, key));
+  }
+
+  /// Encodes record of removed edge
+  void removeEdge(int start, int stop) {
+    unsigned char *out = reserve(1 + 2 * LogVarint::maxBytes);
+    *out++ = static_cast<uint8_t>(LogRecordType::RemoveEdge);
+    out = LogVarint::encodeKey(out, start);
+    added(LogVarint::encodeKey(out, stop));
+  }
+
+  /// Encodes record of range of edges, that are inserted at once
+  template <typename Range> void addEdges(const Range &edges) {
+    size_t count = static_cast<size_t>(
+        std::distance(std::begin(edges), std::end(edges)));
+    unsigned char *out = reserve(1 + (2 * count + 1) * LogVarint::maxBytes);
+    *out++ = static_cast<uint8_t>(LogRecordType::AddEdges);
+    out = LogVarint::encode(out, count);
+    for (const auto &[start, stop] : edges) {
+      out = LogVarint::encodeKey(out, start);
+      out = LogVarint::encodeKey(out, stop);
+    }
+    added(out);
+  }
+
+  /// Encodes record of labels that are added to, or removed from vertex
+  void label(LogRecordType type, int key,
+             const std::vector<std::string> &labels) {
+    size_t bytes = 1 + 2 * LogVarint::maxBytes;
+    for (const auto &l : labels) {
+      bytes += LogVarint::maxBytes + l.size();
+    }
+    unsigned char *out = reserve(bytes);
+    *out++ = static_cast<uint8_t>(type);
+    out = LogVarint::encodeKey(out, key);
+    out = LogVarint::encode(out, labels.size());
+    for (const auto &l : labels) {
+      out = LogVarint::encodeString(out, l);
+    }
+    added(out);
+  }
+};
+
+template <typename V>
+bool MutationLogWriter<V>::writeAll(const void *data, size_t bytes) {
+  const char *position = static_cast<const char *>(data);
+  while (bytes > 0) {
+    ssize_t count = ::write(fd, position, bytes);
+    if (count < 0)
+      return false;
+    position += count;
+    bytes -= static_cast<size_t>(count);
+  }
+  return true;
+}
+
+template <typename V>
+bool MutationLogWriter<V>::open(const std::string &path, uint32_t kind,
+                                uint64_t epoch, uint64_t size) {
+  close();
+  fd = ::open(path.c_str(), O_WRONLY | O_CREAT | (size == 0 ? O_TRUNC : 0),
+              0644);
+  if (fd < 0)
+    return false;
+  bool ok = true;
+  if (size != 0) {
+    // torn frame after the last valid one is cut off, new frames follow it
+    written = size;
+    ok = ::ftruncate(fd, static_cast<off_t>(size)) == 0 &&
+         ::lseek(fd, static_cast<off_t>(size), SEEK_SET) >= 0;
+  } else {
+    MutationLogHeader header{};
+    std::memcpy(header.magic, mutationLogMagic, sizeof(header.magic));
+    header.version = mutationLogVersion;
+    header.kind = kind;
+    header.epoch = epoch;
+    written = sizeof(header);
+    ok = writeAll(&header, sizeof(header)) && ::fdatasync(fd) == 0;
+  }
+  if (!ok) {
+    ::close(fd);
+    fd = -1;
+    return false;
+  }
+  failed = false;
+  stopping = false;
+  flusher = std::thread(&MutationLogWriter::flush, this);
+  return true;
+}
+
+template <typename V> bool MutationLogWriter<V>::close() {
+  if (fd < 0)
+    return true;
+  bool ok = commit(true);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  changed.notify_all();
+  flusher.join();
+  ::close(fd);
+  fd = -1;
+  written = 0;
+  return ok;
+}
+
+template <typename V> bool MutationLogWriter<V>::commit(bool wait) {
+  if (fd < 0)
+    return false;
+  std::unique_lock<std::mutex> lock(mutex);
+  if (records > 0) {
+    // frame is completed by flusher, only size of records and their number
+    // are set here
+    MutationLogFrame frame{};
+    frame.bytes = static_cast<uint32_t>(pendingBytes());
+    frame.records = records;
+    size_t padded = sizeof(frame) + (uint64_t(frame.bytes) + 7) / 8 * 8;
+    reserve(padded - used);
+    std::memset(buffer.data() + used, 0, padded - used);
+    std::memcpy(buffer.data(), &frame, sizeof(frame));
+    changed.wait(lock, [this]() { return !busy; });
+    flushing.swap(buffer);
+    flushing.resize(padded);
+    busy = true;
+    written += padded;
+    used = sizeof(frame);
+    records = 0;
+    changed.notify_all();
+  }
+  if (wait)
+    changed.wait(lock, [this]() { return !busy; });
+  return !failed;
+}
+
+template <typename V> void MutationLogWriter<V>::flush() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    changed.wait(lock, [this]() { return busy || stopping; });
+    if (!busy)
+      return;
+    lock.unlock();
+    MutationLogFrame frame{};
+    std::memcpy(&frame, flushing.data(), sizeof(frame));
+    uint64_t words[512];
+    for (size_t offset = sizeof(frame); offset < flushing.size();) {
+      size_t count = std::min<size_t>((flushing.size() - offset) / 8, 512);
+      std::memcpy(words, flushing.data() + offset, count * 8);
+      frame.checksum = graphFileChecksum(frame.checksum, words, count);
+      offset += count * 8;
+    }
+    std::memcpy(flushing.data(), &frame, sizeof(frame));
+    // frame is written with one call, fdatasync then makes the whole group
+    // of records durable at once
+    bool ok = writeAll(flushing.data(), flushing.size()) &&
+              ::fdatasync(fd) == 0;
+    lock.lock();
+    failed = failed || !ok;
+    busy = false;
+    changed.notify_all();
+  }
+}
+
+/**
+ * Reads mutation log or checkpoint file and calls apply(record) for each
+ * record of its valid frames, in order. Reading stops at first frame that is
+ * torn or has wrong checksum
+ *
+ * @param path path of file
+ * @param header header of file, set if file is read
+ * @param size size of valid part of file, header and valid frames
+ * @param apply function that takes const LogRecord<V> &
+ *
+ * @return false if file can not be read or is not mutation log file
+ */
+template <typename V, typename Apply>
+bool readMutationLog(const std::string &path, MutationLogHeader &header,
+                     uint64_t &size, Apply apply) {
+  std::FILE *file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr)
+    return false;
+  size = 0;
+  if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+      std::memcmp(header.magic, mutationLogMagic, sizeof(header.magic)) != 0 ||
+      header.version != mutationLogVersion) {
+    std::fclose(file);
+    return false;
+  }
+  size = sizeof(header);
+  std::fseek(file, 0, SEEK_END);
+  uint64_t fileSize = static_cast<uint64_t>(std::ftell(file));
+  std::fseek(file, sizeof(header), SEEK_SET);
+
+  MutationLogFrame frame{};
+  std::vector<uint64_t> words;
+  LogRecord<V> record;
+  while (std::fread(&frame, sizeof(frame), 1, file) == 1) {
+    // size of torn frame can be any number, so it is checked before records
+    // are read
+    if (uint64_t(frame.bytes) > fileSize - size - sizeof(frame))
+      break;
+    words.resize((uint64_t(frame.bytes) + 7) / 8);
+    if (std::fread(words.data(), 8, words.size(), file) != words.size() ||
+        graphFileChecksum(0, words.data(), words.size()) != frame.checksum)
+      break;
+    const unsigned char *position =
+        reinterpret_cast<const unsigned char *>(words.data());
+    const unsigned char *end = position + frame.bytes;
+    // checksum matched, so records are those that were written
+    for (uint32_t i = 0; i < frame.records && position < end; ++i) {
+      record.type = static_cast<LogRecordType>(*position++);
+      uint64_t count = 0;
+      bool ok = record.type == LogRecordType::AddEdges ||
+                LogVarint::decodeKey(position, end, record.key);
+      switch (record.type) {
+      case LogRecordType::AddVertex:
+        ok = ok && LogCodec<V>::decode(position, end, record.info);
+        break;
+      case LogRecordType::AddEdge:
+      case LogRecordType::RemoveEdge:
+        ok = ok && LogVarint::decodeKey(position, end, record.stop);
+        break;
+      case LogRecordType::RemoveVertex:
+        break;
+      case LogRecordType::AddEdges:
+        // each edge takes at least two bytes, so count is checked before
+        // edges are allocated
+        ok = LogVarint::decode(position, end, count) &&
+             count <= uint64_t(end - position) / 2;
+        record.edges.resize(ok ? count : 0);
+        for (auto &[start, stop] : record.edges) {
+          ok = ok && LogVarint::decodeKey(position, end, start) &&
+               LogVarint::decodeKey(position, end, stop);
+        }
+        break;
+      case LogRecordType::AddLabel:
+      case LogRecordType::RemoveLabel:
+        ok = ok && LogVarint::decode(position, end, count) &&
+             count <= uint64_t(end - position);
+        record.labels.resize(ok ? count : 0);
+        for (auto &l : record.labels) {
+          ok = ok && LogVarint::decodeString(position, end, l);
+        }
+        break;
+      default:
+        ok = false;
+      }
+      if (!ok) {
+        std::fclose(file);
+        return false;
+      }
+      apply(static_cast<const LogRecord<V> &>(record));
+    }
+    size += sizeof(frame) + words.size() * 8;
+  }
+  std::fclose(file);
+  return true;
+}
+
+/**
+ * Implementation of the MutationLog class.
+ *
+ * MutationLog is write-ahead log of mutations of graph, kept in file at path,
+ * with checkpoint of graph in file path.checkpoint. Records are encoded in
+ * compact binary form, keys as zigzag varints, and are committed in groups,
+ * so mutations do not wait for fdatasync each. Records of group that is not
+ * committed yet are lost on crash, commit() makes them durable at once.
+ *
+ * Checkpoint writes records that rebuild current graph to new checkpoint
+ * file, replaces old checkpoint with rename and then starts empty log, so
+ * recovery replays checkpoint and only the log written after it. Checkpoint
+ * and log carry epoch of checkpoint, log left by crash before it was
+ * restarted has older epoch and is not replayed again.
+ *
+ * @tparam V type of data stored in graph vertices
+ */
+template <typename V> class MutationLog {
+private:
+  /**
+   * Writer of log file
+   */
+  MutationLogWriter<V> log;
+
+  /**
+   * Path of log file
+   */
+  std::string logPath;
+
+  /**
+   * Epoch of last checkpoint
+   */
+  uint64_t epoch = 0;
+
+  /**
+   * Size of log after which checkpoint is due, 0 for checkpoints only when
+   * asked
+   */
+  uint64_t checkpointBytes = 0;
+
+  /**
+   * Reads header of file, returns false if file does not exist or is not
+   * mutation log file
+   */
+  static bool readHeader(const std::string &path, MutationLogHeader &header);
+
+public:
+  /**
+   * Opens log at path and replays checkpoint and log into graph, with
+   * apply(record) for each record, then appends new records to log
+   *
+   * @param path path of log file
+   * @param apply function that takes const LogRecord<V> &
+   *
+   * @return false if files can not be read or written, or checkpoint is
+   * damaged
+   */
+  template <typename Apply> bool open(const std::string &path, Apply apply);
+
+  /**
+   * Returns writer of log, records are encoded with its methods
+   */
+  MutationLogWriter<V> &writer() { return log; }
+
+  /**
+   * Commits records that are not committed yet
+   *
+   * @return true if records are written and synced
+   */
+  bool commit() { return log.commit(); }
+
+  /**
+   * Sets size of log after which checkpointDue() returns true
+   *
+   * @param bytes size of log, 0 for checkpoints only when asked
+   */
+  void setCheckpointBytes(uint64_t bytes) { checkpointBytes = bytes; }
+
+  /**
+   * Returns true if log grew past size set with setCheckpointBytes
+   */
+  bool checkpointDue() const {
+    return checkpointBytes != 0 &&
+           log.fileBytes() + log.pendingBytes() >= checkpointBytes;
+  }
+
+  /**
+   * Writes checkpoint, with write(writer) that encodes records that rebuild
+   * graph, and starts empty log
+   *
+   * @param write function that takes MutationLogWriter<V> &
+   *
+   * @return true if checkpoint is written
+   */
+  template <typename Write> bool checkpoint(Write write);
+};
+
+template <typename V>
+bool MutationLog<V>::readHeader(const std::string &path,
+                                MutationLogHeader &header) {
+  std::FILE *file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr)
+    return false;
+  bool ok = std::fread(&header, sizeof(header), 1, file) == 1 &&
+            std::memcmp(header.magic, mutationLogMagic,
+                        sizeof(header.magic)) == 0 &&
+            header.version == mutationLogVersion;
+  std::fclose(file);
+  return ok;
+}
+
+template <typename V>
+template <typename Apply>
+bool MutationLog<V>::open(const std::string &path, Apply apply) {
+  logPath = path;
+  epoch = 0;
+  MutationLogHeader header{};
+  uint64_t size = 0;
+  std::string checkpointPath = path + ".checkpoint";
+  struct stat status;
+  if (::stat(checkpointPath.c_str(), &status) == 0) {
+    // checkpoint is renamed in place only after it is synced, so all of it
+    // has to be valid
+    if (!readMutationLog<V>(checkpointPath, header, size, apply) ||
+        header.kind != 1 || size != static_cast<uint64_t>(status.st_size))
+      return false;
+    epoch = header.epoch;
+  }
+  if (readHeader(path, header) && header.kind == 0 && header.epoch == epoch) {
+    if (!readMutationLog<V>(path, header, size, apply))
+      return false;
+    return log.open(path, 0, epoch, size);
+  }
+  return log.open(path, 0, epoch);
+}
+
+template <typename V>
+template <typename Write>
+bool MutationLog<V>::checkpoint(Write write) {
+  std::string checkpointPath = logPath + ".checkpoint";
+  std::string temporaryPath = checkpointPath + ".tmp";
+  {
+    MutationLogWriter<V> out;
+    if (!out.open(temporaryPath, 1, epoch + 1))
+      return false;
+    write(out);
+    if (!out.close())
+      return false;
+  }
+  if (std::rename(temporaryPath.c_str(), checkpointPath.c_str()) != 0)
+    return false;
+  // rename is made durable before log is restarted, otherwise crash could
+  // leave old checkpoint with empty log
+  std::string directory = logPath.substr(0, logPath.find_last_of('/') + 1);
+  int fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    ::fsync(fd);
+    ::close(fd);
+  }
+  ++epoch;
+  return log.open(logPath, 0, epoch);
+}
+
+} // namespace graph
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <thread>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Calls fn(part) for each part in range [0, parts), every part on its own
+ * thread. Part 0 runs on calling thread, function returns when all parts are
+ * done. With one part no thread is started.
+ *
+ * @param parts number of parts
+ * @tparam fn function that takes number of part
+ */
+template <typename Function> void parallelFor(unsigned parts, Function fn) {
+  std::vector<std::thread> workers;
+  workers.reserve(parts > 0 ? parts - 1 : 0);
+  for (unsigned part = 1; part < parts; part++) {
+    workers.emplace_back(fn, part);
+  }
+  if (parts > 0)
+    fn(0u);
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+} // namespace graph
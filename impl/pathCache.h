@@ -0,0 +1,220 @@
+#pragma once
+
+#include "pathQuery.h"
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Counters of PathCache, used to size the cache
+ */
+struct PathCacheStats {
+  uint64_t hits = 0;   ///< lookups answered from cache
+  uint64_t misses = 0; ///< lookups of keys not in cache, or of stale entries
+  size_t size = 0;     ///< number of entries in cache
+  size_t capacity = 0; ///< maximum number of entries
+};
+
+/**
+ * Implementation of the PathCache class.
+ *
+ * PathCache keeps results of recent shortest path searches, by start and stop
+ * key, search mode and compiled labels of search. Each entry is stamped with
+ * generation of graph when it was searched, entry is stale when graph was
+ * changed after that in a way that can change its result, lookup then counts
+ * it as a miss and the next insert overwrites it.
+ *
+ * Entries are stored in one vector of capacity entries and evicted with CLOCK
+ * algorithm: hit sets reference bit of entry, the hand clears reference bits
+ * until it finds an entry that was not used since hand last passed it, and
+ * that entry is replaced. Lookups of keys are done in hash map of positions.
+ *
+ * PathCache is not thread safe, graph locks it.
+ */
+class PathCache {
+public:
+  /**
+   * Key of cached search, labels are compiled, so the same labels in any
+   * order give the same key
+   */
+  struct Key {
+    int start;                     ///< key id of source Vertex
+    int stop;                      ///< key id of destination Vertex
+    SearchMode mode;               ///< search mode
+    uint64_t bits;                 ///< bits of labels with id < 64
+    std::vector<uint32_t> overflow; ///< sorted ids of labels with id >= 64
+
+    bool operator==(const Key &rhs) const {
+      return start == rhs.start && stop == rhs.stop && mode == rhs.mode &&
+             bits == rhs.bits && overflow == rhs.overflow;
+    }
+  };
+
+private:
+  /**
+   * Hash of key, combines all its fields
+   */
+  struct KeyHash {
+    size_t operator()(const Key &key) const {
+      uint64_t hash = (uint64_t(uint32_t(key.start)) << 32) ^
+                      uint32_t(key.stop) ^
+                      (uint64_t(key.mode) << 31);
+      hash = (hash ^ key.bits) * 0x9E3779B97F4A7C15ull;
+      for (auto id : key.overflow) {
+        hash = (hash ^ id) * 0x9E3779B97F4A7C15ull;
+      }
+      return static_cast<size_t>(hash ^ (hash >> 32));
+    }
+  };
+
+  /**
+   * Cached result of one search
+   */
+  struct Entry {
+    Key key;               ///< key of search
+    uint64_t generation;   ///< generation of graph when search was done
+    bool found;            ///< true if path was found
+    std::vector<int> path; ///< keys of vertices on path, stop excluded
+    bool referenced;       ///< set by hit, cleared by CLOCK hand
+  };
+
+  /**
+   * Entries of cache, at most capacity of them
+   */
+  std::vector<Entry> entries;
+
+  /**
+   * Positions of entries, by key
+   */
+  std::unordered_map<Key, size_t, KeyHash> positions;
+
+  /**
+   * Maximum number of entries, 0 disables cache
+   */
+  size_t maxEntries = 0;
+
+  /**
+   * Position of CLOCK hand in entries
+   */
+  size_t hand = 0;
+
+  /**
+   * Counters of hits and misses
+   */
+  uint64_t hits = 0, misses = 0;
+
+public:
+  /**
+   * Constructor of PathCache
+   *
+   * @param capacity maximum number of entries, 0 disables cache
+   */
+  explicit PathCache(size_t capacity = 0) : maxEntries(capacity) {}
+
+  /**
+   * Returns maximum number of entries
+   */
+  size_t capacity() const { return maxEntries; }
+
+  /**
+   * Sets maximum number of entries and removes all entries, counters are
+   * reset
+   *
+   * @param capacity maximum number of entries, 0 disables cache
+   */
+  void setCapacity(size_t capacity);
+
+  /**
+   * Finds result of search in cache
+   *
+   * @param key key of search
+   * @param validSince entries with older generation are stale
+   * @param found true if cached search found path
+   * @param path keys of vertices on cached path, stop excluded
+   *
+   * @return true if result is found and is not stale
+   */
+  bool find(const Key &key, uint64_t validSince, bool &found,
+            std::vector<int> &path);
+
+  /**
+   * Inserts result of search to cache, replaces entry of the same key or entry
+   * chosen by CLOCK hand when cache is full
+   *
+   * @param key key of search
+   * @param generation generation of graph when search was done
+   * @param found true if search found path
+   * @param path keys of vertices on path, stop excluded
+   */
+  void insert(const Key &key, uint64_t generation, bool found,
+              const std::vector<int> &path);
+
+  /**
+   * Returns counters of cache
+   */
+  PathCacheStats stats() const {
+    return PathCacheStats{hits, misses, entries.size(), maxEntries};
+  }
+};
+
+inline void PathCache::setCapacity(size_t capacity) {
+  maxEntries = capacity;
+  entries.clear();
+  entries.shrink_to_fit();
+  positions.clear();
+  hand = 0;
+  hits = 0;
+  misses = 0;
+}
+
+inline bool PathCache::find(const Key &key, uint64_t validSince, bool &found,
+                            std::vector<int> &path) {
+  auto it = positions.find(key);
+  if (it == positions.end() || entries[it->second].generation < validSince) {
+    ++misses;
+    return false;
+  }
+  Entry &entry = entries[it->second];
+  entry.referenced = true;
+  found = entry.found;
+  path.assign(entry.path.begin(), entry.path.end());
+  ++hits;
+  return true;
+}
+
+inline void PathCache::insert(const Key &key, uint64_t generation, bool found,
+                              const std::vector<int> &path) {
+  if (maxEntries == 0)
+    return;
+  size_t position = 0;
+  auto it = positions.find(key);
+  if (it != positions.end()) {
+    position = it->second;
+  } else if (entries.size() < maxEntries) {
+    position = entries.size();
+    entries.push_back(Entry{key, 0, false, {}, false});
+    positions.emplace(key, position);
+  } else {
+    // hand gives every entry a second chance, entries hit since hand passed
+    // them are kept
+    while (entries[hand].referenced) {
+      entries[hand].referenced = false;
+      hand = (hand + 1) % entries.size();
+    }
+    position = hand;
+    hand = (hand + 1) % entries.size();
+    positions.erase(entries[position].key);
+    entries[position].key = key;
+    positions.emplace(key, position);
+  }
+  Entry &entry = entries[position];
+  entry.generation = generation;
+  entry.found = found;
+  entry.path.assign(path.begin(), path.end());
+  entry.referenced = false;
+}
+
+} // namespace graph
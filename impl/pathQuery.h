@@ -0,0 +1,71 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Modes of shortest path search
+ */
+enum class SearchMode {
+  Forward,       ///< search from start vertex until stop vertex is reached
+  Bidirectional, ///< searches from start and stop vertex that meet in between
+  Landmarks, ///< A* search towards stop vertex, with bounds of landmarks
+  ContractionHierarchy ///< upward searches in contraction hierarchy
+};
+
+/**
+ * Shortest path query, one of batch of queries
+ */
+struct PathQuery {
+  int start;                      ///< key id of source Vertex
+  int stop;                       ///< key id of destination Vertex
+  std::vector<std::string> label; ///< labels of Vertices on path
+  SearchMode mode = SearchMode::Forward; ///< search mode
+};
+
+/**
+ * Result of shortest path query
+ *
+ * Result can be reused by many queries, path keeps its storage, so queries
+ * with paths that fit in it do not allocate.
+ */
+struct PathResult {
+  bool found = false;    ///< true if stop Vertex is reached
+  int distance = 0;      ///< number of edges on path, all edges have weight 1
+  std::vector<int> path; ///< keys of Vertices on path, start and stop included
+
+  /**
+   * Resets result to not found, storage of path is kept
+   */
+  void clear() {
+    found = false;
+    distance = 0;
+    path.clear();
+  }
+};
+
+/**
+ * Prints keys of Vertices on path of result, separated by "->", or "no path"
+ * if path is not found. Searches do not print, paths are printed only by
+ * caller.
+ *
+ * @param out stream that path is printed to
+ * @param result result of shortest path query
+ *
+ * @return out
+ */
+inline std::ostream &operator<<(std::ostream &out, const PathResult &result) {
+  if (!result.found)
+    return out << "no path";
+  for (size_t i = 0; i < result.path.size(); i++) {
+    if (i > 0)
+      out << "->";
+    out << result.path[i];
+  }
+  return out;
+}
+
+} // namespace graph
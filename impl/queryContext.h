@@ -0,0 +1,274 @@
+#pragma once
+
+#include "directionOptimizingBfs.h"
+#include "frontierQueue.h"
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Implementation of the QueryContext class.
+ *
+ * QueryContext keeps all state of shortest path search: distances, previous
+ * and next vertices of reached vertices, frontier queue, levels of
+ * bidirectional search, breadth first search engine for frozen graph and the
+ * found path. Graph is only read during search, so searches with different
+ * contexts can run at the same time, on different threads. Context is reused
+ * between searches, so its storage is allocated once.
+ *
+ * Search elements of vertex are stamped with epoch of search that set them,
+ * elements with older epoch are not set. Each search takes a new epoch, so
+ * elements set by previous search are reset at once, without visiting them.
+ *
+ * @tparam V type of data stored in graph vertices
+ */
+template <typename V> class QueryContext {
+public:
+  /// Distance of vertex that is not reached
+  static constexpr int infinity = std::numeric_limits<int>::max();
+
+  /// Dense index used for no vertex, in previous and next
+  static constexpr uint32_t noVertex = std::numeric_limits<uint32_t>::max();
+
+private:
+  /**
+   * Search elements of one vertex
+   */
+  struct Element {
+    uint32_t epoch;      ///< epoch of search that set elements
+    int distance;        ///< distance from start vertex
+    uint32_t previous;   ///< dense index of previous vertex on path
+    int reverseDistance; ///< distance to stop vertex
+    uint32_t next;       ///< dense index of next vertex on path
+  };
+
+  /**
+   * Search elements of vertices, indexed by dense index
+   */
+  std::vector<Element> elements;
+
+  /**
+   * Epoch of current search
+   */
+  uint32_t epoch = 0;
+
+  /**
+   * Used in Dijkstra algorithm, min heap of < distance, dense index > pairs of
+   * vertices that are reached, but not yet visited
+   */
+  FrontierQueue<uint32_t> frontierQueue;
+
+  /**
+   * Used in search in contraction hierarchy, min heap of < distance, dense
+   * index > pairs of search from stop vertex
+   */
+  FrontierQueue<uint32_t> backwardQueue;
+
+  /**
+   * Used in landmark search, min heap of < estimate of path length, lower
+   * bound << 32 | dense index > pairs, so vertices of equal estimate that are
+   * closer to stop vertex are visited first
+   */
+  FrontierQueue<uint64_t> estimateQueue;
+
+  /**
+   * Used in bidirectional search, dense indices of vertices in current level
+   * of search from start vertex and of search from stop vertex, and in next
+   * level of search
+   */
+  std::vector<uint32_t> forwardVertices, backwardVertices, nextVertices;
+
+  /**
+   * Keys of vertices on the shortest path found by last search, stop vertex
+   * excluded. Storage is kept between searches
+   */
+  std::vector<int> foundPath;
+
+  /**
+   * Breadth first search engine used for searches over CSR snapshot
+   */
+  DirectionOptimizingBfs<V> breadthFirstSearch;
+
+  /**
+   * Number of vertices visited by last Dijkstra, landmark or hierarchy
+   * search
+   */
+  size_t visitedVertices = 0;
+
+  /**
+   * Returns elements of vertex, reset first if they were set by previous
+   * search
+   *
+   * @param index dense index of Vertex
+   */
+  Element &element(uint32_t index);
+
+public:
+  /**
+   * Starts new search over graph with vertexCount vertices
+   *
+   * Elements of all vertices are reset by taking new epoch, frontier, levels
+   * and path are cleared.
+   *
+   * @param vertexCount number of vertices in graph
+   */
+  void begin(size_t vertexCount);
+
+  /**
+   * Returns distance of vertex from start vertex, infinity if not reached
+   */
+  int distance(uint32_t index) const {
+    return elements[index].epoch == epoch ? elements[index].distance
+                                          : infinity;
+  }
+
+  /**
+   * Returns dense index of previous vertex on path, noVertex if not set
+   */
+  uint32_t previous(uint32_t index) const {
+    return elements[index].epoch == epoch ? elements[index].previous
+                                          : noVertex;
+  }
+
+  /**
+   * Returns distance of vertex to stop vertex, infinity if not reached
+   */
+  int reverseDistance(uint32_t index) const {
+    return elements[index].epoch == epoch ? elements[index].reverseDistance
+                                          : infinity;
+  }
+
+  /**
+   * Returns dense index of next vertex on path, noVertex if not set
+   */
+  uint32_t next(uint32_t index) const {
+    return elements[index].epoch == epoch ? elements[index].next : noVertex;
+  }
+
+  /**
+   * Sets distance of vertex from start vertex and previous vertex on path
+   *
+   * @param index dense index of Vertex
+   * @param distance distance from start vertex
+   * @param previous dense index of previous vertex
+   */
+  void setDistance(uint32_t index, int distance, uint32_t previous) {
+    Element &e = element(index);
+    e.distance = distance;
+    e.previous = previous;
+  }
+
+  /**
+   * Sets distance of vertex to stop vertex and next vertex on path
+   *
+   * @param index dense index of Vertex
+   * @param distance distance to stop vertex
+   * @param next dense index of next vertex
+   */
+  void setReverseDistance(uint32_t index, int distance, uint32_t next) {
+    Element &e = element(index);
+    e.reverseDistance = distance;
+    e.next = next;
+  }
+
+  /**
+   * Counts vertex visited by search
+   */
+  void visit() { ++visitedVertices; }
+
+  /**
+   * Returns number of vertices visited by last Dijkstra, landmark or
+   * hierarchy search
+   */
+  size_t visited() const { return visitedVertices; }
+
+  /**
+   * Returns frontier queue of Dijkstra algorithm
+   */
+  FrontierQueue<uint32_t> &frontier() { return frontierQueue; }
+
+  /**
+   * Returns frontier queue of search from stop vertex in contraction
+   * hierarchy
+   */
+  FrontierQueue<uint32_t> &backwardFrontier() { return backwardQueue; }
+
+  /**
+   * Returns frontier queue of landmark search
+   */
+  FrontierQueue<uint64_t> &estimateFrontier() { return estimateQueue; }
+
+  /**
+   * Returns current level of search from start vertex
+   */
+  std::vector<uint32_t> &forwardLevel() { return forwardVertices; }
+
+  /**
+   * Returns current level of search from stop vertex
+   */
+  std::vector<uint32_t> &backwardLevel() { return backwardVertices; }
+
+  /**
+   * Returns next level of bidirectional search
+   */
+  std::vector<uint32_t> &nextLevel() { return nextVertices; }
+
+  /**
+   * Returns path found by last search
+   */
+  std::vector<int> &path() { return foundPath; }
+
+  /**
+   * Returns path found by last search
+   */
+  const std::vector<int> &path() const { return foundPath; }
+
+  /**
+   * Returns breadth first search engine
+   */
+  DirectionOptimizingBfs<V> &bfs() { return breadthFirstSearch; }
+
+  /**
+   * Returns query context of calling thread, used by searches that are not
+   * given a context. Storage of context is reused by all searches of thread,
+   * over graph and over its published versions
+   */
+  static QueryContext<V> &threadContext() {
+    static thread_local QueryContext<V> context;
+    return context;
+  }
+};
+
+template <typename V>
+typename QueryContext<V>::Element &QueryContext<V>::element(uint32_t index) {
+  Element &e = elements[index];
+  if (e.epoch != epoch)
+    e = Element{epoch, infinity, noVertex, infinity, noVertex};
+  return e;
+}
+
+template <typename V> void QueryContext<V>::begin(size_t vertexCount) {
+  if (elements.size() < vertexCount)
+    elements.resize(vertexCount, Element{0, infinity, noVertex, infinity,
+                                         noVertex});
+  // after epoch wraps around, stamps of all vertices are cleared once, so no
+  // old stamp is taken as current
+  if (++epoch == 0) {
+    for (auto &e : elements) {
+      e.epoch = 0;
+    }
+    epoch = 1;
+  }
+  frontierQueue.clear();
+  backwardQueue.clear();
+  estimateQueue.clear();
+  forwardVertices.clear();
+  backwardVertices.clear();
+  nextVertices.clear();
+  foundPath.clear();
+  visitedVertices = 0;
+}
+
+} // namespace graph
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "flatHashMap.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Implementation of the ShortestPathTree class.
+ *
+ * ShortestPathTree keeps shortest paths from one start vertex to all vertices
+ * reached from it. Reached vertices are stored in order of distance, in three
+ * arrays: keys, distances from start vertex and positions of previous vertices
+ * on path in the same arrays, so previous vertex is always stored before the
+ * vertex. Position of a vertex is found by its key in FlatHashMap, path to it
+ * is then found by following previous vertices, in time that depends only on
+ * length of path.
+ *
+ * Tree does not refer to graph, it stays valid when graph is changed, but is
+ * not updated.
+ */
+class ShortestPathTree {
+public:
+  /// Distance of vertex that is not reached
+  static constexpr int infinity = std::numeric_limits<int>::max();
+
+  /// Position of previous vertex of start vertex
+  static constexpr uint32_t noParent = std::numeric_limits<uint32_t>::max();
+
+private:
+  /**
+   * Keys of reached vertices, in order of distance
+   */
+  std::vector<int> keys;
+
+  /**
+   * Distances of reached vertices from start vertex
+   */
+  std::vector<int> distances;
+
+  /**
+   * Positions of previous vertices on path, noParent for start vertex
+   */
+  std::vector<uint32_t> parents;
+
+  /**
+   * Positions of reached vertices, by key
+   */
+  FlatHashMap<int, uint32_t> positions;
+
+public:
+  /**
+   * Removes all vertices from tree
+   */
+  void clear();
+
+  /**
+   * Adds reached vertex to tree, vertices are added in order of distance
+   *
+   * @param key key of vertex
+   * @param distance distance from start vertex
+   * @param parent position of previous vertex on path, noParent for start
+   * vertex
+   */
+  void add(int key, int distance, uint32_t parent);
+
+  /**
+   * Returns number of reached vertices, start vertex included
+   */
+  size_t size() const { return keys.size(); }
+
+  /**
+   * Returns true if no vertex is reached, start vertex is not in graph
+   */
+  bool empty() const { return keys.empty(); }
+
+  /**
+   * Returns key of start vertex, tree must not be empty
+   */
+  int start() const { return keys.front(); }
+
+  /**
+   * Returns keys of reached vertices, in order of distance
+   */
+  const std::vector<int> &reached() const { return keys; }
+
+  /**
+   * Returns true if vertex is reached from start vertex
+   *
+   * @param key key of vertex
+   */
+  bool contains(int key) const { return positions.contains(key); }
+
+  /**
+   * Returns distance of vertex from start vertex, infinity if not reached
+   *
+   * @param key key of vertex
+   */
+  int distance(int key) const;
+
+  /**
+   * Finds shortest path from start vertex to vertex
+   *
+   * @param key key of vertex
+   * @param path keys of vertices on path, start and key vertex included
+   *
+   * @return true if vertex is reached, path is empty otherwise
+   */
+  bool path(int key, std::vector<int> &path) const;
+};
+
+inline void ShortestPathTree::clear() {
+  keys.clear();
+  distances.clear();
+  parents.clear();
+  positions.clear();
+}
+
+inline void ShortestPathTree::add(int key, int distance, uint32_t parent) {
+  positions.insert(key, static_cast<uint32_t>(keys.size()));
+  keys.push_back(key);
+  distances.push_back(distance);
+  parents.push_back(parent);
+}
+
+inline int ShortestPathTree::distance(int key) const {
+  uint32_t position = 0;
+  return positions.find(key, position) ? distances[position] : infinity;
+}
+
+inline bool ShortestPathTree::path(int key, std::vector<int> &path) const {
+  path.clear();
+  uint32_t position = 0;
+  if (!positions.find(key, position))
+    return false;
+  // previous vertices are followed back to start vertex, distance of vertex is
+  // length of its path
+  path.reserve(static_cast<size_t>(distances[position]) + 1);
+  for (; position != noParent; position = parents[position]) {
+    path.push_back(keys[position]);
+  }
+  std::reverse(path.begin(), path.end());
+  return true;
+}
+
+} // namespace graph
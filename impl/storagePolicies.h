@@ -0,0 +1,294 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Implementation of the LinkedStorage storage policy of GraphStore.
+ *
+ * Edges of each vertex are kept in its own vector, as dense indices of
+ * destination vertices in order of insertion, so edges are added at any time
+ * without rebuild.
+ */
+class LinkedStorage {
+private:
+  /**
+   * Vectors of edges, indexed by dense index of source vertex
+   */
+  std::vector<std::vector<uint32_t>> edges;
+
+  /**
+   * Number of edges
+   */
+  size_t count = 0;
+
+public:
+  /**
+   * Adds vertex without edges
+   */
+  void addVertex() { edges.emplace_back(); }
+
+  /**
+   * Adds edge from start vertex to stop vertex
+   *
+   * @param start dense index of source Vertex
+   * @param stop dense index of destination Vertex
+   */
+  void addEdge(uint32_t start, uint32_t stop) {
+    edges[start].push_back(stop);
+    ++count;
+  }
+
+  /**
+   * Prepares storage for searches, nothing is done
+   */
+  void prepare() {}
+
+  /**
+   * Returns number of edges
+   */
+  size_t edgeCount() const { return count; }
+
+  /**
+   * Calls visit(stop) for each edge of vertex with dense index, in order of
+   * insertion
+   */
+  template <typename Visit>
+  void forEachEdge(uint32_t index, Visit visit) const {
+    for (auto stop : edges[index]) {
+      visit(stop);
+    }
+  }
+};
+
+/**
+ * Implementation of the CsrStorage storage policy of GraphStore.
+ *
+ * Edges are kept in compressed sparse row arrays, edges of vertex with index
+ * i in neighbors between offsets[i] and offsets[i + 1], in order of
+ * insertion. New edges are collected and merged into arrays by prepare(),
+ * before the next search.
+ */
+class CsrStorage {
+private:
+  /**
+   * Offsets of edges of each vertex in neighbors, size is number of vertices
+   * + 1 after prepare()
+   */
+  std::vector<uint32_t> offsets{0};
+
+  /**
+   * Dense indices of destination vertices of all edges
+   */
+  std::vector<uint32_t> neighbors;
+
+  /**
+   * Edges added after the last prepare(), pairs < start, stop >
+   */
+  std::vector<std::pair<uint32_t, uint32_t>> added;
+
+  /**
+   * Number of vertices
+   */
+  uint32_t vertices = 0;
+
+public:
+  /**
+   * Adds vertex without edges
+   */
+  void addVertex() { ++vertices; }
+
+  /**
+   * Adds edge from start vertex to stop vertex, edge is in arrays after
+   * prepare()
+   *
+   * @param start dense index of source Vertex
+   * @param stop dense index of destination Vertex
+   */
+  void addEdge(uint32_t start, uint32_t stop) {
+    added.emplace_back(start, stop);
+  }
+
+  /**
+   * Merges added edges and vertices into arrays
+   */
+  void prepare();
+
+  /**
+   * Returns number of edges
+   */
+  size_t edgeCount() const { return neighbors.size() + added.size(); }
+
+  /**
+   * Calls visit(stop) for each edge of vertex with dense index, in order of
+   * insertion
+   */
+  template <typename Visit>
+  void forEachEdge(uint32_t index, Visit visit) const {
+    const uint32_t *edge = neighbors.data() + offsets[index];
+    const uint32_t *end = neighbors.data() + offsets[index + 1];
+    for (; edge != end; ++edge) {
+      visit(*edge);
+    }
+  }
+};
+
+inline void CsrStorage::prepare() {
+  if (added.empty() && offsets.size() == size_t(vertices) + 1)
+    return;
+  // new offsets count old and added edges of each vertex, added edges are
+  // placed after old ones in order of insertion
+  std::vector<uint32_t> merged(size_t(vertices) + 1, 0);
+  for (uint32_t index = 0; index + 1 < offsets.size(); ++index) {
+    merged[index + 1] = offsets[index + 1] - offsets[index];
+  }
+  for (const auto &edge : added) {
+    ++merged[edge.first + 1];
+  }
+  for (size_t i = 0; i < vertices; ++i) {
+    merged[i + 1] += merged[i];
+  }
+  std::vector<uint32_t> position(merged.begin(), merged.end() - 1);
+  std::vector<uint32_t> edges(merged.back());
+  for (uint32_t index = 0; index + 1 < offsets.size(); ++index) {
+    for (uint32_t i = offsets[index]; i < offsets[index + 1]; ++i) {
+      edges[position[index]++] = neighbors[i];
+    }
+  }
+  for (const auto &edge : added) {
+    edges[position[edge.first]++] = edge.second;
+  }
+  offsets.swap(merged);
+  neighbors.swap(edges);
+  std::vector<std::pair<uint32_t, uint32_t>>().swap(added);
+}
+
+/**
+ * Implementation of the CompressedStorage storage policy of GraphStore.
+ *
+ * Edges of each vertex are sorted and stored as differences of dense indices,
+ * the first from index of vertex and the others from previous edge, zigzag
+ * encoded in varints of 7 bit groups, so edges between vertices with near
+ * indices take one byte each. Edges are decoded while they are visited.
+ * New edges are collected and merged by prepare(), before the next search.
+ */
+class CompressedStorage {
+private:
+  /**
+   * Offsets of encoded edges of each vertex in bytes, size is number of
+   * vertices + 1 after prepare()
+   */
+  std::vector<uint64_t> offsets{0};
+
+  /**
+   * Encoded edges of all vertices
+   */
+  std::vector<uint8_t> bytes;
+
+  /**
+   * Edges added after the last prepare(), pairs < start, stop >
+   */
+  std::vector<std::pair<uint32_t, uint32_t>> added;
+
+  /**
+   * Number of vertices and number of edges in bytes
+   */
+  uint32_t vertices = 0;
+  size_t count = 0;
+
+public:
+  /**
+   * Adds vertex without edges
+   */
+  void addVertex() { ++vertices; }
+
+  /**
+   * Adds edge from start vertex to stop vertex, edge is encoded by prepare()
+   *
+   * @param start dense index of source Vertex
+   * @param stop dense index of destination Vertex
+   */
+  void addEdge(uint32_t start, uint32_t stop) {
+    added.emplace_back(start, stop);
+  }
+
+  /**
+   * Decodes edges, merges added edges and vertices and encodes them again
+   */
+  void prepare();
+
+  /**
+   * Returns number of edges
+   */
+  size_t edgeCount() const { return count + added.size(); }
+
+  /**
+   * Returns size of encoded edges in bytes
+   */
+  size_t encodedBytes() const { return bytes.size(); }
+
+  /**
+   * Calls visit(stop) for each edge of vertex with dense index, in ascending
+   * order of dense index
+   */
+  template <typename Visit>
+  void forEachEdge(uint32_t index, Visit visit) const {
+    const uint8_t *position = bytes.data() + offsets[index];
+    const uint8_t *end = bytes.data() + offsets[index + 1];
+    uint32_t stop = index;
+    while (position < end) {
+      uint32_t delta = 0;
+      for (unsigned shift = 0;; shift += 7) {
+        uint8_t byte = *position++;
+        delta |= uint32_t(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+          break;
+      }
+      stop += (delta >> 1) ^ (0 - (delta & 1));
+      visit(stop);
+    }
+  }
+};
+
+inline void CompressedStorage::prepare() {
+  if (added.empty() && offsets.size() == size_t(vertices) + 1)
+    return;
+  std::sort(added.begin(), added.end());
+  std::vector<uint64_t> merged(1, 0);
+  std::vector<uint8_t> encoded;
+  encoded.reserve(bytes.size() + added.size() * 2);
+  std::vector<uint32_t> edges;
+  auto next = added.begin();
+  for (uint32_t index = 0; index < vertices; ++index) {
+    edges.clear();
+    if (index + 1 < offsets.size())
+      forEachEdge(index, [&edges](uint32_t stop) { edges.push_back(stop); });
+    size_t old = edges.size();
+    for (; next != added.end() && next->first == index; ++next) {
+      edges.push_back(next->second);
+    }
+    std::inplace_merge(edges.begin(), edges.begin() + old, edges.end());
+    uint32_t previous = index;
+    for (auto stop : edges) {
+      int32_t difference = static_cast<int32_t>(stop - previous);
+      uint32_t delta = (uint32_t(difference) << 1) ^ uint32_t(difference >> 31);
+      while (delta >= 0x80) {
+        encoded.push_back(static_cast<uint8_t>(delta | 0x80));
+        delta >>= 7;
+      }
+      encoded.push_back(static_cast<uint8_t>(delta));
+      previous = stop;
+    }
+    merged.push_back(encoded.size());
+  }
+  count += added.size();
+  offsets.swap(merged);
+  bytes.swap(encoded);
+  std::vector<std::pair<uint32_t, uint32_t>>().swap(added);
+}
+
+} // namespace graph
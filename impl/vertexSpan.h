@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace graph {
+
+/**
+ * Implementation of the VertexSpan class.
+ *
+ * VertexSpan is a non-owning view of contiguous dense indices of vertices,
+ * usually edges of one vertex. It is two pointers, so it is passed by value
+ * and iterating it does not copy indices. Span is valid until the storage it
+ * points to is changed.
+ */
+class VertexSpan {
+private:
+  /**
+   * Pointer to first index of span
+   */
+  const uint32_t *first = nullptr;
+
+  /**
+   * Pointer past the last index of span
+   */
+  const uint32_t *last = nullptr;
+
+public:
+  /**
+   * Constructor of VertexSpan
+   *
+   * Constructor takes no arguments, span is empty.
+   */
+  VertexSpan() = default;
+
+  /**
+   * Constructor of VertexSpan
+   *
+   * @param first pointer to first index
+   * @param last pointer past the last index
+   */
+  VertexSpan(const uint32_t *first, const uint32_t *last)
+      : first(first), last(last) {}
+
+  /**
+   * Returns pointer to first index of span
+   */
+  const uint32_t *begin() const { return first; }
+
+  /**
+   * Returns pointer past the last index of span
+   */
+  const uint32_t *end() const { return last; }
+
+  /**
+   * Returns number of indices in span
+   */
+  size_t size() const { return static_cast<size_t>(last - first); }
+
+  /**
+   * Returns true if span has no indices
+   */
+  bool empty() const { return first == last; }
+
+  /**
+   * Returns index at position i of span
+   *
+   * @param i position in span
+   */
+  uint32_t operator[](size_t i) const { return first[i]; }
+};
+
+} // namespace graph
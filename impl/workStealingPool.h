@@ -0,0 +1,239 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Implementation of the WorkStealingPool class.
+ *
+ * WorkStealingPool is a pool of worker threads that runs batches of tasks,
+ * tasks are numbered 0 to count - 1. Tasks of batch are split in blocks of
+ * consecutive tasks, one block in deque of each worker. Worker takes tasks from
+ * the back of its own deque, and when its deque is empty, steals tasks from the
+ * front of deques of other workers, so workers that got cheaper tasks help the
+ * others until the whole batch is done.
+ *
+ * Threads are started once, in constructor, and wait for the next batch
+ * between batches. One batch runs at a time, run() returns when all tasks of
+ * batch are done.
+ */
+class WorkStealingPool {
+public:
+  /**
+   * Task function, called with number of task and number of worker that runs
+   * it
+   */
+  using Task = std::function<void(size_t task, unsigned worker)>;
+
+private:
+  /**
+   * Deque of tasks of one worker
+   */
+  struct Worker {
+    std::mutex mutex;
+    std::deque<size_t> tasks;
+  };
+
+  /**
+   * Deques of tasks, one for each worker
+   */
+  std::vector<std::unique_ptr<Worker>> workers;
+
+  /**
+   * Threads of workers
+   */
+  std::vector<std::thread> threads;
+
+  /**
+   * Guards batch, generation and stopping
+   */
+  std::mutex mutex;
+
+  /**
+   * Wakes workers when batch is started or pool is stopped
+   */
+  std::condition_variable wake;
+
+  /**
+   * Wakes thread that called run() when batch is done
+   */
+  std::condition_variable done;
+
+  /**
+   * Task function of current batch
+   */
+  const Task *batch = nullptr;
+
+  /**
+   * Number of batch, workers wait until it changes
+   */
+  size_t generation = 0;
+
+  /**
+   * Number of workers that are still taking tasks of current batch
+   */
+  unsigned active = 0;
+
+  /**
+   * Set to true by destructor, workers then exit
+   */
+  bool stopping = false;
+
+  /**
+   * Takes next task for worker, from its own deque or from deque of other
+   * worker
+   *
+   * @param worker number of worker
+   * @param task number of taken task
+   *
+   * @return true if task is taken, false if all deques are empty
+   */
+  bool takeTask(unsigned worker, size_t &task);
+
+  /**
+   * Main loop of worker thread
+   *
+   * @param worker number of worker
+   */
+  void work(unsigned worker);
+
+public:
+  /**
+   * Constructor of WorkStealingPool
+   *
+   * @param size number of worker threads, 0 for number of hardware threads
+   */
+  explicit WorkStealingPool(unsigned size = 0);
+
+  /**
+   * Destructor of WorkStealingPool, waits for workers to exit
+   */
+  ~WorkStealingPool();
+
+  /// Disabling construction of WorkStealingPool object using copy constructor
+  WorkStealingPool(const WorkStealingPool &rhs) = delete;
+
+  /// Disabling construction of WorkStealingPool object using copy assignment
+  WorkStealingPool &operator=(const WorkStealingPool &rhs) = delete;
+
+  /**
+   * Returns number of worker threads
+   */
+  unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+  /**
+   * Runs tasks 0 to count - 1 on workers and returns when all of them are
+   * done
+   *
+   * @param count number of tasks
+   * @param task function called for each task
+   */
+  void run(size_t count, const Task &task);
+};
+
+inline WorkStealingPool::WorkStealingPool(unsigned size) {
+  if (size == 0)
+    size = std::max(1u, std::thread::hardware_concurrency());
+  for (unsigned i = 0; i < size; i++) {
+    workers.push_back(std::make_unique<Worker>());
+  }
+  for (unsigned i = 0; i < size; i++) {
+    threads.emplace_back(&WorkStealingPool::work, this, i);
+  }
+}
+
+inline WorkStealingPool::~WorkStealingPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+inline bool WorkStealingPool::takeTask(unsigned worker, size_t &task) {
+  {
+    Worker &own = *workers[worker];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = own.tasks.back();
+      own.tasks.pop_back();
+      return true;
+    }
+  }
+  // other workers are tried in order after this one, so thieves spread over
+  // different deques
+  for (size_t i = 1; i < workers.size(); i++) {
+    Worker &victim = *workers[(worker + i) % workers.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = victim.tasks.front();
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+inline void WorkStealingPool::work(unsigned worker) {
+  size_t seen = 0;
+  while (true) {
+    const Task *task = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      wake.wait(lock, [&] { return stopping || generation != seen; });
+      if (stopping)
+        return;
+      seen = generation;
+      task = batch;
+    }
+
+    size_t index = 0;
+    while (takeTask(worker, index)) {
+      (*task)(index, worker);
+    }
+
+    // worker leaves batch only after its last task is done, so batch is done
+    // when the last worker leaves it
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--active == 0)
+      done.notify_all();
+  }
+}
+
+inline void WorkStealingPool::run(size_t count, const Task &task) {
+  if (count == 0)
+    return;
+  // tasks are given to workers in blocks of consecutive tasks, tasks that are
+  // close are often similar in cost
+  size_t size = workers.size();
+  for (size_t i = 0; i < size; i++) {
+    Worker &worker = *workers[i];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    for (size_t index = count * i / size; index < count * (i + 1) / size;
+         index++) {
+      worker.tasks.push_back(index);
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(mutex);
+  batch = &task;
+  active = static_cast<unsigned>(size);
+  ++generation;
+  wake.notify_all();
+  done.wait(lock, [&] { return active == 0; });
+  batch = nullptr;
+}
+
+} // namespace graph
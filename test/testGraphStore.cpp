@@ -1,6 +1,72 @@
 #define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "graphStore.h"
 #include "graphStoreLinked.h"
+#include <array>
 #include <catch.hpp>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <list>
+#include <memory_resource>
+#include <set>
+#include <sstream>
+#include <thread>
+
+/**
+ * Memory resource that takes every block from upstream resource, used to
+ * compare graph arena with allocation of each vertex and edge vector
+ */
+struct HeapResource : std::pmr::memory_resource {
+  std::pmr::memory_resource *upstream = std::pmr::new_delete_resource();
+  HeapResource() = default;
+  explicit HeapResource(std::pmr::memory_resource *upstream)
+      : upstream(upstream) {}
+  void *do_allocate(size_t bytes, size_t alignment) override {
+    return upstream->allocate(bytes, alignment);
+  }
+  void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+    upstream->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override {
+    return this == &other;
+  }
+};
+
+/**
+ * Memory resource that counts bytes and blocks taken from global allocator
+ */
+struct CountingResource : HeapResource {
+  size_t bytes = 0;
+  size_t blocks = 0;
+  void *do_allocate(size_t size, size_t alignment) override {
+    bytes += size;
+    ++blocks;
+    return HeapResource::do_allocate(size, alignment);
+  }
+  void do_deallocate(void *p, size_t size, size_t alignment) override {
+    bytes -= size;
+    --blocks;
+    HeapResource::do_deallocate(p, size, alignment);
+  }
+};
+
+/**
+ * Inserts 100.000 vertices and 100.000 edges in graph
+ */
+template <typename Resource>
+static void buildGraph(graph::GraphStoreLinked<int, Resource> &graph) {
+  for (int j = 0; j < 100000; j++) {
+    graph.addVertex(j, j);
+  }
+  for (int j = 0; j < 10000; j++) {
+    for (int k = 1; k <= 10; k++) {
+      graph.createEdge(j, j + 1000 * k + k);
+    }
+  }
+}
 
 TEST_CASE("Graph Store insert vertices, edges, add and remove labels for int "
           "data type") {
@@ -143,6 +209,778 @@ TEST_CASE("Graph Store insert vertexex - Benchmark") {
   };
 }
 
+TEST_CASE("Graph Store bulk insert vertices and edges - Benchmark") {
+  std::vector<std::pair<int, int>> vertices;
+  std::vector<std::pair<int, int>> edges;
+  for (int j = 0; j < 100000; j++) {
+    vertices.emplace_back(j, j);
+  }
+  for (int j = 0; j < 10000; j++) {
+    for (int k = 1; k <= 10; k++) {
+      edges.emplace_back(j, j + 1000 * k + k);
+    }
+  }
+
+  BENCHMARK("Add 100.000 vertices in graph with addVertices") {
+    graph::GraphStoreLinked<int> graph;
+    return graph.addVertices(vertices);
+  };
+
+  graph::GraphStoreLinked<int> graph;
+  graph.addVertices(vertices);
+  BENCHMARK_ADVANCED("Add 100.000 edges in graph of 100.000 vertices with "
+                     "addEdges")(Catch::Benchmark::Chronometer meter) {
+    std::vector<graph::GraphStoreLinked<int>> graphs(meter.runs());
+    for (auto &g : graphs) {
+      g.addVertices(vertices);
+    }
+    meter.measure([&](int i) { return graphs[i].addEdges(edges); });
+  };
+
+  BENCHMARK_ADVANCED("Add 100.000 edges in graph of 100.000 vertices with "
+                     "addEdges on 4 threads")(
+      Catch::Benchmark::Chronometer meter) {
+    std::vector<graph::GraphStoreLinked<int>> graphs(meter.runs());
+    for (auto &g : graphs) {
+      g.addVertices(vertices);
+    }
+    meter.measure([&](int i) { return graphs[i].addEdges(edges, 4); });
+  };
+}
+
+TEST_CASE("Graph Store bulk insert vertices and edges") {
+  graph::GraphStoreLinked<std::string> graph;
+  std::vector<std::pair<int, std::string>> vertices;
+  for (int j = 0; j < 1000; j++) {
+    vertices.emplace_back(j, std::to_string(j));
+  }
+  vertices.emplace_back(10, "duplicate");
+  CHECK(graph.addVertices(vertices) == 1000);
+  CHECK(graph.addVertices(vertices) == 0);
+  CHECK(graph.addVertex(1000, "1000") == true);
+
+  // edges come in random order, with duplicates and missing vertices
+  std::vector<std::pair<int, int>> edges;
+  for (int j = 999; j >= 0; j--) {
+    edges.emplace_back(j, j + 1);
+    edges.emplace_back(j, j + 1);
+  }
+  edges.emplace_back(5, 2000);
+  edges.emplace_back(2000, 5);
+  CHECK(graph.addEdges(edges) == 1000);
+  CHECK(graph.addEdges(edges) == 0);
+  CHECK(graph.createEdge(0, 2) == true);
+  CHECK(graph.addEdges(std::list<std::pair<int, int>>{{0, 2}, {0, 3}}) == 1);
+
+  for (int j = 0; j <= 1000; j++) {
+    CHECK(graph.addLabel(j, "a") == true);
+  }
+  std::vector<std::string> label;
+  CHECK(graph.shortestPath(0, 1000, label) == true);
+  CHECK(graph.shortestPath(1000, 0, label) == false);
+  CHECK(graph.shortestPath(0, 1000, label, graph::SearchMode::Bidirectional) ==
+        true);
+  graph.freeze();
+  CHECK(graph.snapshot().edgeCount() == 1002);
+  CHECK(graph.shortestPath(0, 1000, label) == true);
+
+  // graph built on many threads has the same edges and incoming edges as
+  // graph built with createEdge
+  std::vector<std::pair<int, int>> intVertices;
+  std::vector<std::pair<int, int>> randomEdges;
+  for (int j = 0; j < 20000; j++) {
+    intVertices.emplace_back(j, j);
+  }
+  for (int j = 0; j < 200000; j++) {
+    randomEdges.emplace_back(j * 7919 % 20000,
+                             (j % 20000 * 4729 + j / 20000 * 31 + 13) % 20000);
+  }
+  graph::GraphStoreLinked<int> single;
+  graph::GraphStoreLinked<int> parallel;
+  single.addVertices(intVertices);
+  parallel.addVertices(intVertices);
+  for (const auto &[start, stop] : randomEdges) {
+    single.createEdge(start, stop);
+  }
+  size_t inserted = parallel.addEdges(randomEdges, 4);
+  CHECK(parallel.addEdges(randomEdges, 4) == 0);
+  const auto &singleSnapshot = single.snapshot();
+  const auto &parallelSnapshot = parallel.snapshot();
+  CHECK(inserted == parallelSnapshot.edgeCount());
+  REQUIRE(singleSnapshot.vertexCount() == parallelSnapshot.vertexCount());
+  bool sameEdges = true;
+  for (uint32_t j = 0; j < singleSnapshot.vertexCount(); j++) {
+    for (bool incoming : {false, true}) {
+      std::set<uint32_t> expected(
+          incoming ? singleSnapshot.incomingBegin(j)
+                   : singleSnapshot.edgesBegin(j),
+          incoming ? singleSnapshot.incomingEnd(j)
+                   : singleSnapshot.edgesEnd(j));
+      std::vector<uint32_t> found(
+          incoming ? parallelSnapshot.incomingBegin(j)
+                   : parallelSnapshot.edgesBegin(j),
+          incoming ? parallelSnapshot.incomingEnd(j)
+                   : parallelSnapshot.edgesEnd(j));
+      std::sort(found.begin(), found.end());
+      if (!std::equal(expected.begin(), expected.end(), found.begin(),
+                      found.end()))
+        sameEdges = false;
+    }
+  }
+  CHECK(sameEdges);
+}
+
+TEST_CASE("Graph Store concurrent ingest") {
+  graph::GraphStoreLinked<int> graph;
+  for (int j = 0; j < 100; j++) {
+    graph.addVertex(j, j);
+  }
+  graph.beginIngest();
+
+  // every thread adds every key, each key is added once, keys that graph
+  // already has are rejected
+  const int keys = 10000;
+  const int threadCount = 8;
+  std::vector<std::atomic<int>> added(keys);
+  auto run = [threadCount](auto &&body) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+      threads.emplace_back(body, t);
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  };
+  run([&](int t) {
+    for (int i = 0; i < keys; i++) {
+      int key = (i + t * keys / threadCount) % keys;
+      if (graph.addVertex(key, t))
+        ++added[key];
+    }
+  });
+  int addedOnce = 0;
+  for (int key = 0; key < keys; key++) {
+    if (added[key] == (key < 100 ? 0 : 1))
+      ++addedOnce;
+  }
+  CHECK(addedOnce == keys);
+
+  // edges and labels of added vertices, with duplicates, edges and labels of
+  // missing vertices are rejected
+  std::vector<int> rejected(threadCount, 0);
+  run([&](int t) {
+    for (int key = t; key + 1 < keys; key += threadCount) {
+      if (!graph.createEdge(key, key + 1) || !graph.createEdge(key, key + 1) ||
+          !graph.addLabel(key + 1, "a"))
+        ++rejected[t];
+      if (graph.createEdge(key, keys + key) || graph.addLabel(keys + key, "a"))
+        ++rejected[t];
+    }
+  });
+  CHECK(rejected == std::vector<int>(threadCount, 0));
+
+  // vertices and their edges are added by the same thread, while other
+  // threads add theirs
+  run([&](int t) {
+    int previous = t;
+    for (int i = 0; i < 1000; i++) {
+      int key = keys + t * 1000 + i;
+      if (!graph.addVertex(key, key) || !graph.createEdge(previous, key))
+        ++rejected[t];
+      previous = key;
+    }
+  });
+  CHECK(rejected == std::vector<int>(threadCount, 0));
+
+  // bulk edges and removals are rejected while ingest runs, bulk vertices are
+  // added to ingest
+  std::vector<std::pair<int, int>> bulkEdges{{0, 1}, {1, 2}};
+  CHECK(graph.addEdges(bulkEdges) == 0);
+  CHECK(graph.removeLabel(1, "a") == false);
+  CHECK(graph.removeEdge(0, 1) == false);
+  std::vector<std::pair<int, int>> bulkVertices{{-2, -2}, {0, 0}};
+  CHECK(graph.addVertices(bulkVertices) == 1);
+
+  // graph is not changed until ingest ends. Edge created twice is inserted as
+  // parallel edge, as createEdge does without ingest
+  CHECK(graph.shortestPath(0, 5, std::vector<std::string>{}) == false);
+  CHECK(graph.componentCount() == 100);
+  CHECK(graph.endIngest(4) == 2 * (keys - 1) + threadCount * 1000);
+  CHECK(graph.snapshot().edgeCount() == 2 * (keys - 1) + threadCount * 1000);
+  CHECK(graph.componentCount() == 2);
+  CHECK(graph.findVerticesWithLabel("a").size() == keys - 1);
+  graph::PathResult result;
+  CHECK(graph.shortestPath(0, keys - 1, {"a"}, result) == true);
+  CHECK(result.distance == keys - 1);
+  CHECK(graph.shortestPath(3, keys + 3 * 1000 + 999, {}, result) == true);
+  CHECK(result.distance == 1000);
+
+  // graph is changed by one thread again
+  CHECK(graph.addVertex(0, 0) == false);
+  CHECK(graph.addVertex(-2, -2) == false);
+  CHECK(graph.addVertex(-1, -1) == true);
+  CHECK(graph.createEdge(-1, 0) == true);
+  CHECK(graph.shortestPath(-1, keys - 1, {}, result) == true);
+}
+
+TEST_CASE("Graph Store concurrent ingest - Benchmark") {
+  const int vertexCount = 100000;
+  auto ingest = [vertexCount](graph::GraphStoreLinked<int> &graph,
+                              unsigned threadCount) {
+    graph.beginIngest();
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < threadCount; t++) {
+      threads.emplace_back([&graph, t, threadCount, vertexCount]() {
+        int first = static_cast<int>(vertexCount * t / threadCount);
+        int last = static_cast<int>(vertexCount * (t + 1) / threadCount);
+        for (int j = first; j < last; j++) {
+          graph.addVertex(j, j);
+        }
+        for (int j = first + 1; j < last; j++) {
+          graph.createEdge(j - 1, j);
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    return graph.endIngest(threadCount);
+  };
+
+  BENCHMARK_ADVANCED("Add 100.000 vertices and edges with addVertex and "
+                     "createEdge")(Catch::Benchmark::Chronometer meter) {
+    std::vector<graph::GraphStoreLinked<int>> graphs(meter.runs());
+    meter.measure([&](int i) {
+      for (int j = 0; j < vertexCount; j++) {
+        graphs[i].addVertex(j, j);
+      }
+      for (int j = 1; j < vertexCount; j++) {
+        graphs[i].createEdge(j - 1, j);
+      }
+    });
+  };
+  for (unsigned threadCount : {1u, 2u, 4u, 8u}) {
+    BENCHMARK_ADVANCED("Add 100.000 vertices and edges with concurrent "
+                       "ingest on " +
+                       std::to_string(threadCount) + " threads")(
+        Catch::Benchmark::Chronometer meter) {
+      std::vector<graph::GraphStoreLinked<int>> graphs(meter.runs());
+      meter.measure([&](int i) { return ingest(graphs[i], threadCount); });
+    };
+  }
+}
+
+TEST_CASE("Graph Store load edge list and label files") {
+  std::string path =
+      (std::filesystem::temp_directory_path() / "graphStoreTest.edges")
+          .string();
+  auto write = [&path](const std::string &text) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << text;
+  };
+
+  int value = 0;
+  const char *text = " -42\t7";
+  const char *position = text;
+  CHECK(graph::EdgeListReader::parseInt(position, text + 6, value) == true);
+  CHECK(value == -42);
+  CHECK(graph::EdgeListReader::parseInt(position, text + 6, value) == true);
+  CHECK(value == 7);
+  CHECK(graph::EdgeListReader::parseInt(position, text + 6, value) == false);
+  for (const std::string number : {"2147483648", "-2147483649", "12a", "-",
+                                   "99999999999999"}) {
+    position = number.data();
+    CHECK(graph::EdgeListReader::parseInt(
+              position, number.data() + number.size(), value) == false);
+  }
+  std::string smallest = "-2147483648";
+  position = smallest.data();
+  CHECK(graph::EdgeListReader::parseInt(
+            position, smallest.data() + smallest.size(), value) == true);
+  CHECK(value == std::numeric_limits<int>::min());
+
+  // comments, empty lines, tabs, CRLF line ends, duplicates and broken lines,
+  // last line has no newline
+  std::string list = "# Directed graph\n% comment\n\n1 2\n2\t3\r\n  3 4\n"
+                     "1 2\nbroken\n4 x\n-5 1\n4 -5";
+  write(list);
+  graph::EdgeListReader reader(2, 64);
+  CHECK(reader.open(path) == true);
+  std::vector<std::vector<std::pair<int, int>>> parts;
+  std::vector<std::pair<int, int>> edges;
+  while (reader.nextEdges(parts)) {
+    CHECK(parts.size() == 2);
+    for (const auto &part : parts) {
+      edges.insert(edges.end(), part.begin(), part.end());
+    }
+  }
+  CHECK(edges == std::vector<std::pair<int, int>>{
+                     {1, 2}, {2, 3}, {3, 4}, {1, 2}, {-5, 1}, {4, -5}});
+  CHECK(reader.skippedLines() == 2);
+  CHECK(reader.bytesRead() == list.size());
+
+  graph::GraphStoreLinked<int> graph;
+  graph.addVertex(1, 100);
+  CHECK(graph.loadEdgeList(path, 7) == 5);
+  uint32_t index = 0;
+  CHECK(graph.snapshot().vertexCount() == 5);
+  CHECK(graph.snapshot().findIndex(-5, index) == true);
+  CHECK(index == 4);
+  CHECK(graph.shortestPath(1, -5) == true);
+  CHECK(graph.loadEdgeList(path) == 0);
+  CHECK(graph.loadEdgeList(path + ".missing") == 0);
+
+  write("1 a b\n# 2 c\n2\tc\r\n99 x\nx 1\n3\n4 a");
+  CHECK(graph.loadLabels(path) == 4);
+  CHECK(graph.shortestPath(1, 2, "c") == true);
+  CHECK(graph.shortestPath(1, 2, "a") == false);
+  CHECK(graph.shortestPath(2, 3, "c") == false);
+  CHECK(graph.shortestPath(3, 4, "a") == true);
+
+  // graph loaded in small chunks on many threads, with lines longer than
+  // chunk, is the same as graph built edge by edge
+  list.clear();
+  graph::GraphStoreLinked<int> expected;
+  for (int j = 0; j < 5000; j++) {
+    int start = j * 7919 % 1000;
+    int stop = (j * 4729 + j / 1000) % 1000 - 500;
+    list += std::to_string(start) + (j % 3 == 0 ? "\t" : " ") +
+            std::to_string(stop) + (j % 100 == 0 ? std::string(100, ' ') : "") +
+            "\n";
+    expected.addVertex(start, 0);
+    expected.addVertex(stop, 0);
+    expected.createEdge(start, stop);
+  }
+  write(list);
+  graph::GraphStoreLinked<int> loaded;
+  CHECK(loaded.loadEdgeList(path, 0, 4, 64) ==
+        expected.snapshot().edgeCount());
+  CHECK(loaded.snapshot().vertexCount() == expected.snapshot().vertexCount());
+  int mismatches = 0;
+  for (int j = 0; j < 200; j++) {
+    int start = j * 13 % 1000;
+    int stop = j * 31 % 1000 - 500;
+    if (loaded.shortestPath(start, stop) != expected.shortestPath(start, stop))
+      ++mismatches;
+  }
+  CHECK(mismatches == 0);
+  std::remove(path.c_str());
+}
+
+TEST_CASE("Graph Store load edge list file - Benchmark") {
+  std::string path =
+      (std::filesystem::temp_directory_path() / "graphStoreBenchmark.edges")
+          .string();
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << "# 20.000 vertices, 200.000 edges\n";
+    for (int j = 0; j < 200000; j++) {
+      out << j % 20000 << '\t' << (j % 20000 * 4729 + j / 20000) % 20000
+          << '\n';
+    }
+  }
+  std::string size =
+      std::to_string(std::filesystem::file_size(path) >> 10) + " KB";
+
+  BENCHMARK("Load edge list file of " + size +
+            " with std::ifstream and createEdge") {
+    graph::GraphStoreLinked<int> graph;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+      if (line.empty() || line[0] == '#')
+        continue;
+      std::istringstream fields(line);
+      int start = 0;
+      int stop = 0;
+      if (fields >> start >> stop) {
+        graph.addVertex(start, 0);
+        graph.addVertex(stop, 0);
+        graph.createEdge(start, stop);
+      }
+    }
+    return graph.snapshot().edgeCount();
+  };
+  for (unsigned threadCount : {1u, 4u}) {
+    BENCHMARK("Load edge list file of " + size + " with loadEdgeList on " +
+              std::to_string(threadCount) + " threads") {
+      graph::GraphStoreLinked<int> graph;
+      return graph.loadEdgeList(path, 0, threadCount);
+    };
+    BENCHMARK("Parse edge list file of " + size +
+              " with EdgeListReader on " + std::to_string(threadCount) +
+              " threads") {
+      graph::EdgeListReader reader(threadCount);
+      reader.open(path);
+      std::vector<std::vector<std::pair<int, int>>> parts;
+      size_t edges = 0;
+      while (reader.nextEdges(parts)) {
+        for (const auto &part : parts) {
+          edges += part.size();
+        }
+      }
+      return edges;
+    };
+  }
+  std::remove(path.c_str());
+}
+
+TEST_CASE("Graph Store mutation log and recovery") {
+  std::filesystem::path directory =
+      std::filesystem::temp_directory_path() / "graphStoreLogTest";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directory(directory);
+  std::string path = (directory / "graph.log").string();
+  auto sameGraph = [](graph::GraphStoreLinked<int> &a,
+                      graph::GraphStoreLinked<int> &b) {
+    if (a.snapshot().vertexCount() != b.snapshot().vertexCount() ||
+        a.snapshot().edgeCount() != b.snapshot().edgeCount())
+      return false;
+    graph::PathResult resultA;
+    graph::PathResult resultB;
+    for (int j = 0; j < 100; j++) {
+      for (const auto &label : {std::vector<std::string>{},
+                                std::vector<std::string>{"a"},
+                                std::vector<std::string>{"b"}}) {
+        a.shortestPath(j, (j * 37 + 11) % 100, label, resultA);
+        b.shortestPath(j, (j * 37 + 11) % 100, label, resultB);
+        if (resultA.distance != resultB.distance)
+          return false;
+      }
+    }
+    return true;
+  };
+
+  graph::GraphStoreLinked<int> graph;
+  CHECK(graph.commitLog() == false);
+  CHECK(graph.openLog(path) == true);
+  CHECK(graph.openLog(path) == false);
+  for (int j = 0; j < 100; j++) {
+    graph.addVertex(j, j * 2);
+    graph.addLabel(j, "a");
+  }
+  for (int j = 0; j < 99; j++) {
+    graph.createEdge(j, j + 1);
+  }
+  std::vector<std::pair<int, int>> edges{{0, 50}, {50, 99}, {0, 50}, {7, 1000}};
+  CHECK(graph.addEdges(edges) == 2);
+  graph.addLabel(10, "b", "c");
+  graph.removeLabel(50, "a");
+  // records are committed in groups, nothing is written until group is full
+  CHECK(std::filesystem::file_size(path) == 24);
+  CHECK(graph.commitLog() == true);
+  CHECK(std::filesystem::file_size(path) > 24);
+  graph.closeLog();
+
+  graph::GraphStoreLinked<int> recovered;
+  CHECK(recovered.openLog(path) == true);
+  CHECK(sameGraph(graph, recovered));
+  CHECK(recovered.shortestPath(0, 99, "a") == false);
+  CHECK(recovered.shortestPath(0, 10, "b") == false);
+  CHECK(recovered.save((directory / "graph.bin").string()) == true);
+  graph::MappedGraph<int> mapped;
+  CHECK(mapped.open((directory / "graph.bin").string()) == true);
+  int info = 0;
+  CHECK(mapped.info(42, info) == true);
+  CHECK(info == 84);
+
+  // checkpoint holds graph, log starts empty and only mutations after it are
+  // replayed
+  std::filesystem::copy_file(path, path + ".old");
+  CHECK(recovered.checkpointLog() == true);
+  CHECK(std::filesystem::file_size(path) == 24);
+  recovered.addVertex(200, 400);
+  recovered.createEdge(99, 200);
+  recovered.addLabel(200, "a");
+  recovered.removeEdge(97, 98);
+  recovered.removeVertex(60);
+  recovered.closeLog();
+  graph::GraphStoreLinked<int> fromCheckpoint;
+  CHECK(fromCheckpoint.openLog(path) == true);
+  CHECK(sameGraph(recovered, fromCheckpoint));
+  CHECK(fromCheckpoint.shortestPath(98, 200, "a") == true);
+  CHECK(fromCheckpoint.shortestPath(97, 200, "a") == false);
+  fromCheckpoint.closeLog();
+
+  // edges of ingest are logged one by one, replay keeps parallel edges
+  std::string ingestPath = (directory / "ingest.log").string();
+  graph::GraphStoreLinked<int> ingested;
+  CHECK(ingested.openLog(ingestPath) == true);
+  ingested.beginIngest();
+  for (int j = 0; j < 10; j++) {
+    ingested.addVertex(j, j);
+    ingested.createEdge(j - 1, j);
+    ingested.createEdge(j - 1, j);
+  }
+  CHECK(ingested.endIngest(1) == 18);
+  ingested.closeLog();
+  graph::GraphStoreLinked<int> ingestedReplay;
+  CHECK(ingestedReplay.openLog(ingestPath) == true);
+  CHECK(ingestedReplay.snapshot().edgeCount() == 18);
+  CHECK(sameGraph(ingested, ingestedReplay));
+  ingestedReplay.closeLog();
+
+  // checkpoint does not keep removed vertices and edges
+  std::string removedPath = (directory / "removed.log").string();
+  graph::GraphStoreLinked<int> removed;
+  CHECK(removed.openLog(removedPath) == true);
+  for (int j = 0; j < 10; j++) {
+    removed.addVertex(j, j);
+    removed.createEdge(j - 1, j);
+  }
+  removed.removeVertex(5);
+  removed.removeEdge(7, 8);
+  CHECK(removed.checkpointLog() == true);
+  removed.closeLog();
+  graph::GraphStoreLinked<int> withoutRemoved;
+  CHECK(withoutRemoved.openLog(removedPath) == true);
+  CHECK(withoutRemoved.snapshot().vertexCount() == 9);
+  CHECK(withoutRemoved.snapshot().edgeCount() == 6);
+  CHECK(withoutRemoved.shortestPath(0, 4) == true);
+  CHECK(withoutRemoved.shortestPath(4, 6) == false);
+  CHECK(withoutRemoved.shortestPath(7, 8) == false);
+  withoutRemoved.closeLog();
+
+  // log left by crash before log was restarted is older than checkpoint and
+  // is not replayed again
+  std::filesystem::copy_file(path, path + ".new");
+  std::filesystem::remove(path);
+  std::filesystem::copy_file(path + ".old", path);
+  graph::GraphStoreLinked<int> staleLog;
+  CHECK(staleLog.openLog(path) == true);
+  CHECK(sameGraph(graph, staleLog));
+  staleLog.closeLog();
+
+  // torn group at the end of log is cut off, new records follow valid ones
+  std::filesystem::remove(path);
+  std::filesystem::copy_file(path + ".new", path);
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::app);
+    out << "torn group of records";
+  }
+  graph::GraphStoreLinked<int> tornLog;
+  CHECK(tornLog.openLog(path) == true);
+  CHECK(sameGraph(recovered, tornLog));
+  tornLog.addVertex(300, 600);
+  tornLog.createEdge(200, 300);
+  tornLog.closeLog();
+  graph::GraphStoreLinked<int> afterTornLog;
+  CHECK(afterTornLog.openLog(path) == true);
+  CHECK(sameGraph(tornLog, afterTornLog));
+  CHECK(afterTornLog.shortestPath(0, 300) == true);
+  afterTornLog.closeLog();
+
+  // damaged checkpoint is rejected
+  {
+    std::fstream file(path + ".checkpoint",
+                      std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(40);
+    file.put('x');
+  }
+  graph::GraphStoreLinked<int> damaged;
+  CHECK(damaged.openLog(path) == false);
+
+  // each mutation is handed to flusher with group of 0 bytes, commitLog()
+  // waits until it is written, checkpoints are written when log grows past
+  // given size
+  std::string other = (directory / "other.log").string();
+  graph::GraphStoreLinked<std::string> names;
+  names.addVertex(1, "one");
+  names.setLogGroupBytes(0);
+  names.setCheckpointBytes(512);
+  CHECK(names.openLog(other) == true);
+  CHECK(std::filesystem::exists(other + ".checkpoint"));
+  names.addVertex(2, "two");
+  CHECK(names.commitLog() == true);
+  CHECK(std::filesystem::file_size(other) > 24);
+  for (int j = 3; j < 200; j++) {
+    names.addVertex(j, "vertex " + std::to_string(j));
+    names.createEdge(j - 1, j);
+  }
+  CHECK(std::filesystem::file_size(other) < 512);
+  names.closeLog();
+  graph::GraphStoreLinked<std::string> recoveredNames;
+  CHECK(recoveredNames.openLog(other) == true);
+  CHECK(recoveredNames.snapshot().vertexCount() == 199);
+  CHECK(recoveredNames.snapshot().edgeCount() == 197);
+  CHECK(recoveredNames.shortestPath(2, 199) == true);
+  recoveredNames.closeLog();
+  std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Graph Store mutation log - Benchmark") {
+  std::filesystem::path directory =
+      std::filesystem::temp_directory_path() / "graphStoreLogBenchmark";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directory(directory);
+  std::string path = (directory / "graph.log").string();
+  auto build = [&path](size_t groupBytes, bool logged) {
+    std::filesystem::remove(path);
+    graph::GraphStoreLinked<int> graph;
+    graph.setLogGroupBytes(groupBytes);
+    if (logged)
+      graph.openLog(path);
+    for (int j = 0; j < 100000; j++) {
+      graph.addVertex(j, j);
+    }
+    for (int j = 1; j < 100000; j++) {
+      graph.createEdge(j - 1, j);
+    }
+    graph.addLabel(0, "a");
+    return graph.commitLog();
+  };
+
+  BENCHMARK("Add 100.000 vertices and edges without mutation log") {
+    return build(0, false);
+  };
+  BENCHMARK("Add 100.000 vertices and edges with mutation log, groups of "
+            "1 MB") {
+    return build(size_t(1) << 20, true);
+  };
+  BENCHMARK("Add 100.000 vertices and edges with mutation log, groups of "
+            "64 KB") {
+    return build(size_t(1) << 16, true);
+  };
+  std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Graph Store remove vertices and edges - Benchmark") {
+  // graph of 20.000 vertices, each with 5 edges
+  auto build = [](graph::GraphStoreLinked<int> &graph) {
+    for (int j = 0; j < 20000; j++) {
+      graph.addVertex(j, j);
+    }
+    for (int j = 0; j < 20000; j++) {
+      for (int k = 1; k <= 5; k++) {
+        graph.createEdge(j, (j + 997 * k) % 20000);
+      }
+    }
+  };
+
+  BENCHMARK_ADVANCED("Remove 2.000 vertices and 2.000 edges from graph of "
+                     "20.000 vertices")(Catch::Benchmark::Chronometer meter) {
+    std::vector<graph::GraphStoreLinked<int>> graphs(meter.runs());
+    for (auto &g : graphs) {
+      build(g);
+    }
+    meter.measure([&](int i) {
+      size_t removed = 0;
+      for (int j = 0; j < 2000; j++) {
+        removed += graphs[i].removeVertex(j * 10);
+        removed += graphs[i].removeEdge(j * 10 + 1, (j * 10 + 998) % 20000);
+      }
+      return removed;
+    });
+  };
+
+  // searches skip removed vertices until compaction, then they do not see
+  // them at all
+  graph::GraphStoreLinked<int> graph;
+  graph.setCompactionThreshold(0);
+  build(graph);
+  for (int j = 0; j < 20000; j += 5) {
+    graph.removeVertex(j);
+  }
+  std::vector<std::string> label;
+  auto search = [&graph, &label]() {
+    int found = 0;
+    for (int j = 1; j < 100; j++) {
+      found += graph.shortestPath(j * 7 + 1, j * 191 + 3, label);
+    }
+    return found;
+  };
+  BENCHMARK("Find 100 shortest paths in graph of 20.000 vertices with 20% "
+            "removed vertices") {
+    return search();
+  };
+  graph.compact();
+  BENCHMARK("Find 100 shortest paths in graph of 20.000 vertices with 20% "
+            "removed vertices, after compaction") {
+    return search();
+  };
+
+  // automatic compaction runs in small steps, so no change waits for whole
+  // compaction
+  graph::GraphStoreLinked<int> stepped;
+  graph::GraphStoreLinked<int> whole;
+  build(stepped);
+  build(whole);
+  whole.setCompactionThreshold(0);
+  auto longest = std::chrono::nanoseconds(0);
+  for (int j = 0; j < 20000; j += 2) {
+    auto begin = std::chrono::steady_clock::now();
+    stepped.removeVertex(j);
+    longest = std::max(longest, std::chrono::steady_clock::now() - begin);
+    whole.removeVertex(j);
+  }
+  auto begin = std::chrono::steady_clock::now();
+  whole.compact();
+  auto compaction = std::chrono::steady_clock::now() - begin;
+  WARN("Longest removal with compaction in steps takes "
+       << std::chrono::duration_cast<std::chrono::microseconds>(longest)
+              .count()
+       << " us, compaction of whole graph takes "
+       << std::chrono::duration_cast<std::chrono::microseconds>(compaction)
+              .count()
+       << " us");
+}
+
+TEST_CASE("Graph Store memory resource of graph - Benchmark") {
+  BENCHMARK("Build and destroy graph of 100.000 vertices and edges with "
+            "GraphArena") {
+    graph::GraphStoreLinked<int> graph;
+    buildGraph(graph);
+  };
+
+  BENCHMARK("Build and destroy graph of 100.000 vertices and edges with "
+            "global allocator") {
+    graph::GraphStoreLinked<int, HeapResource> graph;
+    buildGraph(graph);
+  };
+
+  // memory of graph is counted as bytes and blocks taken from global
+  // allocator, each block also has bookkeeping overhead of allocator
+  CountingResource arenaMemory;
+  CountingResource heapMemory;
+  {
+    graph::GraphStoreLinked<int> arenaGraph(&arenaMemory);
+    graph::GraphStoreLinked<int, HeapResource> heapGraph(&heapMemory);
+    buildGraph(arenaGraph);
+    buildGraph(heapGraph);
+    WARN("Graph of 100.000 vertices and edges takes from global allocator "
+         << arenaMemory.bytes / 1024 << " kB in " << arenaMemory.blocks
+         << " blocks with GraphArena, " << heapMemory.bytes / 1024 << " kB in "
+         << heapMemory.blocks << " blocks without it");
+    CHECK(arenaMemory.blocks < heapMemory.blocks);
+  }
+  CHECK(arenaMemory.bytes == 0);
+  CHECK(heapMemory.bytes == 0);
+}
+
+TEST_CASE("Graph Store with injected memory resource") {
+  // graph takes all memory from buffer on stack until it is full
+  std::array<std::byte, 1 << 16> buffer;
+  std::pmr::monotonic_buffer_resource upstream(buffer.data(), buffer.size());
+  graph::GraphStoreLinked<std::string, std::pmr::unsynchronized_pool_resource>
+      graph(&upstream);
+  for (int j = 0; j < 100; j++) {
+    CHECK(graph.addVertex(j, std::to_string(j)) == true);
+    CHECK(graph.addLabel(j, "a") == true);
+  }
+  for (int j = 0; j + 1 < 100; j++) {
+    CHECK(graph.createEdge(j, j + 1) == true);
+  }
+  CHECK(graph.shortestPath(0, 99, "a") == true);
+  CHECK(graph.shortestPath(99, 0, "a") == false);
+
+  graph::GraphStoreLinked<std::string> arenaGraph(&upstream);
+  CHECK(arenaGraph.addVertex(1, "one") == true);
+  CHECK(arenaGraph.addVertex(2, "two") == true);
+  CHECK(arenaGraph.createEdge(1, 2) == true);
+  std::vector<std::string> label;
+  CHECK(arenaGraph.shortestPath(1, 2, label) == true);
+}
+
 TEST_CASE("Graph Store find shortest path") {
   graph::GraphStoreLinked<int> graph;
   for (int j = 0; j < 16; j++) {
@@ -200,6 +1038,157 @@ TEST_CASE("Graph Store find shortest path") {
   CHECK(graph.shortestPath(1, 25, "a") == false);
 }
 
+TEST_CASE("Graph Store shortest path result") {
+  graph::GraphStoreLinked<int> graph;
+  for (int j = 0; j < 10; j++) {
+    graph.addVertex(j, j);
+    graph.addLabel(j, "a");
+  }
+  graph.addLabel(9, "b");
+  for (int j = 0; j < 8; j++) {
+    graph.createEdge(j, j + 1);
+  }
+  graph.createEdge(0, 4);
+
+  graph::PathResult result;
+  CHECK(graph.shortestPath(0, 8, {"a"}, result) == true);
+  CHECK(result.found);
+  CHECK(result.distance == 5);
+  CHECK(result.path == std::vector<int>{0, 4, 5, 6, 7, 8});
+  std::ostringstream out;
+  out << result;
+  CHECK(out.str() == "0->4->5->6->7->8");
+
+  // result is reused, path keeps its storage
+  const int *storage = result.path.data();
+  CHECK(graph.shortestPath(2, 4, {"a"}, result,
+                           graph::SearchMode::Bidirectional) == true);
+  CHECK(result.distance == 2);
+  CHECK(result.path == std::vector<int>{2, 3, 4});
+  CHECK(result.path.data() == storage);
+
+  CHECK(graph.shortestPath(0, 9, {"a"}, result) == false);
+  CHECK_FALSE(result.found);
+  CHECK(result.path.empty());
+  CHECK(graph.shortestPath(0, 8, {"b"}, result) == false);
+  CHECK(graph.shortestPath(0, 25, {"a"}, result) == false);
+  out.str("");
+  out << result;
+  CHECK(out.str() == "no path");
+
+  graph.freeze();
+  CHECK(graph.shortestPath(0, 8, {"a"}, result) == true);
+  CHECK(result.distance == 5);
+  CHECK(result.path == std::vector<int>{0, 4, 5, 6, 7, 8});
+  CHECK(result.path.data() == storage);
+}
+
+TEST_CASE("Graph Store shortest path cache") {
+  graph::GraphStoreLinked<int> graph;
+  for (int j = 0; j < 10; j++) {
+    graph.addVertex(j, j);
+    graph.addLabel(j, "a");
+  }
+  for (int j = 0; j < 8; j++) {
+    graph.createEdge(j, j + 1);
+  }
+  graph.setPathCacheCapacity(4);
+
+  graph::PathResult result;
+  CHECK(graph.shortestPath(0, 8, {"a"}, result) == true);
+  CHECK(result.distance == 8);
+  CHECK(graph.shortestPath(0, 8, {"a"}, result) == true);
+  CHECK(result.path == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8});
+  CHECK(graph.pathCacheStats().hits == 1);
+  CHECK(graph.pathCacheStats().misses == 1);
+
+  // new edge makes cached result stale
+  uint64_t generation = graph.generation();
+  graph.createEdge(2, 6);
+  CHECK(graph.generation() > generation);
+  CHECK(graph.shortestPath(0, 8, {"a"}, result) == true);
+  CHECK(result.path == std::vector<int>{0, 1, 2, 6, 7, 8});
+  CHECK(graph.pathCacheStats().misses == 2);
+
+  // new vertex and label that search does not use keep result, label that it
+  // uses makes it stale
+  graph.addVertex(10, 10);
+  graph.addLabel(3, "b");
+  CHECK(graph.shortestPath(0, 8, {"a"}, result) == true);
+  CHECK(graph.pathCacheStats().hits == 2);
+  CHECK(graph.removeLabel(6, "a") == true);
+  CHECK(graph.shortestPath(0, 8, {"a"}, result) == false);
+  CHECK(graph.pathCacheStats().misses == 3);
+  CHECK(graph.shortestPath(0, 8, {"a"}, result) == false);
+  CHECK(graph.pathCacheStats().hits == 3);
+  graph.addLabel(6, "a");
+  CHECK(graph.shortestPath(0, 8, {"a"}, result) == true);
+  CHECK(result.distance == 5);
+
+  // labels in different order share entry, modes do not
+  CHECK(graph.shortestPath(0, 5, {"a", "b"}, result) == false);
+  CHECK(graph.shortestPath(0, 5, {"b", "a", "b"}, result) == false);
+  CHECK(graph.pathCacheStats().hits == 4);
+  CHECK(graph.shortestPath(0, 8, {"a"}, result,
+                           graph::SearchMode::Bidirectional) == true);
+  CHECK(graph.pathCacheStats().hits == 4);
+
+  // cache is full, entries that were hit are kept
+  CHECK(graph.pathCacheStats().size == 3);
+  graph.shortestPath(1, 8, {"a"}, result);
+  CHECK(graph.shortestPath(0, 8, {"a"}, result) == true);
+  graph.shortestPath(2, 8, {"a"}, result);
+  graph.shortestPath(3, 8, {"a"}, result);
+  CHECK(graph.pathCacheStats().size == 4);
+  uint64_t hits = graph.pathCacheStats().hits;
+  CHECK(graph.shortestPath(0, 8, {"a"}, result) == true);
+  CHECK(result.path == std::vector<int>{0, 1, 2, 6, 7, 8});
+  CHECK(graph.pathCacheStats().hits == hits + 1);
+
+  // cached results are the same as results of searches without cache
+  graph::GraphStoreLinked<int> uncached;
+  std::vector<std::pair<int, int>> vertices;
+  std::vector<std::pair<int, int>> edges;
+  for (int j = 0; j < 500; j++) {
+    vertices.emplace_back(j, j);
+  }
+  for (int j = 0; j < 1200; j++) {
+    edges.emplace_back(j * 7919 % 500, (j % 500 * 4729 + j / 500) % 500);
+  }
+  graph::GraphStoreLinked<int> cached;
+  for (auto *g : {&cached, &uncached}) {
+    g->addVertices(vertices);
+    g->addEdges(edges);
+    for (int j = 0; j < 500; j += 2) {
+      g->addLabel(j, "a");
+    }
+  }
+  cached.setPathCacheCapacity(64);
+  graph::PathResult expected;
+  bool same = true;
+  for (int j = 0; j < 2000; j++) {
+    int start = j * 13 % 40;
+    int stop = j * 31 % 40 + 100;
+    std::vector<std::string> label;
+    if (j % 3 == 0)
+      label.push_back("a");
+    cached.shortestPath(start, stop, label, result);
+    uncached.shortestPath(start, stop, label, expected);
+    if (result.found != expected.found || result.path != expected.path)
+      same = false;
+    if (j % 97 == 0) {
+      cached.createEdge(j % 500, j * 3 % 500);
+      uncached.createEdge(j % 500, j * 3 % 500);
+    }
+    if (j % 89 == 0) {
+      cached.addLabel(j * 7 % 500, "a");
+      uncached.addLabel(j * 7 % 500, "a");
+    }
+  }
+  CHECK(same);
+  CHECK(cached.pathCacheStats().hits > 100);
+}
+
 TEST_CASE("Graph Store search shortest path - Benchmark") {
   graph::GraphStoreLinked<int> graph;
   graph.disableOutputPrint();
@@ -246,4 +1235,1925 @@ TEST_CASE("Graph Store search shortest path - Benchmark") {
       graph.shortestPath(13, 5678, "a");
     }
   };
+
+  BENCHMARK("Find 100 shortest paths in graph of 100.000 vertices with "
+            "bidirectional search") {
+    for (int i = 0; i < 10; ++i) {
+      graph.shortestPath(1, 9981, graph::SearchMode::Bidirectional, "a");
+      graph.shortestPath(2, 97, graph::SearchMode::Bidirectional, "a");
+      graph.shortestPath(19, 33010, graph::SearchMode::Bidirectional, "a");
+      graph.shortestPath(11, 33010, graph::SearchMode::Bidirectional, "a");
+      graph.shortestPath(33, 73, graph::SearchMode::Bidirectional, "a");
+      graph.shortestPath(7, 66005, graph::SearchMode::Bidirectional, "a");
+      graph.shortestPath(5, 29, graph::SearchMode::Bidirectional, "a");
+      graph.shortestPath(37, 97, graph::SearchMode::Bidirectional, "a");
+      graph.shortestPath(295, 990, graph::SearchMode::Bidirectional, "a");
+      graph.shortestPath(13, 5678, graph::SearchMode::Bidirectional, "a");
+    }
+  };
+
+  std::vector<graph::PathQuery> queries;
+  for (int i = 0; i < 10; ++i) {
+    queries.push_back({1, 9981, {"a"}});
+    queries.push_back({2, 97, {"a"}});
+    queries.push_back({19, 33010, {"a"}});
+    queries.push_back({11, 33010, {"a"}});
+    queries.push_back({33, 73, {"a"}});
+    queries.push_back({7, 66005, {"a"}});
+    queries.push_back({5, 29, {"a"}});
+    queries.push_back({37, 97, {"a"}});
+    queries.push_back({295, 990, {"a"}});
+    queries.push_back({13, 5678, {"a"}});
+  }
+  std::vector<graph::PathResult> results;
+  graph.setBatchThreads(1);
+  BENCHMARK("Find 100 shortest paths in graph of 100.000 vertices in batch "
+            "on 1 thread") {
+    graph.shortestPathBatch(queries, results);
+  };
+
+  graph.setBatchThreads(4);
+  BENCHMARK("Find 100 shortest paths in graph of 100.000 vertices in batch "
+            "on 4 threads") {
+    graph.shortestPathBatch(queries, results);
+  };
+
+  // queries with different start vertices, that are not grouped
+  std::vector<graph::PathQuery> distinctQueries;
+  for (int i = 0; i < 100; ++i) {
+    distinctQueries.push_back({i * 997 % 100000, 33010, {"a"}});
+  }
+  BENCHMARK("Find 100 shortest paths from different vertices in batch on 4 "
+            "threads") {
+    graph.shortestPathBatch(distinctQueries, results);
+  };
+
+  graph.setPathCacheCapacity(64);
+  BENCHMARK("Find 100 shortest paths in graph of 100.000 vertices with path "
+            "cache") {
+    for (int i = 0; i < 10; ++i) {
+      graph.shortestPath(1, 9981, "a");
+      graph.shortestPath(2, 97, "a");
+      graph.shortestPath(19, 33010, "a");
+      graph.shortestPath(11, 33010, "a");
+      graph.shortestPath(33, 73, "a");
+      graph.shortestPath(7, 66005, "a");
+      graph.shortestPath(5, 29, "a");
+      graph.shortestPath(37, 97, "a");
+      graph.shortestPath(295, 990, "a");
+      graph.shortestPath(13, 5678, "a");
+    }
+  };
+  graph.setPathCacheCapacity(0);
+
+  graph.freeze();
+  BENCHMARK("Find 100 shortest paths in frozen graph of 100.000 vertices") {
+    for (int i = 0; i < 10; ++i) {
+      graph.shortestPath(1, 9981, "a");
+      graph.shortestPath(2, 97, "a");
+      graph.shortestPath(19, 33010, "a");
+      graph.shortestPath(11, 33010, "a");
+      graph.shortestPath(33, 73, "a");
+      graph.shortestPath(7, 66005, "a");
+      graph.shortestPath(5, 29, "a");
+      graph.shortestPath(37, 97, "a");
+      graph.shortestPath(295, 990, "a");
+      graph.shortestPath(13, 5678, "a");
+    }
+  };
+}
+
+TEST_CASE("Graph Store find shortest path when stop vertex is not reachable") {
+  graph::GraphStoreLinked<int> graph;
+  for (int j = 0; j < 6; j++) {
+    graph.addVertex(j, j);
+    graph.addLabel(j, "a");
+  }
+
+  // vertex 0 is reachable from 1, vertex 5 is not
+  CHECK(graph.createEdge(1, 0) == true);
+  CHECK(graph.createEdge(0, 2) == true);
+  CHECK(graph.createEdge(5, 4) == true);
+
+  CHECK(graph.shortestPath(1, 5, "a") == false);
+  CHECK(graph.shortestPath(1, 3, "a") == false);
+  CHECK(graph.shortestPath(1, 2, "a") == true);
+  CHECK(graph.shortestPath(1, 1, "a") == false);
+  CHECK(graph.shortestPath(3, 3, "a") == false);
+}
+
+TEST_CASE("Graph Store connected components") {
+  graph::GraphStoreLinked<int> graph;
+  for (int j = 0; j < 8; j++) {
+    graph.addVertex(j, j);
+    graph.addLabel(j, "a");
+  }
+  CHECK(graph.componentCount() == 8);
+
+  // components do not depend on direction of edges
+  graph.createEdge(1, 0);
+  graph.createEdge(2, 0);
+  graph.createEdge(3, 4);
+  CHECK(graph.componentCount() == 5);
+  CHECK(graph.connected(1, 2) == true);
+  CHECK(graph.connected(2, 1) == true);
+  CHECK(graph.connected(1, 3) == false);
+  CHECK(graph.connected(1, 8) == false);
+  CHECK(graph.shortestPath(1, 2, "a") == false);
+  CHECK(graph.shortestPath(1, 4, "a") == false);
+  CHECK(graph.shortestPath(3, 4, "a") == true);
+
+  // edge in the same component does not change components
+  graph.createEdge(0, 1);
+  CHECK(graph.componentCount() == 5);
+
+  // bulk edges unite components, duplicates and unknown vertices are skipped
+  graph.addEdges(std::vector<std::pair<int, int>>{
+      {0, 3}, {0, 3}, {5, 6}, {6, 9}});
+  CHECK(graph.componentCount() == 3);
+  CHECK(graph.connected(2, 4) == true);
+  CHECK(graph.connected(5, 6) == true);
+  CHECK(graph.connected(5, 7) == false);
+  CHECK(graph.shortestPath(1, 4, "a") == true);
+  CHECK(graph.shortestPath(5, 7, "a") == false);
+
+  // queries of batch in other components are not found
+  std::vector<graph::PathQuery> queries{{1, 4, {"a"}}, {1, 5, {"a"}},
+                                        {1, 7, {"a"}}, {5, 6, {"a"}}};
+  std::vector<graph::PathResult> results;
+  graph.shortestPathBatch(queries, results);
+  CHECK(results[0].found == true);
+  CHECK(results[1].found == false);
+  CHECK(results[2].found == false);
+  CHECK(results[3].found == true);
+
+  // new vertex is its own component
+  graph.addVertex(8, 8);
+  CHECK(graph.componentCount() == 4);
+  CHECK(graph.connected(8, 8) == true);
+  CHECK(graph.connected(8, 0) == false);
+}
+
+TEST_CASE("Graph Store remove vertices and edges") {
+  graph::GraphStoreLinked<int> graph;
+  graph.setCompactionThreshold(0);
+  for (int j = 0; j < 6; j++) {
+    graph.addVertex(j, j);
+    graph.addLabel(j, "a");
+  }
+  // path 0->1->2->3 and shorter path 0->4->3, edge 0->1 is added twice
+  graph.createEdge(0, 1);
+  graph.createEdge(0, 1);
+  graph.createEdge(1, 2);
+  graph.createEdge(2, 3);
+  graph.createEdge(0, 4);
+  graph.createEdge(4, 3);
+  graph.createEdge(3, 5);
+  graph::PathResult result;
+  CHECK(graph.shortestPath(0, 3, {"a"}, result) == true);
+  CHECK(result.path == std::vector<int>{0, 4, 3});
+
+  // removed vertex is skipped by searches and is not found by its key
+  CHECK(graph.removeVertex(4) == true);
+  CHECK(graph.removeVertex(4) == false);
+  CHECK(graph.removeVertex(9) == false);
+  CHECK(graph.shortestPath(0, 3, {"a"}, result) == true);
+  CHECK(result.path == std::vector<int>{0, 1, 2, 3});
+  CHECK(graph.shortestPath(0, 3, {"a"}, result,
+                           graph::SearchMode::Bidirectional) == true);
+  CHECK(result.path == std::vector<int>{0, 1, 2, 3});
+  CHECK(graph.shortestPath(0, 4, {"a"}, result) == false);
+  CHECK(graph.createEdge(0, 4) == false);
+  CHECK(graph.findVerticesWithLabel("a") == std::vector<int>{0, 1, 2, 3, 5});
+  CHECK(graph.findVerticesWithLabel(std::vector<std::string>{}) ==
+        std::vector<int>{0, 1, 2, 3, 5});
+  // components are split only by compaction
+  CHECK(graph.componentCount() == 1);
+  CHECK(graph.connected(0, 4) == false);
+
+  // edge is removed with its parallel edge
+  CHECK(graph.removeEdge(0, 1) == true);
+  CHECK(graph.removeEdge(0, 1) == false);
+  CHECK(graph.removeEdge(0, 9) == false);
+  CHECK(graph.shortestPath(0, 3, {"a"}, result) == false);
+  CHECK(graph.shortestPath(0, 3, {"a"}, result,
+                           graph::SearchMode::Bidirectional) == false);
+  graph::ShortestPathTree tree;
+  CHECK(graph.shortestPathTree(0, {"a"}, tree) == true);
+  CHECK(tree.size() == 1);
+  CHECK(graph.connected(0, 3) == true);
+  CHECK(graph.createEdge(0, 1) == true);
+  CHECK(graph.createEdge(0, 1) == true);
+
+  std::vector<graph::PathQuery> queries{
+      {0, 3, {"a"}}, {0, 5, {"a"}}, {0, 4, {"a"}}, {1, 5, {"a"}}};
+  std::vector<graph::PathResult> results;
+  graph.shortestPathBatch(queries, results);
+  CHECK(results[0].path == std::vector<int>{0, 1, 2, 3});
+  CHECK(results[1].path == std::vector<int>{0, 1, 2, 3, 5});
+  CHECK(results[2].found == false);
+  CHECK(results[3].path == std::vector<int>{1, 2, 3, 5});
+
+  // snapshot of frozen graph and published version do not have removed
+  // vertices and edges, removed vertex keeps its dense index. Version keeps
+  // parallel edge 0->1 once
+  graph.freeze();
+  CHECK(graph.snapshot().vertexCount() == 6);
+  CHECK(graph.snapshot().edgeCount() == 5);
+  CHECK(graph.shortestPath(0, 5, {"a"}, result) == true);
+  CHECK(result.path == std::vector<int>{0, 1, 2, 3, 5});
+  graph.publish();
+  CHECK(graph.pin()->edgeCount() == 4);
+  CHECK(graph.pin()->shortestPath(0, 3, {"a"}, result) == true);
+  CHECK(graph.pin()->shortestPath(0, 4, {"a"}, result) == false);
+  graph.thaw();
+
+  // compaction removes removed edges, edges of removed vertex and parallel
+  // edges, results of searches stay the same
+  uint64_t generation = graph.generation();
+  CHECK(graph.compact() == 10);
+  CHECK(graph.compact() == 0);
+  CHECK(graph.generation() == generation);
+  CHECK(graph.componentCount() == 1);
+  CHECK(graph.connected(0, 5) == true);
+  CHECK(graph.shortestPath(0, 5, {"a"}, result) == true);
+  CHECK(result.path == std::vector<int>{0, 1, 2, 3, 5});
+  CHECK(graph.shortestPath(0, 5, {"a"}, result,
+                           graph::SearchMode::Bidirectional) == true);
+  CHECK(result.path == std::vector<int>{0, 1, 2, 3, 5});
+
+  // key of removed vertex is inserted again, as new vertex
+  CHECK(graph.addVertex(4, 4) == true);
+  CHECK(graph.addLabel(4, "a") == true);
+  CHECK(graph.createEdge(0, 4) == true);
+  CHECK(graph.createEdge(4, 3) == true);
+  CHECK(graph.shortestPath(0, 3, {"a"}, result) == true);
+  CHECK(result.path == std::vector<int>{0, 4, 3});
+  CHECK(graph.componentCount() == 1);
+  CHECK(graph.connected(4, 5) == true);
+  graph.freeze();
+  CHECK(graph.snapshot().vertexCount() == 7);
+  CHECK(graph.shortestPath(0, 3, {"a"}, result) == true);
+  CHECK(result.path == std::vector<int>{0, 4, 3});
+
+  // graph file finds only the vertex that has the key now
+  std::string path =
+      (std::filesystem::temp_directory_path() / "graphStoreRemoved.graph")
+          .string();
+  CHECK(graph.save(path) == true);
+  graph::MappedGraph<int> mapped;
+  CHECK(mapped.open(path, true) == true);
+  CHECK(mapped.edgeCount() == 6);
+  CHECK(mapped.shortestPath(0, 3, {"a"}, result) == true);
+  CHECK(result.path == std::vector<int>{0, 4, 3});
+  mapped.close();
+  std::remove(path.c_str());
+
+  // removed vertex and removed edge split components when graph is compacted
+  graph::GraphStoreLinked<int> components;
+  components.setCompactionThreshold(0);
+  for (int j = 1; j <= 3; j++) {
+    components.addVertex(j, j);
+  }
+  components.createEdge(1, 2);
+  CHECK(components.componentCount() == 2);
+  CHECK(components.removeVertex(3) == true);
+  components.compact();
+  CHECK(components.componentCount() == 1);
+  CHECK(components.connected(1, 2) == true);
+  CHECK(components.removeEdge(1, 2) == true);
+  CHECK(components.connected(1, 2) == true);
+  components.compact();
+  CHECK(components.connected(1, 2) == false);
+  CHECK(components.componentCount() == 2);
+  graph::PathResult none;
+  CHECK(components.shortestPath(1, 2, {}, none) == false);
+  components.createEdge(2, 1);
+  CHECK(components.connected(1, 2) == true);
+  CHECK(components.componentCount() == 1);
+  CHECK(components.shortestPath(2, 1, {}, none) == true);
+}
+
+TEST_CASE("Graph Store compaction of removed vertices and edges") {
+  // vertices with even keys are removed, compaction starts on its own and
+  // runs a few vertices with each change
+  graph::GraphStoreLinked<int> graph;
+  for (int j = 0; j < 2000; j++) {
+    graph.addVertex(j, j);
+  }
+  for (int j = 0; j + 1 < 2000; j++) {
+    graph.createEdge(j, j + 1);
+    graph.createEdge(j + 1, j);
+  }
+  for (int j = 0; j < 2000; j += 2) {
+    CHECK(graph.removeVertex(j) == true);
+  }
+  for (int j = 0; j < 2000; j++) {
+    CHECK(graph.addVertex(j, j) == (j % 2 == 0));
+  }
+  std::vector<std::string> label;
+  CHECK(graph.shortestPath(1, 3, label) == false);
+  CHECK(graph.createEdge(1, 2) == true);
+  CHECK(graph.createEdge(2, 3) == true);
+  CHECK(graph.shortestPath(1, 3, label) == true);
+  graph.compact();
+  CHECK(graph.compact() == 0);
+  graph.freeze();
+  CHECK(graph.snapshot().vertexCount() == 3000);
+  CHECK(graph.snapshot().edgeCount() == 2);
+
+  // vectors of edges that shrink give memory back to memory resource
+  CountingResource memory;
+  graph::GraphStoreLinked<int, HeapResource> counted(&memory);
+  counted.setCompactionThreshold(0);
+  for (int j = 0; j < 100; j++) {
+    counted.addVertex(j, j);
+  }
+  for (int j = 0; j < 100; j++) {
+    for (int k = 1; k < 50; k++) {
+      counted.createEdge(j, (j + k) % 100);
+    }
+  }
+  for (int j = 0; j < 100; j++) {
+    for (int k = 1; k < 45; k++) {
+      CHECK(counted.removeEdge(j, (j + k) % 100) == true);
+    }
+  }
+  size_t bytes = memory.bytes;
+  CHECK(counted.compact() == 2 * 100 * 44);
+  CHECK(memory.bytes < bytes);
+  CHECK(counted.shortestPath(0, 45, label) == true);
+  CHECK(counted.shortestPath(0, 44, label) == true);
+
+  // components are built again in steps after compaction pass, old
+  // components are kept until all vertices are added. Edges created while
+  // components are built unite them in both
+  graph::GraphStoreLinked<int> chain;
+  chain.setCompactionThreshold(0);
+  for (int j = 0; j < 10000; j++) {
+    chain.addVertex(j, j);
+  }
+  for (int j = 0; j + 1 < 10000; j++) {
+    chain.createEdge(j, j + 1);
+  }
+  for (int j = 0; j + 2 < 10000; j += 2) {
+    chain.removeEdge(j, j + 1);
+  }
+  chain.setCompactionThreshold(0.25);
+  CHECK(chain.removeEdge(9998, 9999) == true);
+  int added = 0;
+  while (chain.componentCount() == 1 && added < 1000) {
+    CHECK(chain.connected(0, 9999) == true);
+    chain.createEdge(2 * added, 2 * added + 1);
+    ++added;
+  }
+  CHECK(added > 4);
+  CHECK(chain.componentCount() == size_t(5001 - added));
+  CHECK(chain.connected(0, 2 * added) == true);
+  CHECK(chain.connected(0, 2 * added + 1) == false);
+  chain.compact();
+  CHECK(chain.componentCount() == size_t(5001 - added));
+}
+
+TEST_CASE("Graph Store find shortest path in frozen graph") {
+  graph::GraphStoreLinked<int> graph;
+  for (int j = 0; j < 10; j++) {
+    graph.addVertex(j, j);
+  }
+  CHECK(graph.createEdge(1, 2) == true);
+  CHECK(graph.createEdge(2, 3) == true);
+  CHECK(graph.createEdge(3, 5) == true);
+  CHECK(graph.createEdge(2, 5) == true);
+  for (int j = 1; j < 6; j++) {
+    CHECK(graph.addLabel(j, "a") == true);
+  }
+
+  graph.freeze();
+  CHECK(graph.snapshot().vertexCount() == 10);
+  CHECK(graph.snapshot().edgeCount() == 4);
+  CHECK(graph.shortestPath(1, 5, "a") == true);
+  CHECK(graph.shortestPath(1, 5, "a", "b") == false);
+  CHECK(graph.shortestPath(1, 9, "a") == false);
+  CHECK(graph.shortestPath(1, 25, "a") == false);
+
+  // label changes are patched in snapshot
+  CHECK(graph.removeLabel(5, "a") == true);
+  CHECK(graph.shortestPath(1, 5, "a") == false);
+  CHECK(graph.addLabel(5, "a") == true);
+  CHECK(graph.shortestPath(1, 5, "a") == true);
+
+  // new edges and vertices rebuild snapshot before next search
+  CHECK(graph.addVertex(10, 10) == true);
+  CHECK(graph.addLabel(10, "a") == true);
+  CHECK(graph.createEdge(5, 10) == true);
+  CHECK(graph.shortestPath(1, 10, "a") == true);
+  CHECK(graph.snapshot().vertexCount() == 11);
+  CHECK(graph.snapshot().edgeCount() == 5);
+
+  graph.thaw();
+  CHECK(graph.shortestPath(1, 10, "a") == true);
+}
+
+TEST_CASE("Graph Store search frozen graph grown within one bitmap word") {
+  // 100 and 120 vertices take two words of bitmaps of breadth first search,
+  // so only parents of search show that snapshot has grown
+  graph::GraphStoreLinked<int> graph;
+  for (int j = 0; j < 100; j++) {
+    graph.addVertex(j, j);
+  }
+  for (int j = 0; j + 1 < 100; j++) {
+    graph.createEdge(j, j + 1);
+  }
+  graph.freeze();
+  graph::PathResult result;
+  CHECK(graph.shortestPath(0, 1, {}, result) == true);
+  CHECK(result.distance == 1);
+
+  for (int j = 100; j < 120; j++) {
+    graph.addVertex(j, j);
+    graph.createEdge(j - 1, j);
+  }
+  CHECK(graph.shortestPath(0, 119, {}, result) == true);
+  CHECK(graph.snapshot().vertexCount() == 120);
+  CHECK(result.distance == 119);
+  CHECK(result.path.back() == 119);
+}
+
+TEST_CASE("Graph Store direction optimizing BFS on power-law graph") {
+  graph::GraphStoreLinked<int> graph;
+  const int vertices = 20000;
+  for (int j = 0; j < vertices; j++) {
+    graph.addVertex(j, j);
+    graph.addLabel(j, "a");
+  }
+  // preferential attachment, each new vertex connects to endpoints of existing
+  // edges in both directions, so a few vertices get most of the edges
+  std::vector<int> endpoints = {0, 1};
+  graph.createEdge(0, 1);
+  graph.createEdge(1, 0);
+  uint32_t seed = 12345;
+  for (int j = 2; j < vertices; j++) {
+    for (int k = 0; k < 8; k++) {
+      seed = seed * 1103515245 + 12345;
+      int target = endpoints[(seed >> 8) % endpoints.size()];
+      graph.createEdge(j, target);
+      graph.createEdge(target, j);
+      endpoints.push_back(target);
+      endpoints.push_back(j);
+    }
+  }
+  graph.removeLabel(vertices - 1, "a");
+  // vertex without edges, that is never reached
+  graph.addVertex(vertices, vertices);
+  graph.addLabel(vertices, "a", "b");
+  for (int j = 0; j < vertices; j += 2) {
+    graph.addLabel(j, "b");
+  }
+
+  const auto &csr = graph.snapshot();
+  uint32_t start = 0;
+  uint32_t stop = 0;
+  REQUIRE(csr.findIndex(vertices / 2, start) == true);
+  REQUIRE(csr.findIndex(vertices - 2, stop) == true);
+
+  graph::LabelMask label = graph.compileLabels({"a"});
+  std::vector<int> pathTopDown;
+  std::vector<int> pathOptimized;
+  graph::DirectionOptimizingBfs<int> topDown(0);
+  graph::DirectionOptimizingBfs<int> optimized;
+  CHECK(topDown.search(csr, start, stop, label, pathTopDown) == true);
+  CHECK(optimized.search(csr, start, stop, label, pathOptimized) == true);
+  CHECK(pathTopDown == pathOptimized);
+
+  // stop vertex without label is rejected before search
+  REQUIRE(csr.findIndex(vertices - 1, stop) == true);
+  CHECK(optimized.search(csr, start, stop, label, pathOptimized) == false);
+  CHECK(optimized.lastEdgesExamined() == 0);
+
+  // stop vertex is not reachable, whole graph is searched
+  REQUIRE(csr.findIndex(vertices, stop) == true);
+  CHECK(topDown.search(csr, start, stop, label, pathTopDown) == false);
+  CHECK(optimized.search(csr, start, stop, label, pathOptimized) == false);
+  CHECK(topDown.lastBottomUpSteps() == 0);
+  CHECK(optimized.lastBottomUpSteps() > 0);
+  CHECK(optimized.lastEdgesExamined() < topDown.lastEdgesExamined());
+
+  // bottom-up steps check only vertices that have both labels
+  graph::LabelMask labels = graph.compileLabels({"a", "b"});
+  CHECK(topDown.search(csr, start, stop, labels, pathTopDown) == false);
+  CHECK(optimized.search(csr, start, stop, labels, pathOptimized) == false);
+  CHECK(optimized.lastBottomUpSteps() > 0);
+  for (int target = 2; target < vertices; target += 998) {
+    REQUIRE(csr.findIndex(target, stop) == true);
+    pathTopDown.clear();
+    pathOptimized.clear();
+    CHECK(topDown.search(csr, start, stop, labels, pathTopDown) ==
+          optimized.search(csr, start, stop, labels, pathOptimized));
+    CHECK(pathTopDown == pathOptimized);
+  }
+
+  graph.freeze();
+  CHECK(graph.shortestPath(vertices / 2, vertices - 2, "a") == true);
+  CHECK(graph.shortestPath(vertices / 2, vertices - 1, "a") == false);
+}
+
+TEST_CASE("Graph Store find shortest path with bidirectional search") {
+  graph::GraphStoreLinked<int> graph;
+  const auto mode = graph::SearchMode::Bidirectional;
+  for (int j = 0; j < 16; j++) {
+    graph.addVertex(j, j);
+  }
+
+  CHECK(graph.createEdge(1, 2) == true);
+  CHECK(graph.createEdge(2, 3) == true);
+  CHECK(graph.createEdge(3, 5) == true);
+  CHECK(graph.createEdge(2, 5) == true);
+  for (int j = 1; j < 6; j++) {
+    CHECK(graph.addLabel(j, "a") == true);
+  }
+
+  CHECK(graph.shortestPath(1, 15, mode, "a") == false);
+  CHECK(graph.shortestPath(1, 5, mode, "a") == true);
+  CHECK(graph.shortestPath(5, 1, mode, "a") == false);
+  CHECK(graph.shortestPath(1, 1, mode, "a") == false);
+
+  REQUIRE(graph.createEdge(1, 4) == true);
+  REQUIRE(graph.createEdge(4, 5) == true);
+  REQUIRE(graph.createEdge(5, 6) == true);
+  REQUIRE(graph.createEdge(6, 7) == true);
+  REQUIRE(graph.createEdge(7, 8) == true);
+  REQUIRE(graph.createEdge(4, 7) == true);
+  REQUIRE(graph.addLabel(6, "a") == true);
+  REQUIRE(graph.addLabel(8, "a") == true);
+
+  // vertex 7 is on every path from 1 to 8, and does not have label
+  CHECK(graph.shortestPath(1, 8, mode, "a") == false);
+  CHECK(graph.shortestPath(6, 8, mode, "a") == false);
+  REQUIRE(graph.addLabel(7, "a") == true);
+  CHECK(graph.shortestPath(1, 8, mode, "a") == true);
+
+  // start vertex does not need label, stop vertex does
+  CHECK(graph.shortestPath(0, 8, mode, "a") == false);
+  REQUIRE(graph.createEdge(0, 1) == true);
+  CHECK(graph.shortestPath(0, 8, mode, "a") == true);
+  CHECK(graph.shortestPath(8, 0, mode, "a") == false);
+  REQUIRE(graph.createEdge(8, 0) == true);
+  CHECK(graph.shortestPath(8, 0, mode, "a") == false);
+  CHECK(graph.shortestPath(8, 0, mode) == true);
+
+  // results do not depend on previous searches
+  CHECK(graph.shortestPath(1, 5, "a") == true);
+  CHECK(graph.shortestPath(1, 5, mode, "a") == true);
+  CHECK(graph.shortestPath(1, 5, mode, "a", "b") == false);
+}
+
+TEST_CASE("Graph Store concurrent shortest path searches") {
+  graph::GraphStoreLinked<int> graph;
+  std::vector<std::pair<int, int>> vertices;
+  std::vector<std::pair<int, int>> edges;
+  for (int j = 0; j < 5000; j++) {
+    vertices.emplace_back(j, j);
+  }
+  for (int j = 0; j < 20000; j++) {
+    edges.emplace_back(j * 7919 % 5000, (j % 5000 * 4729 + j / 5000) % 5000);
+  }
+  graph.addVertices(vertices);
+  graph.addEdges(edges);
+  for (int j = 0; j < 5000; j++) {
+    if (j % 7 != 0)
+      graph.addLabel(j, "a");
+  }
+
+  // expected paths are found on this thread, with its own context
+  const std::vector<std::string> label = {"a"};
+  const std::array<graph::SearchMode, 2> modes = {
+      graph::SearchMode::Forward, graph::SearchMode::Bidirectional};
+  std::vector<std::vector<int>> expected;
+  graph::QueryContext<int> context;
+  for (int j = 0; j < 200; j++) {
+    graph.shortestPath(j * 13 % 5000, j * 31 % 5000 + 1, label, context,
+                       modes[j % 2]);
+    expected.push_back(context.path());
+  }
+  CHECK(std::count_if(expected.begin(), expected.end(),
+                      [](const auto &path) { return !path.empty(); }) > 100);
+
+  // searches on many threads find the same paths, from their own contexts
+  // and from context of each thread
+  auto searchAll = [&](bool frozen) {
+    std::vector<int> mismatches(4, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+      threads.emplace_back([&, t]() {
+        graph::QueryContext<int> threadContext;
+        for (int round = 0; round < 3; round++) {
+          for (int j = 0; j < 200; j++) {
+            auto mode = frozen ? graph::SearchMode::Forward : modes[j % 2];
+            bool found = graph.shortestPath(j * 13 % 5000, j * 31 % 5000 + 1,
+                                            label, threadContext, mode);
+            if (found != !expected[j].empty() ||
+                (!frozen && threadContext.path() != expected[j]))
+              ++mismatches[t];
+            if (graph.shortestPath(j * 13 % 5000, j * 31 % 5000 + 1, label,
+                                   mode) != found)
+              ++mismatches[t];
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    return mismatches;
+  };
+  CHECK(searchAll(false) == std::vector<int>(4, 0));
+
+  // threads share path cache, results are the same
+  graph.setPathCacheCapacity(100);
+  CHECK(searchAll(false) == std::vector<int>(4, 0));
+  CHECK(graph.pathCacheStats().hits > 0);
+  graph.setPathCacheCapacity(0);
+
+  // graph is changed after it is frozen, the first search rebuilds snapshot
+  graph.freeze();
+  graph.addVertex(5000, 5000);
+  CHECK(searchAll(true) == std::vector<int>(4, 0));
+  CHECK(graph.snapshot().vertexCount() == 5001);
+}
+
+TEST_CASE("Graph Store published versions") {
+  graph::GraphStoreLinked<int> graph;
+  auto empty = graph.pin();
+  CHECK(empty->vertexCount() == 0);
+  graph::PathResult result;
+  CHECK(empty->shortestPath(0, 1, {}, result) == false);
+
+  for (int j = 0; j < 6; j++) {
+    graph.addVertex(j, j);
+    graph.addLabel(j, "a");
+  }
+  graph.createEdge(0, 1);
+  graph.createEdge(1, 2);
+  graph.createEdge(2, 3);
+
+  // changes are not seen until version is published
+  CHECK(graph.pin() == empty);
+  graph.publish();
+  auto first = graph.pin();
+  CHECK(first->generation() == graph.generation());
+  CHECK(first->vertexCount() == 6);
+  CHECK(first->edgeCount() == 3);
+  CHECK(first->shortestPath(0, 3, {"a"}, result) == true);
+  CHECK(result.path == std::vector<int>{0, 1, 2, 3});
+  CHECK(first->shortestPath(0, 4, {"a"}, result) == false);
+
+  // nothing is built if graph was not changed
+  graph.publish();
+  CHECK(graph.pin() == first);
+
+  // pinned version keeps its edges and labels while graph is changed
+  graph.createEdge(0, 3);
+  graph.createEdge(3, 4);
+  graph.removeLabel(3, "a");
+  graph.addLabel(4, "b");
+  graph.addVertex(6, 6);
+  graph.publish();
+  auto second = graph.pin();
+  CHECK(first->shortestPath(0, 3, {"a"}, result) == true);
+  CHECK(result.distance == 3);
+  CHECK(first->shortestPath(0, 4, {}, result) == false);
+  CHECK(first->shortestPath(0, 4, {"b"}, result) == false);
+  CHECK(first->contains(6) == false);
+  CHECK(second->shortestPath(0, 3, {"a"}, result) == false);
+  CHECK(second->shortestPath(0, 3, {}, result) == true);
+  CHECK(result.path == std::vector<int>{0, 3});
+  CHECK(second->shortestPath(3, 4, {"b"}, result) == true);
+  CHECK(second->contains(6) == true);
+  CHECK(second->shortestPath(0, 6, {}, result) == false);
+
+  // old version is freed when the last reader releases it
+  std::weak_ptr<const graph::GraphVersion<int>> released = first;
+  first = nullptr;
+  CHECK(released.expired());
+
+  // versions are published on their own after every 3 changes
+  graph.setPublishInterval(3);
+  graph.createEdge(4, 5);
+  graph.createEdge(5, 6);
+  CHECK(graph.pin() == second);
+  graph.addLabel(5, "b");
+  CHECK(graph.pin() != second);
+  CHECK(graph.pin()->shortestPath(0, 6, {}, result) == true);
+  CHECK(result.distance == 4);
+}
+
+TEST_CASE("Graph Store versions published after each change") {
+  // versions build only changed chunks of 64 vertices again, searches of each
+  // version find the same paths as searches of graph, with vertices and edges
+  // added and removed and compaction passes that build all chunks
+  graph::GraphStoreLinked<int> graph;
+  graph.setCompactionThreshold(0.5);
+  const int vertices = 2000;
+  for (int j = 0; j < vertices; j++) {
+    graph.addVertex(j, j);
+    if (j % 3 != 0)
+      graph.addLabel(j, "a");
+  }
+  graph.setPublishInterval(1);
+
+  auto queries = [](int step) {
+    std::vector<std::pair<int, int>> pairs;
+    for (int q = 0; q < 8; q++) {
+      pairs.emplace_back((step * 37 + q * 101) % vertices,
+                         (step * 53 + q * 211 + 7) % vertices);
+    }
+    return pairs;
+  };
+  std::shared_ptr<const graph::GraphVersion<int>> pinned;
+  std::vector<int> pinnedDistances;
+  int mismatches = 0;
+  graph::PathResult expected;
+  graph::PathResult result;
+  for (int step = 0; step < 8000; step++) {
+    int a = step * 7919 % vertices;
+    int b = (step * 4729 + step / vertices) % vertices;
+    switch (step % 8) {
+    case 3:
+      graph.removeEdge(a, b);
+      break;
+    case 4:
+      graph.addLabel(a, "a");
+      break;
+    case 5:
+      graph.removeLabel(b, "a");
+      break;
+    case 6:
+      if (!graph.removeVertex(a))
+        graph.addVertex(a, a);
+      break;
+    default:
+      graph.createEdge(a, b);
+    }
+    auto version = graph.pin();
+    CHECK(version->generation() == graph.generation());
+    if (step % 4 != 0)
+      continue;
+    for (const auto &[start, stop] : queries(step)) {
+      for (const auto &label : {std::vector<std::string>{},
+                                std::vector<std::string>{"a"}}) {
+        bool found = graph.shortestPath(start, stop, label, expected);
+        if (version->shortestPath(start, stop, label, result) != found ||
+            (found && result.distance != expected.distance))
+          ++mismatches;
+      }
+    }
+    // pinned version keeps its paths while later versions are published
+    if (step == 1600) {
+      pinned = version;
+      for (const auto &[start, stop] : queries(0)) {
+        pinned->shortestPath(start, stop, {}, result);
+        pinnedDistances.push_back(result.found ? result.distance : -1);
+      }
+    }
+  }
+  CHECK(mismatches == 0);
+  std::vector<int> distances;
+  for (const auto &[start, stop] : queries(0)) {
+    pinned->shortestPath(start, stop, {}, result);
+    distances.push_back(result.found ? result.distance : -1);
+  }
+  CHECK(distances == pinnedDistances);
+}
+
+TEST_CASE("Graph Store readers of published versions while graph is changed") {
+  graph::GraphStoreLinked<int> graph;
+  graph.setPublishInterval(64);
+  const int vertices = 20000;
+  std::atomic<bool> done{false};
+
+  // writer builds chain 0 -> 1 -> ... and adds label to each vertex, readers
+  // check that each pinned version is consistent, vertex before the last one
+  // already has its edge and label
+  std::vector<int> mismatches(4, 0);
+  std::vector<size_t> searches(4, 0);
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; t++) {
+    readers.emplace_back([&, t]() {
+      graph::PathResult result;
+      uint64_t generation = 0;
+      while (!done) {
+        auto version = graph.pin();
+        if (version->generation() < generation)
+          ++mismatches[t];
+        generation = version->generation();
+        int count = static_cast<int>(version->vertexCount());
+        if (count < 3)
+          continue;
+        int stop = count - 2;
+        int start = stop * (t + 1) / 5;
+        if (!version->shortestPath(start, stop, {"a"}, result) ||
+            result.distance != stop - start)
+          ++mismatches[t];
+        if (version->shortestPath(stop, start, {}, result))
+          ++mismatches[t];
+        ++searches[t];
+      }
+    });
+  }
+  graph.addVertex(0, 0);
+  for (int j = 1; j < vertices; j++) {
+    graph.addVertex(j, j);
+    graph.createEdge(j - 1, j);
+    graph.addLabel(j, "a");
+  }
+  graph.publish();
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  CHECK(mismatches == std::vector<int>(4, 0));
+  CHECK(graph.pin()->vertexCount() == vertices);
+  graph::PathResult result;
+  CHECK(graph.pin()->shortestPath(0, vertices - 1, {"a"}, result) == true);
+  CHECK(result.distance == vertices - 1);
+}
+
+TEST_CASE("Graph Store readers of published versions - Benchmark") {
+  graph::GraphStoreLinked<int> graph;
+  std::vector<std::pair<int, int>> vertices;
+  std::vector<std::pair<int, int>> edges;
+  for (int j = 0; j < 10000; j++) {
+    vertices.emplace_back(j, j);
+  }
+  for (int j = 0; j < 40000; j++) {
+    edges.emplace_back(j * 7919 % 10000,
+                       (j % 10000 * 4729 + j / 10000) % 10000);
+  }
+  graph.addVertices(vertices);
+  graph.addEdges(edges);
+  graph.publish();
+  graph.setPublishInterval(4096);
+
+  auto search = [&graph]() {
+    graph::PathResult result;
+    auto version = graph.pin();
+    for (int j = 0; j < 100; j++) {
+      version->shortestPath(j * 13 % 10000, j * 31 % 10000 + 1, {}, result);
+    }
+  };
+  BENCHMARK("Find 100 shortest paths in published version of 10.000 "
+            "vertices") {
+    search();
+  };
+
+  // writer adds vertices with edges to graph, and publishes new versions,
+  // while reader searches. New vertices are not reached from old ones, so
+  // searches do the same work
+  std::atomic<bool> done{false};
+  std::thread writer([&graph, &done]() {
+    for (int j = 10000; !done; j++) {
+      graph.addVertex(j, j);
+      graph.createEdge(j, j * 7 % 10000);
+    }
+  });
+  BENCHMARK("Find 100 shortest paths in published version of 10.000 "
+            "vertices while graph is changed") {
+    search();
+  };
+  done = true;
+  writer.join();
+
+  // each edge publishes new version, that builds only chunks of vertices of
+  // edge and shares all other chunks
+  graph.setPublishInterval(1);
+  done = false;
+  std::atomic<int> created{0};
+  std::thread publishingWriter([&graph, &done, &created]() {
+    for (int j = 0; !done; j++) {
+      graph.createEdge(j * 7 % 10000, j * 13 % 10000 + 1);
+      ++created;
+    }
+  });
+  auto begin = std::chrono::steady_clock::now();
+  BENCHMARK("Find 100 shortest paths in published version of 10.000 "
+            "vertices while version is published after each edge") {
+    search();
+  };
+  done = true;
+  publishingWriter.join();
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - begin)
+                       .count();
+  WARN("Edges created with version published after each edge: "
+       << created << ", " << static_cast<int>(created / seconds)
+       << " per second");
+}
+
+TEST_CASE("Graph Store save graph file and open it mapped") {
+  std::string path =
+      (std::filesystem::temp_directory_path() / "graphStoreTest.graph")
+          .string();
+  graph::GraphStoreLinked<int> graph;
+  for (int j = 0; j < 2000; j++) {
+    graph.addVertex(j * 3 - 100, j);
+    if (j % 4 != 0)
+      graph.addLabel(j * 3 - 100, "a");
+  }
+  for (int j = 0; j < 8000; j++) {
+    graph.createEdge((j * 7919 % 2000) * 3 - 100,
+                     ((j * 4729 + j / 2000) % 2000) * 3 - 100);
+  }
+  // labels with id >= 64 are written as overflow pairs
+  for (int l = 0; l < 70; l++) {
+    graph.addLabel((l % 5) * 3 - 100, "label" + std::to_string(l));
+  }
+  graph.addVertex(100000, -1);
+  CHECK(graph.save(path) == true);
+
+  graph::MappedGraph<int> mapped;
+  CHECK(mapped.isOpen() == false);
+  CHECK(mapped.open(path, true) == true);
+  CHECK(mapped.isOpen() == true);
+  CHECK(mapped.vertexCount() == 2001);
+  CHECK(mapped.edgeCount() == graph.snapshot().edgeCount());
+  CHECK(mapped.labelDictionary().size() == 71);
+  CHECK(mapped.contains(-100) == true);
+  CHECK(mapped.contains(-99) == false);
+  int info = 0;
+  CHECK(mapped.info(5897, info) == true);
+  CHECK(info == 1999);
+  CHECK(mapped.info(100000, info) == true);
+  CHECK(info == -1);
+
+  // paths are the same as paths of frozen graph
+  graph.freeze();
+  graph::PathResult expected;
+  graph::PathResult result;
+  int mismatches = 0;
+  for (int j = 0; j < 300; j++) {
+    int start = (j * 13 % 2000) * 3 - 100;
+    int stop = (j * 31 % 2000) * 3 - 100;
+    for (const auto &label : {std::vector<std::string>{},
+                              std::vector<std::string>{"a"}}) {
+      bool found = graph.shortestPath(start, stop, label, expected);
+      if (mapped.shortestPath(start, stop, label, result) != found ||
+          result.path != expected.path)
+        ++mismatches;
+    }
+  }
+  CHECK(mismatches == 0);
+  CHECK(mapped.shortestPath(-100, 100000, {}, result) == false);
+  CHECK(mapped.shortestPath(-100, -99, {}, result) == false);
+  CHECK(mapped.shortestPath(-100, -88, {"label4"}, result) ==
+        graph.shortestPath(-100, -88, {"label4"}, expected));
+  CHECK(mapped.shortestPath(-100, -88, {"label69"}, result) ==
+        graph.shortestPath(-100, -88, {"label69"}, expected));
+  CHECK(result.path == expected.path);
+
+  // graph of data that is not trivially copyable is saved without data
+  graph::GraphStoreLinked<std::string> names;
+  names.addVertex(1, "one");
+  names.addVertex(2, "two");
+  names.createEdge(1, 2);
+  CHECK(names.save(path) == true);
+  graph::MappedGraph<std::string> mappedNames;
+  CHECK(mappedNames.open(path, true) == true);
+  std::string name;
+  CHECK(mappedNames.info(1, name) == false);
+  CHECK(mappedNames.shortestPath(1, 2, {}, result) == true);
+  CHECK(result.path == std::vector<int>{1, 2});
+  graph::MappedGraph<double> wrongData;
+  CHECK(wrongData.open(path) == true);
+
+  // damaged files are rejected, data is checked only if asked
+  CHECK(graph.save(path) == true);
+  std::vector<char> bytes;
+  {
+    std::ifstream in(path, std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(in),
+                 std::istreambuf_iterator<char>());
+  }
+  auto write = [&path](const std::vector<char> &data) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+  };
+  CHECK(wrongData.open(path) == false);
+  std::vector<char> damaged = bytes;
+  damaged[damaged.size() / 2] ^= 1;
+  write(damaged);
+  CHECK(mapped.open(path) == true);
+  CHECK(mapped.open(path, true) == false);
+  CHECK(mapped.isOpen() == false);
+  damaged = bytes;
+  damaged[20] ^= 1;
+  write(damaged);
+  CHECK(mapped.open(path) == false);
+  damaged = bytes;
+  damaged.resize(damaged.size() - 64);
+  write(damaged);
+  CHECK(mapped.open(path) == false);
+  damaged.resize(16);
+  write(damaged);
+  CHECK(mapped.open(path) == false);
+  write(bytes);
+  CHECK(mapped.open(path, true) == true);
+  std::remove(path.c_str());
+  // mapping stays valid after file is removed
+  CHECK(mapped.shortestPath(-100, -88, {"label69"}, result) ==
+        graph.shortestPath(-100, -88, {"label69"}, expected));
+  CHECK(result.path == expected.path);
+  CHECK(mapped.open(path) == false);
+}
+
+TEST_CASE("Graph Store open graph file - Benchmark") {
+  std::string path =
+      (std::filesystem::temp_directory_path() / "graphStoreBenchmark.graph")
+          .string();
+  std::vector<std::pair<int, int>> vertices;
+  std::vector<std::pair<int, int>> edges;
+  for (int j = 0; j < 200000; j++) {
+    vertices.emplace_back(j, j);
+  }
+  for (int j = 0; j < 800000; j++) {
+    edges.emplace_back(j % 200000 * 7919 % 200000,
+                       (j % 200000 * 4729 + j / 200000) % 200000);
+  }
+  {
+    graph::GraphStoreLinked<int> graph;
+    graph.addVertices(vertices);
+    graph.addEdges(edges);
+    graph.save(path);
+  }
+
+  BENCHMARK("Build frozen graph of 200.000 vertices and 800.000 edges") {
+    graph::GraphStoreLinked<int> graph;
+    graph.addVertices(vertices);
+    graph.addEdges(edges);
+    graph.freeze();
+    return graph.snapshot().edgeCount();
+  };
+  BENCHMARK("Open graph file of 200.000 vertices and 800.000 edges") {
+    graph::MappedGraph<int> mapped;
+    mapped.open(path);
+    return mapped.edgeCount();
+  };
+  BENCHMARK("Open graph file of 200.000 vertices and 800.000 edges, with "
+            "checksum") {
+    graph::MappedGraph<int> mapped;
+    mapped.open(path, true);
+    return mapped.edgeCount();
+  };
+  graph::MappedGraph<int> mapped;
+  mapped.open(path);
+  BENCHMARK("Find 10 shortest paths in graph file of 200.000 vertices") {
+    graph::PathResult result;
+    for (int j = 0; j < 10; j++) {
+      mapped.shortestPath(j * 13, j * 31 + 1, {}, result);
+    }
+  };
+  std::remove(path.c_str());
+}
+
+TEST_CASE("Graph Store shortest path batch") {
+  graph::GraphStoreLinked<int> graph;
+  std::vector<std::pair<int, int>> vertices;
+  std::vector<std::pair<int, int>> edges;
+  for (int j = 0; j < 3000; j++) {
+    vertices.emplace_back(j, j);
+  }
+  for (int j = 0; j < 9000; j++) {
+    edges.emplace_back(j * 7919 % 3000, (j % 3000 * 4729 + j / 3000) % 3000);
+  }
+  graph.addVertices(vertices);
+  graph.addEdges(edges);
+  for (int j = 0; j < 3000; j++) {
+    if (j % 5 != 0)
+      graph.addLabel(j, "a");
+    if (j % 3 != 0)
+      graph.addLabel(j, "b");
+  }
+
+  // queries share few start vertices, labels are given in different orders,
+  // some keys are not in graph and some queries start at stop vertex
+  const std::array<std::vector<std::string>, 4> labels = {
+      std::vector<std::string>{"a"}, std::vector<std::string>{"a", "b"},
+      std::vector<std::string>{"b", "a", "b"}, std::vector<std::string>{}};
+  std::vector<graph::PathQuery> queries;
+  for (int j = 0; j < 400; j++) {
+    graph::PathQuery query{j % 7 * 101, j * 37 % 3000, labels[j % 4],
+                           graph::SearchMode::Forward};
+    if (j % 10 == 9)
+      query.mode = graph::SearchMode::Bidirectional;
+    if (j % 50 == 7)
+      query.stop = 5000;
+    if (j % 50 == 8)
+      query.stop = query.start;
+    queries.push_back(query);
+  }
+
+  auto checkBatch = [&]() {
+    std::vector<graph::PathResult> results;
+    graph.shortestPathBatch(queries, results);
+    REQUIRE(results.size() == queries.size());
+    graph::QueryContext<int> context;
+    size_t found = 0;
+    bool same = true;
+    for (size_t i = 0; i < queries.size(); i++) {
+      const auto &q = queries[i];
+      bool expected =
+          graph.shortestPath(q.start, q.stop, q.label, context, q.mode);
+      std::vector<int> path(context.path().begin(), context.path().end());
+      if (expected)
+        path.push_back(q.stop);
+      if (results[i].found != expected || results[i].path != path)
+        same = false;
+      found += expected ? 1 : 0;
+    }
+    CHECK(same);
+    CHECK(found > 100);
+  };
+
+  graph.setBatchThreads(1);
+  checkBatch();
+  graph.setBatchThreads(4);
+  checkBatch();
+  checkBatch();
+  graph.freeze();
+  checkBatch();
+
+  std::vector<graph::PathResult> results(3);
+  graph.shortestPathBatch({}, results);
+  CHECK(results.empty());
+}
+
+/**
+ * Inserts grid of width x height vertices, like road network, each vertex
+ * with edges to its neighbors in both directions. Key of vertex is
+ * row * width + column
+ */
+static void buildGrid(graph::GraphStoreLinked<int> &graph, int width,
+                      int height) {
+  for (int j = 0; j < width * height; j++) {
+    graph.addVertex(j, j);
+  }
+  std::vector<std::pair<int, int>> edges;
+  for (int row = 0; row < height; row++) {
+    for (int column = 0; column < width; column++) {
+      int key = row * width + column;
+      if (column + 1 < width) {
+        edges.emplace_back(key, key + 1);
+        edges.emplace_back(key + 1, key);
+      }
+      if (row + 1 < height) {
+        edges.emplace_back(key, key + width);
+        edges.emplace_back(key + width, key);
+      }
+    }
+  }
+  graph.addEdges(edges);
+}
+
+TEST_CASE("Graph Store landmark A* search") {
+  graph::GraphStoreLinked<int> graph;
+  buildGrid(graph, 30, 30);
+  for (int j = 0; j < 900; j++) {
+    // wall in column 15 with a gap in the last row
+    if (j % 30 != 15 || j / 30 == 29)
+      graph.addLabel(j, "a");
+  }
+  graph::PathResult forward;
+  graph::PathResult landmarks;
+  graph::QueryContext<int> context;
+  auto compare = [&](int start, int stop,
+                     const std::vector<std::string> &label) {
+    bool found = graph.shortestPath(start, stop, label, forward);
+    CHECK(graph.shortestPath(start, stop, label, landmarks,
+                             graph::SearchMode::Landmarks) == found);
+    CHECK(landmarks.distance == forward.distance);
+    if (found) {
+      CHECK(landmarks.path.front() == start);
+      CHECK(landmarks.path.back() == stop);
+    }
+  };
+
+  // without landmarks search runs as Forward search
+  CHECK(graph.landmarkCount() == 0);
+  compare(0, 899, {});
+  graph.buildLandmarks(4);
+  CHECK(graph.landmarkCount() == 4);
+  for (int j = 0; j < 60; j++) {
+    compare(j * 37 % 900, j * 211 % 900, {});
+    compare(j * 37 % 900, j * 211 % 900, {"a"});
+  }
+
+  // landmark search visits fewer vertices than Dijkstra search
+  CHECK(graph.shortestPath(0, 899, {}, context) == true);
+  size_t visited = context.visited();
+  CHECK(graph.shortestPath(0, 899, {}, context,
+                           graph::SearchMode::Landmarks) == true);
+  CHECK(context.visited() < visited / 2);
+
+  // new edges shorten distances of landmarks, one by one and in bulk
+  CHECK(graph.createEdge(0, 899) == true);
+  compare(0, 899, {});
+  compare(1, 898, {});
+  graph.addEdges(std::vector<std::pair<int, int>>{{30, 869}, {869, 30}});
+  compare(31, 868, {});
+  compare(868, 31, {});
+  std::vector<std::pair<int, int>> bulk;
+  for (int j = 0; j < 200; j++) {
+    bulk.emplace_back(j * 7 % 900, j * 13 % 900);
+  }
+  graph.addEdges(bulk);
+  for (int j = 0; j < 60; j++) {
+    compare(j * 37 % 900, j * 211 % 900, {});
+  }
+
+  // removed edges and vertices keep distances as lower bounds
+  CHECK(graph.removeEdge(0, 899) == true);
+  CHECK(graph.removeVertex(450) == true);
+  for (int j = 0; j < 60; j++) {
+    compare(j * 37 % 900, j * 211 % 900, {"a"});
+  }
+
+  // vertex that can not reach landmarks has no path, one way edge from it
+  graph.addVertex(1000, 0);
+  graph.addVertex(1001, 0);
+  graph.createEdge(1000, 0);
+  graph.createEdge(1001, 1000);
+  compare(1001, 5, {});
+  compare(5, 1000, {});
+  compare(5, 1001, {});
+
+  graph::GraphStoreLinked<int> degrees;
+  buildGrid(degrees, 20, 20);
+  degrees.buildLandmarks(3, graph::LandmarkSelection::Degree);
+  CHECK(degrees.landmarkCount() == 3);
+  CHECK(degrees.shortestPath(0, 399, {}, landmarks,
+                             graph::SearchMode::Landmarks) == true);
+  CHECK(landmarks.distance == 38);
+  graph::GraphStoreLinked<int> empty;
+  empty.buildLandmarks(4);
+  CHECK(empty.landmarkCount() == 0);
+}
+
+TEST_CASE("Graph Store save and open landmarks") {
+  std::string path =
+      (std::filesystem::temp_directory_path() / "graphStoreTest.alt").string();
+  graph::GraphStoreLinked<int> graph;
+  buildGrid(graph, 20, 20);
+  CHECK(graph.saveLandmarks(path) == false);
+  graph.buildLandmarks(6);
+  CHECK(graph.saveLandmarks(path) == true);
+
+  graph::GraphStoreLinked<int> copy;
+  buildGrid(copy, 20, 20);
+  CHECK(copy.openLandmarks(path) == true);
+  CHECK(copy.landmarkCount() == 6);
+  graph::PathResult forward;
+  graph::PathResult landmarks;
+  graph::QueryContext<int> context;
+  for (int j = 0; j < 40; j++) {
+    int start = j * 37 % 400;
+    int stop = j * 211 % 400;
+    bool found = graph.shortestPath(start, stop, {}, forward);
+    CHECK(copy.shortestPath(start, stop, {}, landmarks,
+                            graph::SearchMode::Landmarks) == found);
+    CHECK(landmarks.distance == forward.distance);
+  }
+  CHECK(copy.shortestPath(0, 399, {}, context, graph::SearchMode::Landmarks) ==
+        true);
+  CHECK(context.visited() < 200);
+
+  // landmarks of other graph are not read
+  graph::GraphStoreLinked<int> other;
+  buildGrid(other, 20, 20);
+  other.createEdge(0, 399);
+  CHECK(other.openLandmarks(path) == false);
+  CHECK(other.landmarkCount() == 0);
+  graph::GraphStoreLinked<int> smaller;
+  buildGrid(smaller, 10, 10);
+  CHECK(smaller.openLandmarks(path) == false);
+
+  // corrupted distances are rejected by checksum
+  {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(200);
+    file.put('x');
+  }
+  graph::GraphStoreLinked<int> corrupted;
+  buildGrid(corrupted, 20, 20);
+  CHECK(corrupted.openLandmarks(path) == false);
+  CHECK(corrupted.openLandmarks(path + ".missing") == false);
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("Graph Store landmark A* search - Benchmark") {
+  graph::GraphStoreLinked<int> graph;
+  buildGrid(graph, 300, 300);
+  std::vector<std::pair<int, int>> queries;
+  for (int i = 0; i < 10; ++i) {
+    queries.emplace_back(i * 8971 % 90000, 89999 - i * 7919 % 90000);
+  }
+
+  graph::QueryContext<int> context;
+  size_t dijkstraVisited = 0;
+  for (auto [start, stop] : queries) {
+    graph.shortestPath(start, stop, {}, context);
+    dijkstraVisited += context.visited();
+  }
+  BENCHMARK("Find 10 shortest paths in grid of 90.000 vertices with "
+            "Dijkstra search") {
+    for (auto [start, stop] : queries) {
+      graph.shortestPath(start, stop, {}, context);
+    }
+  };
+
+  auto begin = std::chrono::steady_clock::now();
+  graph.buildLandmarks(8);
+  auto build = std::chrono::steady_clock::now() - begin;
+  size_t landmarkVisited = 0;
+  for (auto [start, stop] : queries) {
+    graph.shortestPath(start, stop, {}, context, graph::SearchMode::Landmarks);
+    landmarkVisited += context.visited();
+  }
+  CHECK(landmarkVisited * 4 < dijkstraVisited);
+  WARN("10 searches visit " << dijkstraVisited << " vertices with Dijkstra "
+       << "search and " << landmarkVisited << " with landmark A* search, "
+       << "8 landmarks are built in "
+       << std::chrono::duration_cast<std::chrono::milliseconds>(build).count()
+       << " ms");
+  BENCHMARK("Find 10 shortest paths in grid of 90.000 vertices with "
+            "landmark A* search") {
+    for (auto [start, stop] : queries) {
+      graph.shortestPath(start, stop, {}, context,
+                         graph::SearchMode::Landmarks);
+    }
+  };
+
+  int round = 0;
+  BENCHMARK("Insert 100 edges in grid of 90.000 vertices with landmarks") {
+    ++round;
+    for (int i = 0; i < 100; ++i) {
+      graph.createEdge((i * 877 + round) % 90000, (i * 613 + round) % 90000);
+    }
+  };
+}
+
+TEST_CASE("Graph Store contraction hierarchy search") {
+  graph::GraphStoreLinked<int> graph;
+  buildGrid(graph, 30, 30);
+  std::vector<std::pair<int, int>> oneWay;
+  for (int j = 0; j < 100; j++) {
+    oneWay.emplace_back(j * 7 % 900, j * 13 % 900);
+  }
+  graph.addEdges(oneWay);
+  for (int j = 0; j < 900; j++) {
+    if (j % 30 != 15 || j / 30 == 29)
+      graph.addLabel(j, "a");
+  }
+  graph::PathResult forward;
+  graph::PathResult hierarchy;
+  graph::PathResult edge;
+  graph::QueryContext<int> context;
+  auto compare = [&](int start, int stop,
+                     const std::vector<std::string> &label) {
+    bool found = graph.shortestPath(start, stop, label, forward);
+    CHECK(graph.shortestPath(start, stop, label, hierarchy,
+                             graph::SearchMode::ContractionHierarchy) == found);
+    CHECK(hierarchy.distance == forward.distance);
+    if (found) {
+      CHECK(hierarchy.path.front() == start);
+      CHECK(hierarchy.path.back() == stop);
+      // shortcuts are unpacked to edges of graph
+      for (size_t i = 0; i + 1 < hierarchy.path.size(); i++) {
+        CHECK(graph.shortestPath(hierarchy.path[i], hierarchy.path[i + 1], {},
+                                 edge) == true);
+        CHECK(edge.distance == 1);
+      }
+    }
+  };
+
+  // without hierarchy search runs as Forward search
+  CHECK(graph.shortcutCount() == 0);
+  compare(0, 899, {});
+  graph.buildContractionHierarchy();
+  CHECK(graph.shortcutCount() > 0);
+  for (int j = 0; j < 100; j++) {
+    compare(j * 37 % 900, j * 211 % 900, {});
+  }
+  compare(5, 5, {});
+
+  // hierarchy search visits fewer vertices than Dijkstra search
+  CHECK(graph.shortestPath(0, 899, {}, context) == true);
+  size_t visited = context.visited();
+  CHECK(graph.shortestPath(0, 899, {}, context,
+                           graph::SearchMode::ContractionHierarchy) == true);
+  CHECK(context.visited() < visited / 2);
+
+  // label constrained searches fall back to search over graph
+  for (int j = 0; j < 30; j++) {
+    compare(j * 37 % 900, j * 211 % 900, {"a"});
+  }
+
+  // after edges change, searches fall back until hierarchy is built again
+  CHECK(graph.createEdge(0, 899) == true);
+  compare(0, 899, {});
+  CHECK(hierarchy.distance == 1);
+  CHECK(graph.removeVertex(450) == true);
+  compare(420, 480, {});
+  graph.buildContractionHierarchy();
+  for (int j = 0; j < 60; j++) {
+    compare(j * 37 % 900, j * 211 % 900, {});
+  }
+  CHECK(graph.shortestPath(0, 899, {}, context,
+                           graph::SearchMode::ContractionHierarchy) == true);
+  CHECK(context.path().size() == 1);
+
+  // vertex without path to other vertex
+  graph.addVertex(1000, 0);
+  graph.createEdge(1000, 0);
+  compare(1000, 5, {});
+  compare(5, 1000, {});
+  graph.buildContractionHierarchy();
+  compare(1000, 5, {});
+  compare(5, 1000, {});
+
+  graph::GraphStoreLinked<int> empty;
+  empty.buildContractionHierarchy();
+  CHECK(empty.shortcutCount() == 0);
+}
+
+TEST_CASE("Graph Store contraction hierarchy search - Benchmark") {
+  graph::GraphStoreLinked<int> graph;
+  buildGrid(graph, 200, 200);
+  std::vector<std::pair<int, int>> queries;
+  for (int i = 0; i < 10; ++i) {
+    queries.emplace_back(i * 8971 % 40000, 39999 - i * 7919 % 40000);
+  }
+
+  graph::QueryContext<int> context;
+  size_t dijkstraVisited = 0;
+  for (auto [start, stop] : queries) {
+    graph.shortestPath(start, stop, {}, context);
+    dijkstraVisited += context.visited();
+  }
+
+  auto begin = std::chrono::steady_clock::now();
+  graph.buildContractionHierarchy();
+  auto build = std::chrono::steady_clock::now() - begin;
+  size_t hierarchyVisited = 0;
+  graph::PathResult forward;
+  graph::PathResult hierarchy;
+  for (auto [start, stop] : queries) {
+    graph.shortestPath(start, stop, {}, context,
+                       graph::SearchMode::ContractionHierarchy);
+    hierarchyVisited += context.visited();
+    graph.shortestPath(start, stop, {}, forward);
+    graph.shortestPath(start, stop, {}, hierarchy,
+                       graph::SearchMode::ContractionHierarchy);
+    CHECK(hierarchy.distance == forward.distance);
+  }
+  CHECK(hierarchyVisited * 10 < dijkstraVisited);
+  WARN("10 searches visit " << dijkstraVisited << " vertices with Dijkstra "
+       << "search and " << hierarchyVisited << " with contraction hierarchy "
+       << "search, hierarchy with " << graph.shortcutCount()
+       << " shortcuts is built in "
+       << std::chrono::duration_cast<std::chrono::milliseconds>(build).count()
+       << " ms");
+  BENCHMARK("Find 10 shortest paths in grid of 40.000 vertices with "
+            "Dijkstra search") {
+    for (auto [start, stop] : queries) {
+      graph.shortestPath(start, stop, {}, context);
+    }
+  };
+  BENCHMARK("Find 10 shortest paths in grid of 40.000 vertices with "
+            "contraction hierarchy search") {
+    for (auto [start, stop] : queries) {
+      graph.shortestPath(start, stop, {}, context,
+                         graph::SearchMode::ContractionHierarchy);
+    }
+  };
+}
+
+TEST_CASE("Graph Store shortest path tree") {
+  graph::GraphStoreLinked<int> graph;
+  std::vector<std::pair<int, int>> vertices;
+  std::vector<std::pair<int, int>> edges;
+  for (int j = 0; j < 2000; j++) {
+    vertices.emplace_back(j * 3 - 1000, j);
+  }
+  for (int j = 0; j < 5000; j++) {
+    edges.emplace_back(j * 7919 % 2000 * 3 - 1000,
+                       (j % 2000 * 4729 + j / 2000) % 2000 * 3 - 1000);
+  }
+  graph.addVertices(vertices);
+  graph.addEdges(edges);
+  for (int j = 0; j < 2000; j++) {
+    if (j % 4 != 0)
+      graph.addLabel(j * 3 - 1000, "a");
+  }
+
+  // tree gives the same distances and paths as single searches, to all
+  // vertices
+  graph::QueryContext<int> context;
+  graph::ShortestPathTree tree;
+  std::vector<int> path;
+  for (const auto &label :
+       {std::vector<std::string>{}, std::vector<std::string>{"a"}}) {
+    for (int start : {-1000, 2, 4997}) {
+      REQUIRE(graph.shortestPathTree(start, label, tree));
+      CHECK(tree.start() == start);
+      CHECK(tree.distance(start) == 0);
+      size_t reached = 1;
+      bool same = true;
+      for (const auto &[stop, info] : vertices) {
+        if (stop == start)
+          continue;
+        bool expected = graph.shortestPath(start, stop, label, context);
+        std::vector<int> expectedPath(context.path().begin(),
+                                      context.path().end());
+        if (expected)
+          expectedPath.push_back(stop);
+        bool found = tree.path(stop, path);
+        if (found != expected || path != expectedPath ||
+            tree.contains(stop) != expected ||
+            (expected &&
+             tree.distance(stop) != static_cast<int>(path.size()) - 1))
+          same = false;
+        reached += expected ? 1 : 0;
+      }
+      CHECK(same);
+      CHECK(tree.size() == reached);
+      CHECK(reached > 100);
+    }
+  }
+
+  graph::ShortestPathTree labelTree = graph.shortestPathTree(-1000, {"c"});
+  CHECK(labelTree.size() == 1);
+  CHECK(labelTree.distance(2) == graph::ShortestPathTree::infinity);
+  CHECK_FALSE(labelTree.path(2, path));
+  CHECK(path.empty());
+
+  CHECK_FALSE(graph.shortestPathTree(1, {}, tree));
+  CHECK(tree.empty());
+}
+
+TEST_CASE("Graph Store shortest path tree - Benchmark") {
+  graph::GraphStoreLinked<int> graph;
+  std::vector<std::pair<int, int>> vertices;
+  std::vector<std::pair<int, int>> edges;
+  for (int j = 0; j < 10000; j++) {
+    vertices.emplace_back(j, j);
+  }
+  for (int j = 0; j < 30000; j++) {
+    edges.emplace_back(j % 10000,
+                       (j % 10000 * 4729 + j / 10000 * 31 + 13) % 10000);
+  }
+  graph.addVertices(vertices);
+  graph.addEdges(edges);
+
+  std::vector<int> stops;
+  for (int j = 0; j < 100; j++) {
+    stops.push_back(j * 97 % 10000);
+  }
+
+  BENCHMARK("Find shortest paths from one vertex to 100 vertices") {
+    for (int stop : stops) {
+      graph.shortestPath(1, stop);
+    }
+  };
+
+  graph::ShortestPathTree tree;
+  std::vector<int> path;
+  BENCHMARK("Find shortest paths from one vertex to 100 vertices with "
+            "shortest path tree") {
+    graph.shortestPathTree(1, {}, tree);
+    for (int stop : stops) {
+      tree.path(stop, path);
+    }
+  };
+}
+
+TEST_CASE("Graph Store labels beyond 64 distinct labels") {
+  graph::GraphStoreLinked<int> graph;
+  for (int j = 0; j < 4; j++) {
+    graph.addVertex(j, j);
+  }
+  CHECK(graph.createEdge(0, 1) == true);
+  CHECK(graph.createEdge(1, 2) == true);
+  CHECK(graph.createEdge(2, 3) == true);
+
+  // first 64 labels are stored as bits, the rest in overflow of vertex
+  for (int l = 0; l < 70; l++) {
+    CHECK(graph.addLabel(1 + l % 3, "label" + std::to_string(l)) == true);
+  }
+  CHECK(graph.addLabel(1, "x", "label68") == true);
+  CHECK(graph.addLabel(2, "x", "label68") == true);
+  CHECK(graph.addLabel(3, "x", "label68") == true);
+
+  CHECK(graph.shortestPath(0, 3, "x") == true);
+  CHECK(graph.shortestPath(0, 3, "label68") == true);
+  CHECK(graph.shortestPath(0, 3, "label68", "x") == true);
+  CHECK(graph.shortestPath(0, 3, "label69") == false);
+  CHECK(graph.shortestPath(0, 1, "label69") == true);
+  CHECK(graph.shortestPath(0, 3, "unknown") == false);
+
+  CHECK(graph.removeLabel(2, "label68") == true);
+  CHECK(graph.removeLabel(2, "label68") == false);
+  CHECK(graph.removeLabel(2, "unknown") == false);
+  CHECK(graph.shortestPath(0, 3, "label68") == false);
+
+  graph.freeze();
+  CHECK(graph.shortestPath(0, 3, "x") == true);
+  CHECK(graph.shortestPath(0, 3, "label68") == false);
+  CHECK(graph.addLabel(2, "label68") == true);
+  CHECK(graph.shortestPath(0, 3, "label68") == true);
+  CHECK(graph.shortestPath(0, 3, graph::SearchMode::Bidirectional, "label68",
+                           "x") == true);
+}
+
+TEST_CASE("Graph Store find vertices with label") {
+  graph::GraphStoreLinked<int> graph;
+  for (int j = -5; j < 10000; j++) {
+    graph.addVertex(j, j);
+  }
+
+  // label "a" has more than 4096 vertices in the same container, so its set is
+  // stored as bitmap, "b" and "c" are stored as arrays
+  for (int j = -5; j < 10000; j++) {
+    if (j % 2 == 0)
+      graph.addLabel(j, "a");
+    if (j % 3 == 0)
+      graph.addLabel(j, "b");
+    if (j % 1000 == 0)
+      graph.addLabel(j, "c");
+  }
+
+  CHECK(graph.findVerticesWithLabel("a").size() == 5002);
+  CHECK(graph.findVerticesWithLabel("b").size() == 3335);
+  CHECK(graph.findVerticesWithLabel("a", "b").size() == 1667);
+  CHECK(graph.findVerticesWithLabel("a", "b", "c") ==
+        std::vector<int>{0, 3000, 6000, 9000});
+  CHECK(graph.findVerticesWithLabel("c", "unknown").empty());
+  CHECK(graph.findVerticesWithLabel(std::vector<std::string>{}).size() ==
+        10005);
+
+  std::vector<int> ab = graph.findVerticesWithLabel("b", "a");
+  CHECK(ab.front() == 0);
+  CHECK(ab.back() == 9996);
+  CHECK(graph.findVerticesWithLabel("a").front() == -4);
+
+  // removed labels are removed from index, bitmap set is converted back to
+  // array when it gets small
+  for (int j = 0; j < 6000; j += 2) {
+    CHECK(graph.removeLabel(j, "a") == true);
+  }
+  CHECK(graph.findVerticesWithLabel("a").size() == 2002);
+  CHECK(graph.findVerticesWithLabel("a", "c") ==
+        std::vector<int>{6000, 7000, 8000, 9000});
+  CHECK(graph.addLabel(3000, "a") == true);
+  CHECK(graph.findVerticesWithLabel("c", "b", "a") ==
+        std::vector<int>{3000, 6000, 9000});
+}
+
+TEST_CASE("Graph Store vertices with sparse and negative keys") {
+  graph::GraphStoreLinked<int> graph;
+  // keys are inserted out of order and spread over whole int range, they are
+  // mapped to dense indices in order of insertion
+  std::vector<int> keys = {1000000, -7, 42, std::numeric_limits<int>::min(),
+                           std::numeric_limits<int>::max(), 0, -1000000};
+  for (auto key : keys) {
+    CHECK(graph.addVertex(key, key) == true);
+  }
+  for (auto key : keys) {
+    CHECK(graph.addVertex(key, key) == false);
+  }
+  for (size_t j = 0; j + 1 < keys.size(); j++) {
+    CHECK(graph.createEdge(keys[j], keys[j + 1]) == true);
+    CHECK(graph.addLabel(keys[j + 1], "a") == true);
+  }
+  CHECK(graph.createEdge(1000000, 1) == false);
+
+  CHECK(graph.findVerticesWithLabel("a") ==
+        std::vector<int>{std::numeric_limits<int>::min(), -1000000, -7, 0, 42,
+                         std::numeric_limits<int>::max()});
+  CHECK(graph.shortestPath(1000000, -1000000, "a") == true);
+  CHECK(graph.shortestPath(-1000000, 1000000, "a") == false);
+  CHECK(graph.shortestPath(1000000, -1000000, graph::SearchMode::Bidirectional,
+                           "a") == true);
+  graph.freeze();
+  CHECK(graph.shortestPath(1000000, -1000000, "a") == true);
+  CHECK(graph.snapshot().vertexCount() == keys.size());
+}
+
+/**
+ * Builds the same graph in GraphStore and GraphStoreLinked, vertices with
+ * keys not divisible by 5 have label "a", or label id 3, and checks that
+ * distances of shortest paths are equal
+ */
+template <typename Storage, typename Labels, typename Id>
+static void checkGraphStorePolicies() {
+  graph::GraphStore<int, Storage, Labels, Id> store;
+  graph::GraphStoreLinked<int> linked;
+  const int vertices = 2000;
+  for (int j = 0; j < vertices; j++) {
+    CHECK(store.addVertex(Id(j) * 3, j) == true);
+    linked.addVertex(j, j);
+    if (j % 5 != 0) {
+      linked.addLabel(j, "a");
+      if constexpr (std::is_same_v<Labels, graph::StringLabels>)
+        CHECK(store.addLabel(Id(j) * 3, "a") == true);
+      else if constexpr (std::is_same_v<Labels, graph::BitmaskLabels>)
+        CHECK(store.addLabel(Id(j) * 3, 3) == true);
+    }
+  }
+  CHECK(store.addVertex(0, 0) == false);
+  uint32_t random = 12345;
+  for (int j = 0; j < vertices * 3; j++) {
+    random = random * 1103515245 + 12345;
+    int start = static_cast<int>((random >> 8) % vertices);
+    random = random * 1103515245 + 12345;
+    int stop = static_cast<int>((random >> 8) % vertices);
+    CHECK(store.createEdge(Id(start) * 3, Id(stop) * 3) == true);
+    linked.createEdge(start, stop);
+  }
+  CHECK(store.createEdge(0, 1) == false);
+  CHECK(store.vertexCount() == size_t(vertices));
+  CHECK(store.edgeCount() == size_t(vertices * 3));
+  CHECK(*store.vertexInfo(Id(7) * 3) == 7);
+  CHECK(store.vertexInfo(1) == nullptr);
+
+  std::vector<Id> path;
+  graph::PathResult result;
+  for (int j = 0; j < 50; j++) {
+    int start = j * 37 % vertices;
+    int stop = (j * 211 + 1) % vertices;
+    bool found = linked.shortestPath(start, stop, {}, result);
+    CHECK(store.shortestPath(Id(start) * 3, Id(stop) * 3, path) == found);
+    if (found) {
+      CHECK(path.size() == size_t(result.distance) + 1);
+      CHECK(path.front() == Id(start) * 3);
+      CHECK(path.back() == Id(stop) * 3);
+    }
+    if constexpr (Labels::enabled) {
+      found = linked.shortestPath(start, stop, {"a"}, result);
+      typename Labels::Label label{};
+      if constexpr (std::is_same_v<Labels, graph::StringLabels>)
+        label = "a";
+      else
+        label = 3;
+      CHECK(store.shortestPath(Id(start) * 3, Id(stop) * 3, {label}, path) ==
+            found);
+      if (found)
+        CHECK(path.size() == size_t(result.distance) + 1);
+      if constexpr (std::is_same_v<Labels, graph::BitmaskLabels>) {
+        CHECK(store.shortestPath(Id(start) * 3, Id(stop) * 3,
+                                 graph::StaticLabelMask<uint64_t(1) << 3>(),
+                                 path) == found);
+        if (found)
+          CHECK(path.size() == size_t(result.distance) + 1);
+      }
+    }
+  }
+
+  // new edges after search are merged into prepared storage
+  CHECK(store.createEdge(Id(vertices - 1) * 3, Id(vertices - 2) * 3) == true);
+  CHECK(store.shortestPath(Id(vertices - 1) * 3, Id(vertices - 2) * 3, path) ==
+        true);
+  CHECK(path.size() == 2);
+  CHECK(store.shortestPath(0, 0, path) == false);
+  CHECK(store.shortestPath(0, 1, path) == false);
+  CHECK(path.empty());
+}
+
+TEST_CASE("Graph Store policies of GraphStore") {
+  checkGraphStorePolicies<graph::LinkedStorage, graph::NoLabels, int>();
+  checkGraphStorePolicies<graph::LinkedStorage, graph::StringLabels, int>();
+  checkGraphStorePolicies<graph::CsrStorage, graph::BitmaskLabels, int>();
+  checkGraphStorePolicies<graph::CsrStorage, graph::StringLabels, int64_t>();
+  checkGraphStorePolicies<graph::CompressedStorage, graph::NoLabels,
+                          int64_t>();
+  checkGraphStorePolicies<graph::CompressedStorage, graph::BitmaskLabels,
+                          int>();
+
+  graph::GraphStore<int, graph::CsrStorage, graph::BitmaskLabels, int64_t>
+      store;
+  const int64_t base = int64_t(1) << 40;
+  for (int64_t j = 0; j < 4; j++) {
+    CHECK(store.addVertex(base + j, int(j)) == true);
+    CHECK(store.addLabel(base + j, 1) == true);
+  }
+  CHECK(store.addLabel(base, 64) == false);
+  CHECK(store.addLabel(base + 4, 1) == false);
+  store.createEdge(base, base + 1);
+  store.createEdge(base + 1, base + 2);
+  store.createEdge(base + 2, base + 3);
+  store.createEdge(base, base + 2);
+  std::vector<int64_t> path;
+  CHECK(store.shortestPath(base, base + 3, path) == true);
+  CHECK(path == std::vector<int64_t>{base, base + 2, base + 3});
+  CHECK(store.removeLabel(base + 2, 1) == true);
+  CHECK(store.removeLabel(base + 2, 1) == false);
+  CHECK(store.hasLabel(base + 2, 1) == false);
+  CHECK(store.shortestPath(base, base + 3, {1}, path) == false);
+  CHECK(store.shortestPath(base, base + 3, {64}, path) == false);
+  CHECK(store.shortestPath(base, base + 3, graph::StaticLabelMask<2>(), path) ==
+        false);
+  CHECK(store.shortestPath(base, base + 1, graph::StaticLabelMask<2>(), path) ==
+        true);
+
+  graph::GraphStore<int, graph::CompressedStorage, graph::NoLabels> compressed;
+  for (int j = 0; j < 1000; j++) {
+    compressed.addVertex(j, j);
+  }
+  for (int j = 0; j + 1 < 1000; j++) {
+    compressed.createEdge(j, j + 1);
+    compressed.createEdge(j + 1, j);
+  }
+  // edges between vertices with near keys take one byte each
+  CHECK(compressed.edges().encodedBytes() == compressed.edgeCount());
+  std::vector<int> keys;
+  CHECK(compressed.shortestPath(999, 0, keys) == true);
+  CHECK(keys.size() == 1000);
+  CHECK(keys[500] == 499);
+}
+
+TEST_CASE("Graph Store policies of GraphStore - Benchmark") {
+  graph::GraphStore<int, graph::CsrStorage, graph::NoLabels> plain;
+  graph::GraphStore<int, graph::CsrStorage, graph::BitmaskLabels> bitmask;
+  graph::GraphStore<int, graph::LinkedStorage, graph::StringLabels> strings;
+  graph::GraphStore<int, graph::CompressedStorage, graph::NoLabels> compressed;
+  graph::GraphStoreLinked<int> linked;
+  const int vertices = 100000;
+  for (int j = 0; j < vertices; j++) {
+    plain.addVertex(j, j);
+    bitmask.addVertex(j, j);
+    bitmask.addLabel(j, 0);
+    strings.addVertex(j, j);
+    strings.addLabel(j, "a");
+    compressed.addVertex(j, j);
+    linked.addVertex(j, j);
+    linked.addLabel(j, "a");
+  }
+  for (int j = 0; j < vertices; j++) {
+    for (int stop : {j + 1, (j * 7 + 1) % vertices, (j * 13 + 5) % vertices}) {
+      stop %= vertices;
+      plain.createEdge(j, stop);
+      bitmask.createEdge(j, stop);
+      strings.createEdge(j, stop);
+      compressed.createEdge(j, stop);
+      linked.createEdge(j, stop);
+    }
+  }
+  linked.freeze();
+  std::vector<int> path;
+  // storage is prepared before benchmarks
+  plain.shortestPath(0, 1, path);
+  bitmask.shortestPath(0, 1, path);
+  compressed.shortestPath(0, 1, path);
+  linked.shortestPath(0, 1, "a");
+
+  BENCHMARK("Find 10 shortest paths in GraphStore of 100.000 vertices with "
+            "CSR and no labels") {
+    for (int i = 0; i < 10; ++i) {
+      plain.shortestPath(i * 9973, 99999 - i * 13, path);
+    }
+  };
+
+  BENCHMARK("Find 10 shortest paths in GraphStore of 100.000 vertices with "
+            "CSR and static label mask") {
+    for (int i = 0; i < 10; ++i) {
+      bitmask.shortestPath(i * 9973, 99999 - i * 13,
+                           graph::StaticLabelMask<1>(), path);
+    }
+  };
+
+  BENCHMARK("Find 10 shortest paths in GraphStore of 100.000 vertices with "
+            "CSR and bitmask labels") {
+    for (int i = 0; i < 10; ++i) {
+      bitmask.shortestPath(i * 9973, 99999 - i * 13, {0}, path);
+    }
+  };
+
+  BENCHMARK("Find 10 shortest paths in GraphStore of 100.000 vertices with "
+            "compressed edges and no labels") {
+    for (int i = 0; i < 10; ++i) {
+      compressed.shortestPath(i * 9973, 99999 - i * 13, path);
+    }
+  };
+
+  BENCHMARK("Find 10 shortest paths in GraphStore of 100.000 vertices with "
+            "linked edges and string labels") {
+    for (int i = 0; i < 10; ++i) {
+      strings.shortestPath(i * 9973, 99999 - i * 13, {"a"}, path);
+    }
+  };
+
+  BENCHMARK("Find 10 shortest paths in frozen GraphStoreLinked of 100.000 "
+            "vertices") {
+    for (int i = 0; i < 10; ++i) {
+      linked.shortestPath(i * 9973, 99999 - i * 13, "a");
+    }
+  };
 }